@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -22,6 +23,19 @@ using namespace lime;
 
 #define dirName ((direction == SOAPY_SDR_RX) ? "Rx" : "Tx")
 
+static std::mutex asyncLoggingMutex;
+static int asyncLoggingUsers = 0;
+
+/// @brief Enables the asynchronous logging while any device is open, so the streaming threads do not wait for the SoapySDR log.
+/// @param use Whether a device starts or stops using it.
+static void UseAsyncLogging(bool use)
+{
+    std::lock_guard<std::mutex> lock(asyncLoggingMutex);
+    asyncLoggingUsers += use ? 1 : -1;
+    if (asyncLoggingUsers == (use ? 1 : 0))
+        enableAsyncLogging(use);
+}
+
 /*******************************************************************
  * Constructor/destructor
  ******************************************************************/
@@ -85,6 +99,7 @@ SoapyLMS7::SoapyLMS7(const DeviceHandle& handle, const SoapySDR::Kwargs& args)
     settingsCache.at(SOAPY_SDR_RX).resize(channelCount);
     settingsCache.at(SOAPY_SDR_TX).resize(channelCount);
     activeStreams.clear();
+    UseAsyncLogging(true);
 }
 
 SoapyLMS7::~SoapyLMS7(void)
@@ -97,6 +112,7 @@ SoapyLMS7::~SoapyLMS7(void)
     }
 
     DeviceRegistry::freeDevice(sdrDevice);
+    UseAsyncLogging(false);
 }
 
 /*******************************************************************
@@ -337,7 +337,7 @@ int SoapyLMS7::readStream(
         numElems = std::min(numElems, icstream->elemMTU);
     }
 
-    SDRDevice::StreamMeta metadata;
+    SDRDevice::StreamMeta metadata{};
     const uint64_t cmdTicks =
         ((icstream->flags & SOAPY_SDR_HAS_TIME) != 0) ? SoapySDR::timeNsToTicks(icstream->timeNs, sampleRate[SOAPY_SDR_RX]) : 0;
 
@@ -449,6 +449,7 @@ int SoapyLMS7::writeStream(SoapySDR::Stream* stream,
     metadata.timestamp = SoapySDR::timeNsToTicks(timeNs, sampleRate[SOAPY_SDR_RX]);
     metadata.waitForTimestamp = (flags & SOAPY_SDR_HAS_TIME);
     metadata.flushPartialPacket = (flags & SOAPY_SDR_END_BURST);
+    metadata.endOfBurst = (flags & SOAPY_SDR_END_BURST);
 
     int status = 0;
     switch (icstream->streamConfig.format)
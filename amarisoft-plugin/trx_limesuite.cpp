@@ -133,6 +133,7 @@ static void trx_lms7002m_write(
     meta.timestamp = timestamp;
     meta.waitForTimestamp = true;
     meta.flushPartialPacket = (md->flags & TRX_WRITE_MD_FLAG_END_OF_BURST);
+    meta.endOfBurst = (md->flags & TRX_WRITE_MD_FLAG_END_OF_BURST);
 
     // samples format conversion is done internally
     LimePluginContext* lime = static_cast<LimePluginContext*>(s->opaque);
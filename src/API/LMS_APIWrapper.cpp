@@ -949,7 +949,7 @@ int ReceiveStream(lms_stream_t* stream, void* samples, size_t sample_count, lms_
         }
     }
 
-    lime::SDRDevice::StreamMeta metadata{ 0, false, false };
+    lime::SDRDevice::StreamMeta metadata{ 0, false, false, false };
     int samplesProduced =
         handle->parent->device->StreamRx(handle->parent->moduleIndex, sampleBuffer.data(), sample_count, &metadata);
 
@@ -1057,7 +1057,7 @@ int SendStream(lms_stream_t* stream, const void* samples, size_t sample_count, c
         return sample_count;
     }
 
-    lime::SDRDevice::StreamMeta metadata{ 0, false, false };
+    lime::SDRDevice::StreamMeta metadata{ 0, false, false, false };
 
     if (meta != nullptr)
     {
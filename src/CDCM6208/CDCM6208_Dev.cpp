@@ -4,9 +4,17 @@
 #include <chrono>
 #include <math.h>
 #include <thread>
+#include <tuple>
 
 using namespace lime;
 
+static constexpr std::size_t maxCachedVCOPlans = 64;
+
+static constexpr uint32_t WriteCommand(uint16_t addr, uint16_t val)
+{
+    return (1u << 31) | (addr << 16) | val;
+}
+
 CDCM_Dev::CDCM_Dev(std::shared_ptr<ISPI> comms, uint16_t SPI_BASE_ADDR)
     : comms(comms)
     , SPI_BASE_ADDR(SPI_BASE_ADDR)
@@ -82,6 +90,7 @@ int CDCM_Dev::Reset(double primaryFreq, double secondaryFreq)
         { 23, { static_cast<uint16_t>(SPI_BASE_ADDR + 23), 0x010A } },
     };
 
+    uploaded_regs.clear();
     for (auto reg : CDCM_Regs)
         if (WriteRegister(reg.second.addr, reg.second.val) != 0)
             return -1;
@@ -187,90 +196,24 @@ void CDCM_Dev::SetOutputs(CDCM_Outputs Outputs)
 */
 int CDCM_Dev::SetFrequency(cdcm_output_t output, double frequency, bool upload)
 {
-    int return_val = -1;
-    switch (output)
-    {
-    case CDCM_Y0Y1:
-        Outputs.Y0Y1.requested_freq = frequency;
-        Outputs.Y0Y1.used = true;
-        break;
-    case CDCM_Y2Y3:
-        Outputs.Y2Y3.requested_freq = frequency;
-        Outputs.Y2Y3.used = true;
-        break;
-    case CDCM_Y4:
-        Outputs.Y4.requested_freq = frequency;
-        Outputs.Y4.used = true;
-        break;
-    case CDCM_Y5:
-        Outputs.Y5.requested_freq = frequency;
-        Outputs.Y5.used = true;
-        break;
-    case CDCM_Y6:
-        Outputs.Y6.requested_freq = frequency;
-        Outputs.Y6.used = true;
-        break;
-    case CDCM_Y7:
-        Outputs.Y7.requested_freq = frequency;
-        Outputs.Y7.used = true;
-        break;
-    default:
-        break;
-    }
-
-    CDCM_VCO VCOConfig = FindVCOConfig();
-    if (VCOConfig.valid)
+    CDCM_Output* changed = GetOutput(output);
+    if (changed)
     {
-        if (VCOConfig.output_freq > 0)
-        {
-            VCO = VCOConfig;
-            SolveN(VCO.N_mul_full, &VCO.N_mul_8bit, &VCO.N_mul_10bit);
-
-            VCO.output_freq = GetInputFreq();
-            VCO.output_freq /= VCO.M_div;
-            VCO.output_freq *= VCO.prescaler_A;
-            VCO.output_freq *= VCO.N_mul_full;
-        }
-        return_val = 0;
+        changed->requested_freq = frequency;
+        changed->used = true;
     }
 
-    if (Outputs.Y0Y1.used)
-        Outputs.Y0Y1.divider_val = std::round((VCO.output_freq / VCO.prescaler_A) / Outputs.Y0Y1.requested_freq);
-    else
-        Outputs.Y0Y1.divider_val = std::round((VCO.output_freq / VCO.prescaler_A) / Outputs.Y0Y1.output_freq);
-
-    if (Outputs.Y2Y3.used)
-        Outputs.Y2Y3.divider_val = std::round((VCO.output_freq / VCO.prescaler_A) / Outputs.Y2Y3.requested_freq);
-    else
-        Outputs.Y2Y3.divider_val = std::round((VCO.output_freq / VCO.prescaler_A) / Outputs.Y2Y3.output_freq);
-
-    if (Outputs.Y4.used)
-        Outputs.Y4.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y4.requested_freq;
-    else
-        Outputs.Y4.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y4.output_freq;
-
-    SolveFracDiv(Outputs.Y4.divider_val, &Outputs.Y4);
-
-    if (Outputs.Y5.used)
-        Outputs.Y5.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y5.requested_freq;
-    else
-        Outputs.Y5.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y5.output_freq;
-
-    SolveFracDiv(Outputs.Y5.divider_val, &Outputs.Y5);
-
-    if (Outputs.Y6.used)
-        Outputs.Y6.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y6.requested_freq;
-    else
-        Outputs.Y6.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y6.output_freq;
-
-    SolveFracDiv(Outputs.Y6.divider_val, &Outputs.Y6);
+    bool vcoChanged = true;
+    int return_val = ApplyVCOConfig(&vcoChanged);
 
-    if (Outputs.Y7.used)
-        Outputs.Y7.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y7.requested_freq;
+    // While the VCO is kept, the dividers of the other outputs do not need to be solved again
+    if (changed && !vcoChanged)
+        SolveOutputDivider(output);
     else
-        Outputs.Y7.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y7.output_freq;
-
-    SolveFracDiv(Outputs.Y7.divider_val, &Outputs.Y7);
+    {
+        for (int i = CDCM_Y0Y1; i <= CDCM_Y7; ++i)
+            SolveOutputDivider(static_cast<cdcm_output_t>(i));
+    }
 
     UpdateOutputFrequencies();
 
@@ -287,64 +230,94 @@ int CDCM_Dev::SetFrequency(cdcm_output_t output, double frequency, bool upload)
 */
 int CDCM_Dev::RecalculateFrequencies()
 {
-    int return_val = -1;
-    CDCM_VCO VCOConfig = FindVCOConfig();
-    if (VCOConfig.valid)
-    {
-        if (VCOConfig.output_freq > 0)
-        {
-            VCO = VCOConfig;
-            SolveN(VCO.N_mul_full, &VCO.N_mul_8bit, &VCO.N_mul_10bit);
+    bool vcoChanged = true;
+    int return_val = ApplyVCOConfig(&vcoChanged);
 
-            VCO.output_freq = GetInputFreq();
-            VCO.output_freq /= VCO.M_div;
-            VCO.output_freq *= VCO.prescaler_A;
-            VCO.output_freq *= VCO.N_mul_full;
-        }
-        return_val = 0;
-    }
-
-    if (Outputs.Y0Y1.used)
-        Outputs.Y0Y1.divider_val = std::round((VCO.output_freq / VCO.prescaler_A) / Outputs.Y0Y1.requested_freq);
-    else
-        Outputs.Y0Y1.divider_val = std::round((VCO.output_freq / VCO.prescaler_A) / Outputs.Y0Y1.output_freq);
+    for (int i = CDCM_Y0Y1; i <= CDCM_Y7; ++i)
+        SolveOutputDivider(static_cast<cdcm_output_t>(i));
 
-    if (Outputs.Y2Y3.used)
-        Outputs.Y2Y3.divider_val = std::round((VCO.output_freq / VCO.prescaler_A) / Outputs.Y2Y3.requested_freq);
-    else
-        Outputs.Y2Y3.divider_val = std::round((VCO.output_freq / VCO.prescaler_A) / Outputs.Y2Y3.output_freq);
+    UpdateOutputFrequencies();
 
-    if (Outputs.Y4.used)
-        Outputs.Y4.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y4.requested_freq;
-    else
-        Outputs.Y4.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y4.output_freq;
+    return return_val;
+}
 
-    SolveFracDiv(Outputs.Y4.divider_val, &Outputs.Y4);
+/**
+    @brief Applies the VCO configuration planned for the requested outputs.
+    @param[out] vcoChanged Whether the VCO settings were changed.
+    @return 0 on success; -1 if no valid configuration was found.
+*/
+int CDCM_Dev::ApplyVCOConfig(bool* vcoChanged)
+{
+    *vcoChanged = false;
+    CDCM_VCO VCOConfig = FindVCOConfig();
+    if (!VCOConfig.valid)
+        return -1;
 
-    if (Outputs.Y5.used)
-        Outputs.Y5.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y5.requested_freq;
-    else
-        Outputs.Y5.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y5.output_freq;
+    if (VCOConfig.output_freq > 0)
+    {
+        const CDCM_VCO previous = VCO;
+        VCO = VCOConfig;
+        SolveN(VCO.N_mul_full, &VCO.N_mul_8bit, &VCO.N_mul_10bit);
+
+        VCO.output_freq = GetInputFreq();
+        VCO.output_freq /= VCO.M_div;
+        VCO.output_freq *= VCO.prescaler_A;
+        VCO.output_freq *= VCO.N_mul_full;
+
+        *vcoChanged = VCO.output_freq != previous.output_freq || VCO.R_div != previous.R_div || VCO.M_div != previous.M_div ||
+                      VCO.N_mul_full != previous.N_mul_full || VCO.prescaler_A != previous.prescaler_A ||
+                      VCO.prescaler_B != previous.prescaler_B || VCO.input_mux != previous.input_mux;
+    }
+    return 0;
+}
 
-    SolveFracDiv(Outputs.Y5.divider_val, &Outputs.Y5);
+/**
+    @brief Gets the settings of a CDCM output.
+    @param output CDCM output to get the settings of.
+    @return The output settings; nullptr on invalid output.
+*/
+CDCM_Output* CDCM_Dev::GetOutput(cdcm_output_t output)
+{
+    switch (output)
+    {
+    case CDCM_Y0Y1:
+        return &Outputs.Y0Y1;
+    case CDCM_Y2Y3:
+        return &Outputs.Y2Y3;
+    case CDCM_Y4:
+        return &Outputs.Y4;
+    case CDCM_Y5:
+        return &Outputs.Y5;
+    case CDCM_Y6:
+        return &Outputs.Y6;
+    case CDCM_Y7:
+        return &Outputs.Y7;
+    default:
+        return nullptr;
+    }
+}
 
-    if (Outputs.Y6.used)
-        Outputs.Y6.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y6.requested_freq;
-    else
-        Outputs.Y6.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y6.output_freq;
+/**
+    @brief Solves the divider of an output for the current VCO frequency.
+    @param output CDCM output to solve the divider for.
+*/
+void CDCM_Dev::SolveOutputDivider(cdcm_output_t output)
+{
+    CDCM_Output* Output = GetOutput(output);
+    if (!Output)
+        return;
 
-    SolveFracDiv(Outputs.Y6.divider_val, &Outputs.Y6);
+    const double target = Output->used ? Output->requested_freq : Output->output_freq;
+    const double divider = (VCO.output_freq / VCO.prescaler_A) / target;
 
-    if (Outputs.Y7.used)
-        Outputs.Y7.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y7.requested_freq;
+    // Y0 to Y3 have integer dividers only
+    if (output == CDCM_Y0Y1 || output == CDCM_Y2Y3)
+        Output->divider_val = std::round(divider);
     else
-        Outputs.Y7.divider_val = (VCO.output_freq / VCO.prescaler_A) / Outputs.Y7.output_freq;
-
-    SolveFracDiv(Outputs.Y7.divider_val, &Outputs.Y7);
-
-    UpdateOutputFrequencies();
-
-    return return_val;
+    {
+        Output->divider_val = divider;
+        SolveFracDiv(Output->divider_val, Output);
+    }
 }
 
 /**
@@ -481,9 +454,15 @@ int CDCM_Dev::UploadConfiguration()
         { 20, { static_cast<uint16_t>(SPI_BASE_ADDR + 20), 0 } },
     };
 
-    for (int i = 3; i < 24; i += 3)
+    // Registers shared with other settings, the values known to be on the device do not need to be read
+    for (int reg : { 3, 4, 9, 12, 15, 18 })
     {
-        int reg = i == 6 ? 4 : i; // Read 4th register instead of 6th
+        auto uploaded = uploaded_regs.find(CDCM_Regs[reg].addr);
+        if (uploaded != uploaded_regs.end())
+        {
+            CDCM_Regs[reg].val = uploaded->second;
+            continue;
+        }
         int val = ReadRegister(CDCM_Regs[reg].addr);
         if (val == -1)
             return -1;
@@ -541,13 +520,27 @@ int CDCM_Dev::UploadConfiguration()
 
     CDCM_Regs[20].val = Outputs.Y7.fractional_part & 0xFFFF;
 
-    for (auto reg : CDCM_Regs)
-        if (WriteRegister(reg.second.addr, reg.second.val) != 0)
-            return -1;
+    std::vector<uint32_t> mosi;
+    for (const auto& reg : CDCM_Regs)
+    {
+        auto uploaded = uploaded_regs.find(reg.second.addr);
+        if (uploaded == uploaded_regs.end() || uploaded->second != reg.second.val)
+            mosi.push_back(WriteCommand(reg.second.addr, reg.second.val));
+    }
+
+    // The device already runs this configuration
+    if (mosi.empty() && is_locked)
+        return 0;
 
     // Load to CDCM
-    if (WriteRegister(SPI_BASE_ADDR + 21, 1) != 0)
+    mosi.push_back(WriteCommand(SPI_BASE_ADDR + 21, 1));
+    if (WriteRegisters(mosi) != 0)
+    {
+        uploaded_regs.clear();
         return -1;
+    }
+    for (const auto& reg : CDCM_Regs)
+        uploaded_regs[reg.second.addr] = reg.second.val;
 
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
 
@@ -599,6 +592,7 @@ int CDCM_Dev::DownloadConfiguration()
     if (PrepareToReadRegs() != 0)
         return -1;
 
+    uploaded_regs.clear();
     for (auto& reg : CDCM_Regs)
     {
         int val = ReadRegister(reg.second.addr);
@@ -607,6 +601,12 @@ int CDCM_Dev::DownloadConfiguration()
         else
             reg.second.val = val;
     }
+    for (int reg = 1; reg <= 20; ++reg)
+    {
+        auto iter = CDCM_Regs.find(reg);
+        if (iter != CDCM_Regs.end())
+            uploaded_regs[iter->second.addr] = iter->second.val;
+    }
 
     VCO.M_div = (CDCM_Regs[1].val >> 2) + 1;
 
@@ -1004,10 +1004,54 @@ int CDCM_Dev::FindBestVCOConfigIndex(std::vector<CDCM_VCO>& input, int num_error
 }
 
 /**
-    @brief Finds VCO configuration based on requested output frequencies.
+    @brief Orders the VCO planning inputs, so they can be used as a map key.
+    @param other The planning inputs to compare to.
+    @return Whether these planning inputs are ordered before the other ones.
+*/
+bool CDCM_Dev::VCOPlanKey::operator<(const VCOPlanKey& other) const
+{
+    return std::tie(prim_freq, sec_freq, input_mux, version, Y0Y1_freq, Y2Y3_freq, Y0Y1_used, Y2Y3_used) <
+           std::tie(other.prim_freq,
+               other.sec_freq,
+               other.input_mux,
+               other.version,
+               other.Y0Y1_freq,
+               other.Y2Y3_freq,
+               other.Y0Y1_used,
+               other.Y2Y3_used);
+}
+
+/**
+    @brief Finds VCO configuration based on requested output frequencies, reusing the previously solved configurations.
     @return VCO configuration.
 */
 CDCM_VCO CDCM_Dev::FindVCOConfig()
+{
+    const VCOPlanKey key{ VCO.prim_freq,
+        VCO.sec_freq,
+        VCO.input_mux,
+        VCO.version,
+        Outputs.Y0Y1.requested_freq,
+        Outputs.Y2Y3.requested_freq,
+        Outputs.Y0Y1.used,
+        Outputs.Y2Y3.used };
+
+    auto cached = vco_plans.find(key);
+    if (cached != vco_plans.end())
+        return cached->second;
+
+    if (vco_plans.size() >= maxCachedVCOPlans)
+        vco_plans.clear();
+    CDCM_VCO config = SolveVCOConfig();
+    vco_plans.emplace(key, config);
+    return config;
+}
+
+/**
+    @brief Searches for the VCO configuration based on requested output frequencies.
+    @return VCO configuration.
+*/
+CDCM_VCO CDCM_Dev::SolveVCOConfig()
 {
     double l_Y0Y1 = Outputs.Y0Y1.requested_freq;
     double l_Y2Y3 = Outputs.Y2Y3.requested_freq;
@@ -1097,7 +1141,7 @@ CDCM_VCO CDCM_Dev::FindVCOConfig()
  */
 int CDCM_Dev::WriteRegister(uint16_t addr, uint16_t val)
 {
-    const uint32_t mosi = (1 << 31) | (addr << 16) | val;
+    const uint32_t mosi = WriteCommand(addr, val);
     try
     {
         comms->SPI(&mosi, nullptr, 1);
@@ -1108,6 +1152,24 @@ int CDCM_Dev::WriteRegister(uint16_t addr, uint16_t val)
     }
 }
 
+/**
+  @brief Writes several registers in a single transaction.
+  @param mosi The write commands, formed by WriteCommand().
+  @return 0 on success; -1 on error.
+ */
+int CDCM_Dev::WriteRegisters(const std::vector<uint32_t>& mosi)
+{
+    try
+    {
+        if (comms->SPI(mosi.data(), nullptr, mosi.size()) != OpStatus::SUCCESS)
+            return -1;
+        return 0;
+    } catch (...)
+    {
+        return -1;
+    }
+}
+
 /**
   @brief Reads the value of a given address.
   @param addr The address of which value to read.
@@ -3,6 +3,7 @@
 #include "limesuite/config.h"
 #include "FPGA_common.h"
 
+#include <map>
 #include <vector>
 #include <cstdint>
 
@@ -130,7 +131,11 @@ class LIME_API CDCM_Dev
       @brief Sets the base address of the SPI.
       @param SPI_BASE_ADDR The new address of the SPI.
      */
-    void SetSPIBaseAddr(uint16_t SPI_BASE_ADDR) { this->SPI_BASE_ADDR = SPI_BASE_ADDR; }
+    void SetSPIBaseAddr(uint16_t SPI_BASE_ADDR)
+    {
+        this->SPI_BASE_ADDR = SPI_BASE_ADDR;
+        uploaded_regs.clear();
+    }
 
     /**
       @brief Gets the base address of the SPI.
@@ -139,9 +144,28 @@ class LIME_API CDCM_Dev
     uint16_t GetSPIBaseAddr() { return SPI_BASE_ADDR; }
 
   private:
+    /** @brief The inputs of the VCO frequency planning, used as the key of the solved configurations cache. */
+    struct VCOPlanKey {
+        double prim_freq; ///< The primary input frequency
+        double sec_freq; ///< The secondary input frequency
+        int input_mux; ///< The selected input
+        int version; ///< The version of the clock generator
+        double Y0Y1_freq; ///< The requested frequency of the Y0Y1 output
+        double Y2Y3_freq; ///< The requested frequency of the Y2Y3 output
+        bool Y0Y1_used; ///< Whether the Y0Y1 output is used
+        bool Y2Y3_used; ///< Whether the Y2Y3 output is used
+
+        bool operator<(const VCOPlanKey& other) const;
+    };
+
     int WriteRegister(uint16_t addr, uint16_t val);
+    int WriteRegisters(const std::vector<uint32_t>& mosi);
     uint16_t ReadRegister(uint16_t addr);
 
+    CDCM_Output* GetOutput(cdcm_output_t output);
+    void SolveOutputDivider(cdcm_output_t output);
+    int ApplyVCOConfig(bool* vcoChanged);
+
     int SolveN(int Target, int* Mult8bit, int* Mult10bit);
     void CalculateFracDiv(CDCM_Output* Output);
     double DecToFrac(double target, int* num, int* den);
@@ -158,6 +182,7 @@ class LIME_API CDCM_Dev
     int FindLowestPSAOutput(std::vector<CDCM_VCO> input);
     int FindBestVCOConfigIndex(std::vector<CDCM_VCO>& input, int num_errors);
     CDCM_VCO FindVCOConfig();
+    CDCM_VCO SolveVCOConfig();
     int PrepareToReadRegs();
 
     std::shared_ptr<lime::ISPI> comms; ///< The communication with the device endpoint
@@ -165,4 +190,6 @@ class LIME_API CDCM_Dev
     CDCM_Outputs Outputs; ///< The outputs the device can handle
     uint16_t SPI_BASE_ADDR; ///< The base address of the stored information on the device
     bool is_locked; ///< Indicates whether the voltage-controlled oscillator phase lock loop is locked
+    std::map<VCOPlanKey, CDCM_VCO> vco_plans; ///< The solved VCO configurations
+    std::map<uint16_t, uint16_t> uploaded_regs; ///< The register values known to be on the device, by address
 };
@@ -43,6 +43,8 @@ const uint16_t PHCFG_MODE = 1 << 14;
 
 const uint16_t busyAddr = 0x0021;
 static const std::chrono::milliseconds busyPollPeriod(10); // time between checking "done" bit
+static const std::chrono::microseconds minBusyPollPeriod(50); // first wait before checking "done" bit again
+static constexpr int busySpinCount = 4; // times to check "done" bit without waiting
 
 // Does the FPGA have the "done" bit to indicate PLLCFG_START, PHCFG_START, PLLRST_START completion?
 static constexpr bool HasWaitForDone(uint8_t targetDevice)
@@ -190,6 +192,7 @@ OpStatus FPGA::WriteRegisters(const uint32_t* addrs, const uint32_t* data, unsig
         }
         if (spiBuffer.size())
             return fpgaPort->SPI(spiBuffer.data(), nullptr, spiBuffer.size());
+        return OpStatus::SUCCESS; // all of the values are already in the FPGA
     }
     for (unsigned i = 0; i < cnt; i++)
         spiBuffer.push_back((1 << 31) | (addrs[i]) << 16 | data[i]);
@@ -362,6 +365,9 @@ OpStatus FPGA::WaitTillDone(uint16_t pollAddr, uint16_t doneMask, uint16_t error
     auto t1 = chrono::high_resolution_clock::now();
     bool done = false;
     uint16_t error = 0;
+    // operations usually complete much sooner than the poll period, so check often at first and back off
+    int spinsLeft = busySpinCount;
+    chrono::microseconds pollPeriod = minBusyPollPeriod;
     if (!title.empty())
     {
         lime::debug("%s", title.c_str());
@@ -384,8 +390,13 @@ OpStatus FPGA::WaitTillDone(uint16_t pollAddr, uint16_t doneMask, uint16_t error
                 lime::warning("%s timeout", title.c_str());
                 return OpStatus::TIMEOUT;
             }
+            else if (spinsLeft > 0)
+                --spinsLeft;
             else
-                std::this_thread::sleep_for(busyPollPeriod);
+            {
+                std::this_thread::sleep_for(pollPeriod);
+                pollPeriod = std::min<chrono::microseconds>(pollPeriod * 2, busyPollPeriod);
+            }
         }
     } while (!done);
     if (!title.empty())
@@ -421,9 +432,9 @@ OpStatus FPGA::SetPllClock(uint8_t clockIndex, int nSteps, bool waitLock, bool d
 
     batch.WriteRegister(0x0023, reg23val); //PHCFG_UpDn, CNT_IND
     batch.WriteRegister(0x0024, abs(nSteps)); //CNT_PHASE
-    batch.Flush();
-    // TODO: could possibly write this in the same batch?
-    if (WriteRegister(0x0023, reg23val | PHCFG_START) != OpStatus::SUCCESS)
+    batch.Fence(); // the start bit has to be raised after the configuration is written
+    batch.WriteRegister(0x0023, reg23val | PHCFG_START);
+    if (batch.Flush() != OpStatus::SUCCESS)
         lime::error("FPGA SetPllFrequency: find phase, failed to write registers");
 
     const uint16_t doneMask = doPhaseSearch ? 0x4 : 0x1;
@@ -454,12 +465,12 @@ OpStatus FPGA::SetPllFrequency(const uint8_t pllIndex, const double inputFreq, s
 {
     const uint8_t clockCount = clocks.size();
     lime::debug("FPGA SetPllFrequency: PLL[%i] input:%.3f MHz clockCount:%i", pllIndex, inputFreq / 1e6, clockCount);
+    ForgetSearchedInterfaces(pllIndex);
     WriteRegistersBatch batch(this);
     const auto timeout = std::chrono::seconds(3);
     if (!fpgaPort)
         return ReportError(OpStatus::IO_FAILURE, "ConfigureFPGA_PLL: connection port is NULL");
 
-    const bool waitForDone = HasWaitForDone(ReadRegister(0)); // read targetDevice
     bool willDoPhaseSearch = false;
 
     if (pllIndex > 15)
@@ -489,9 +500,14 @@ OpStatus FPGA::SetPllFrequency(const uint8_t pllIndex, const double inputFreq, s
                 PLLlowerLimit / 1e6);
     }
 
-    uint16_t drct_clk_ctrl_0005 = ReadRegister(0x0005);
-    uint16_t reg23val = ReadRegister(0x0023);
-    uint16_t reg25 = ReadRegister(0x0025);
+    const uint32_t addrs[] = { 0x0000, 0x0005, 0x0023, 0x0025 }; // targetDevice, direct clocking, PLL control
+    uint32_t values[4];
+    if (ReadRegisters(addrs, values, 4) != OpStatus::SUCCESS)
+        return ReportError(OpStatus::IO_FAILURE, "FPGA SetPllFrequency: failed to read registers");
+    const bool waitForDone = HasWaitForDone(values[0]);
+    uint16_t drct_clk_ctrl_0005 = values[1];
+    uint16_t reg23val = values[2];
+    uint16_t reg25 = values[3];
 
     //disable direct clock source
     batch.WriteRegister(0x0005, drct_clk_ctrl_0005 & ~(1 << pllIndex));
@@ -501,11 +517,15 @@ OpStatus FPGA::SetPllFrequency(const uint8_t pllIndex, const double inputFreq, s
 
     batch.WriteRegister(0x0025, reg25 | 0x80); // TODO: what's 0x80?
     batch.WriteRegister(0x0023, reg23val); //PLL_IND
+    if (!willDoPhaseSearch)
+    {
+        batch.Fence();
+        batch.WriteRegister(0x0023, reg23val | PLLRST_START);
+    }
     batch.Flush();
 
     if (!willDoPhaseSearch)
     {
-        WriteRegister(0x0023, reg23val | PLLRST_START);
         if (waitForDone)
         {
             const std::string title = "FPGA PLL[" + std::to_string(pllIndex) + "] PLLRST_START";
@@ -659,6 +679,7 @@ OpStatus FPGA::SetDirectClocking(int clockIndex)
     if (!fpgaPort)
         return ReportError(OpStatus::IO_FAILURE, "SetDirectClocking: connection port is NULL");
 
+    ForgetSearchedInterfaces(clockIndex);
     uint16_t drct_clk_ctrl_0005 = ReadRegister(0x0005);
     //enable direct clocking
     if (WriteRegister(0x0005, drct_clk_ctrl_0005 | (1 << clockIndex)) != OpStatus::SUCCESS)
@@ -666,6 +687,46 @@ OpStatus FPGA::SetDirectClocking(int clockIndex)
     return OpStatus::SUCCESS;
 }
 
+/// @brief Forgets the phase searches whose interface was clocked by the given PLL.
+/// @param pllIndex The PLL being reconfigured.
+void FPGA::ForgetSearchedInterfaces(uint8_t pllIndex)
+{
+    for (auto iter = searchedInterfaces.begin(); iter != searchedInterfaces.end();)
+    {
+        if (iter->second.txPLLindex == pllIndex || iter->second.rxPLLindex == pllIndex)
+            iter = searchedInterfaces.erase(iter);
+        else
+            ++iter;
+    }
+}
+
+/// @brief Checks the test pattern at the current phase of a PLL clock, without moving the phase.
+///
+/// The gateware has no separate pattern check, so a phase search of zero steps is used as one.
+/// The LimeLight test pattern has to be configured by the caller.
+/// @param pllIndex The PLL to check.
+/// @param clockIndex The PLL output clocking the interface.
+/// @return Whether the test pattern was received without errors.
+bool FPGA::VerifyPllPhase(uint8_t pllIndex, uint8_t clockIndex)
+{
+    const uint32_t addrs[] = { 0x0000, 0x0023 }; // targetDevice, PLL control
+    uint32_t values[2];
+    if (ReadRegisters(addrs, values, 2) != OpStatus::SUCCESS)
+        return false;
+    if (!HasWaitForDone(values[0])) // the check result can't be read back
+        return false;
+
+    uint16_t reg23val = values[1];
+    reg23val &= ~(PLLCFG_START | PHCFG_START | PLLRST_START | PHCFG_UPDN); //clear controls
+    reg23val &= ~(0x1F << 3); //clear PLL index
+    reg23val |= pllIndex << 3;
+    if (WriteRegister(0x0023, reg23val) != OpStatus::SUCCESS)
+        return false;
+    if (SetPllClock(clockIndex, 0, true, true, reg23val) != OpStatus::SUCCESS)
+        return false;
+    return (ReadRegister(busyAddr) & 0x8) == 0; // phase search error
+}
+
 /** @brief Parses FPGA packet payload into samples.
   @param buffer The buffer to parse.
   @param bufLen The length of the buffer to parse.
@@ -896,6 +957,9 @@ OpStatus FPGA::SetInterfaceFreq(double txRate_Hz, double rxRate_Hz, double txPha
 }
 
 /// @brief Configures FPGA PLLs to LimeLight interface frequency.
+///
+/// The phase search is skipped if the PLLs were not reconfigured since a successful search for the same interface,
+/// and the test pattern is still received at the phase found by it.
 /// @param txRate_Hz The transmit rate (in Hz).
 /// @param rxRate_Hz The receive rate (in Hz).
 /// @param chipIndex The chip to configure.
@@ -950,16 +1014,21 @@ OpStatus FPGA::SetInterfaceFreq(double txRate_Hz, double rxRate_Hz, int chipInde
     dataWr[0] = (1 << 31) | (0x0020u << 16) | 0xFFFD; //msbit 1=SPI write
     WriteLMS7002MSPI(dataWr.data(), 1);
 
-    ReadLMS7002MSPI(spiAddr.data(), dataRdA.data(), bakRegCnt);
-
+    uint32_t lmlClockConfig;
     {
         const uint32_t addr = 0x002A;
-        uint32_t val;
-        ReadLMS7002MSPI(&addr, &val, 1);
-        bypassTx = (val & 0xF0) == 0x00;
-        bypassRx = (val & 0x0F) == 0x0D;
+        ReadLMS7002MSPI(&addr, &lmlClockConfig, 1);
+        bypassTx = (lmlClockConfig & 0xF0) == 0x00;
+        bypassRx = (lmlClockConfig & 0x0F) == 0x0D;
     }
 
+    // The PLLs keep the phase found for this interface, unless the chip's clocks changed under them
+    const SearchedInterfaceKey interfaceKey{ chipIndex, txRate_Hz, rxRate_Hz };
+    auto searched = searchedInterfaces.find(interfaceKey);
+    const bool verifyOnly = searched != searchedInterfaces.end() && searched->second.lmlClockConfig == lmlClockConfig;
+
+    ReadLMS7002MSPI(spiAddr.data(), dataRdA.data(), bakRegCnt);
+
     dataWr[0] = (1 << 31) | (0x0020u << 16) | 0xFFFE; //msbit 1=SPI write
     WriteLMS7002MSPI(dataWr.data(), 1);
 
@@ -997,8 +1066,14 @@ OpStatus FPGA::SetInterfaceFreq(double txRate_Hz, double rxRate_Hz, int chipInde
     rxClocks[1].index = 1;
     rxClocks[1].findPhase = true;
 
+    if (verifyOnly && VerifyPllPhase(rxPLLindex, rxClocks[1].index))
+    {
+        lime::debug("FPGA::SetInterfaceFreq: Rx phase verified, phase search skipped");
+        phaseSearchSuccess = true;
+    }
+
     const int pllConfigRetryCount = 2;
-    for (int i = 0; i < pllConfigRetryCount; i++) // attempt phase search multiple times
+    for (int i = 0; i < pllConfigRetryCount && !phaseSearchSuccess; i++) // attempt phase search multiple times
     {
         if (SetPllFrequency(rxPLLindex, rxRate_Hz, rxClocks) == OpStatus::SUCCESS)
         {
@@ -1054,7 +1129,13 @@ OpStatus FPGA::SetInterfaceFreq(double txRate_Hz, double rxRate_Hz, int chipInde
     txClocks[1].findPhase = true;
     WriteRegister(0x000A, reg_000A | TX_PTRN_EN);
 
-    for (int i = 0; i < pllConfigRetryCount; i++)
+    if (verifyOnly && VerifyPllPhase(txPLLindex, txClocks[1].index))
+    {
+        lime::debug("FPGA::SetInterfaceFreq: Tx phase verified, phase search skipped");
+        phaseSearchSuccess = true;
+    }
+
+    for (int i = 0; i < pllConfigRetryCount && !phaseSearchSuccess; i++)
     {
         if (SetPllFrequency(txPLLindex, txRate_Hz, txClocks) == OpStatus::SUCCESS)
         {
@@ -1101,9 +1182,32 @@ OpStatus FPGA::SetInterfaceFreq(double txRate_Hz, double rxRate_Hz, int chipInde
     dataWr[0] = (1 << 31) | (0x0020u << 16) | reg20; //msbit 1=SPI write
     WriteLMS7002MSPI(dataWr.data(), 1);
     WriteRegister(0x000A, reg_000A);
+    if (status == OpStatus::SUCCESS)
+        searchedInterfaces[interfaceKey] = { lmlClockConfig, static_cast<uint8_t>(txPLLindex), static_cast<uint8_t>(rxPLLindex) };
     return status;
 }
 
+/// @brief Forgets the phase searches of a chip whose clock generator was reconfigured since the last report.
+///
+/// Retuning or resetting the clock generator changes the LimeLight interface clocks the phases were found for.
+/// @param chipIndex The chip the count belongs to.
+/// @param configurationCount The chip's clock generator configuration count (LMS7002M::GetCGENConfigurationCount()).
+void FPGA::UpdateCGENConfigurationCount(int chipIndex, uint32_t configurationCount)
+{
+    auto reported = cgenConfigurationCounts.find(chipIndex);
+    if (reported != cgenConfigurationCounts.end() && reported->second == configurationCount)
+        return;
+    cgenConfigurationCounts[chipIndex] = configurationCount;
+
+    for (auto iter = searchedInterfaces.begin(); iter != searchedInterfaces.end();)
+    {
+        if (iter->first.chipIndex == chipIndex)
+            iter = searchedInterfaces.erase(iter);
+        else
+            ++iter;
+    }
+}
+
 int FPGA::ReadRawStreamData(char* buffer, unsigned length, int epIndex, int timeout_ms)
 {
     SelectModule(epIndex);
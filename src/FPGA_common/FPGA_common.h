@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include "SamplesPacket.h"
@@ -52,6 +53,7 @@ class FPGA
 
     virtual OpStatus SetInterfaceFreq(double f_Tx_Hz, double f_Rx_Hz, double txPhase, double rxPhase, int chipIndex = 0);
     virtual OpStatus SetInterfaceFreq(double f_Tx_Hz, double f_Rx_Hz, int chipIndex = 0);
+    void UpdateCGENConfigurationCount(int chipIndex, uint32_t configurationCount);
     double DetectRefClk(double fx3Clk = 100e6);
 
     static int FPGAPacketPayload2Samples(
@@ -89,10 +91,36 @@ class FPGA
     std::shared_ptr<ISPI> lms7002mPort;
 
   private:
+    /** @brief The LimeLight interface a phase search was done for. */
+    struct SearchedInterfaceKey {
+        int chipIndex; ///< The chip the interface belongs to.
+        double txRate_Hz; ///< The transmit rate (in Hz).
+        double rxRate_Hz; ///< The receive rate (in Hz).
+
+        bool operator<(const SearchedInterfaceKey& other) const
+        {
+            return std::tie(chipIndex, txRate_Hz, rxRate_Hz) < std::tie(other.chipIndex, other.txRate_Hz, other.rxRate_Hz);
+        }
+    };
+
+    /** @brief The PLL configuration left behind by a successful phase search. */
+    struct SearchedInterface {
+        uint32_t lmlClockConfig; ///< The LMS7002M interface clock configuration (register 0x002A).
+        uint8_t txPLLindex; ///< The PLL clocking the transmit interface.
+        uint8_t rxPLLindex; ///< The PLL clocking the receive interface.
+    };
+
     virtual int ReadRawStreamData(char* buffer, unsigned length, int epIndex, int timeout_ms);
     OpStatus SetPllClock(uint8_t clockIndex, int nSteps, bool waitLock, bool doPhaseSearch, uint16_t& reg23val);
+    bool VerifyPllPhase(uint8_t pllIndex, uint8_t clockIndex);
+    void ForgetSearchedInterfaces(uint8_t pllIndex);
     bool useCache;
     std::map<uint16_t, uint16_t> regsCache;
+    /// The interfaces whose found phase the PLLs still hold, forgotten when their PLLs are reconfigured.
+    /// The gateware doesn't report the phase it found, so it can't be restored later: switching the rates
+    /// from A to B and back to A searches for the phase of A again.
+    std::map<SearchedInterfaceKey, SearchedInterface> searchedInterfaces;
+    std::map<int, uint32_t> cgenConfigurationCounts; ///< The last reported clock generator configuration count of each chip.
 };
 
 } // namespace lime
@@ -12,29 +12,127 @@ using namespace lime;
 
 /// @brief Constructor for the batch.
 /// @param fpga The FPGA this batch belongs to.
-WriteRegistersBatch::WriteRegistersBatch(FPGA* fpga)
-    : owner(fpga){};
+/// @param writeBehind Whether the writes should be sent by a worker thread as they are queued.
+WriteRegistersBatch::WriteRegistersBatch(FPGA* fpga, bool writeBehind)
+    : owner(fpga)
+    , fenceIndex(0)
+    , writeBehind(writeBehind)
+    , workerBusy(false)
+    , terminate(false)
+    , workerStatus(OpStatus::SUCCESS)
+{
+    if (writeBehind)
+        worker = std::thread(&WriteRegistersBatch::WorkerLoop, this);
+}
 
 WriteRegistersBatch::~WriteRegistersBatch()
 {
+    if (writeBehind)
+    {
+        Flush();
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            terminate = true;
+        }
+        queueCv.notify_all();
+        worker.join();
+        return;
+    }
     ASSERT_WARNING(addrs.size() == 0, "FPGA WriteRegistersBatch not flushed");
 }
 
 /// @brief Writes the modified values into the FPGA.
+/// In write-behind mode waits until the worker has written all of the queued values.
 /// @return The operation status.
 OpStatus WriteRegistersBatch::Flush()
 {
-    OpStatus status = owner->WriteRegisters(addrs.data(), values.data(), addrs.size());
+    if (writeBehind)
+    {
+        std::unique_lock<std::mutex> lock(queueLock);
+        queueCv.wait(lock, [this]() { return addrs.empty() && !workerBusy; });
+        OpStatus status = workerStatus;
+        workerStatus = OpStatus::SUCCESS;
+        return status;
+    }
+
+    OpStatus status = OpStatus::SUCCESS;
+    if (!addrs.empty())
+        status = owner->WriteRegisters(addrs.data(), values.data(), addrs.size());
     addrs.clear();
     values.clear();
+    fenceIndex = 0;
     return status;
 }
 
 /// @brief Sets an address value pair to write into the FPGA on flushing.
+/// Replaces a queued write to the same address, unless it is before a fence.
 /// @param addr The address to write to.
 /// @param value The value to write.
 void WriteRegistersBatch::WriteRegister(uint16_t addr, uint16_t value)
 {
+    if (!writeBehind)
+    {
+        Append(addr, value);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        Append(addr, value);
+    }
+    queueCv.notify_all();
+}
+
+/// @brief Prevents the writes queued so far from being merged with the following ones.
+void WriteRegistersBatch::Fence()
+{
+    std::unique_lock<std::mutex> lock(queueLock, std::defer_lock);
+    if (writeBehind)
+        lock.lock();
+    fenceIndex = addrs.size();
+}
+
+void WriteRegistersBatch::Append(uint16_t addr, uint16_t value)
+{
+    for (std::size_t i = addrs.size(); i > fenceIndex; --i)
+    {
+        if (addrs[i - 1] == addr)
+        {
+            addrs.erase(addrs.begin() + (i - 1));
+            values.erase(values.begin() + (i - 1));
+            break;
+        }
+    }
     addrs.push_back(addr);
     values.push_back(value);
 }
+
+void WriteRegistersBatch::WorkerLoop()
+{
+    std::vector<uint32_t> sendAddrs;
+    std::vector<uint32_t> sendValues;
+    std::unique_lock<std::mutex> lock(queueLock);
+    while (true)
+    {
+        queueCv.wait(lock, [this]() { return terminate || !addrs.empty(); });
+        if (addrs.empty())
+            return;
+
+        // everything taken now is sent before any later write, so the fence can be reset
+        sendAddrs.swap(addrs);
+        sendValues.swap(values);
+        fenceIndex = 0;
+        workerBusy = true;
+        lock.unlock();
+
+        OpStatus status = owner->WriteRegisters(sendAddrs.data(), sendValues.data(), sendAddrs.size());
+        sendAddrs.clear();
+        sendValues.clear();
+
+        lock.lock();
+        if (workerStatus == OpStatus::SUCCESS)
+            workerStatus = status;
+        workerBusy = false;
+        queueCv.notify_all();
+    }
+}
@@ -1,27 +1,50 @@
 #ifndef LIME_WRITEREGISTERSBATCH_H
 #define LIME_WRITEREGISTERSBATCH_H
 
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "FPGA_common.h"
 
 namespace lime {
 
-/** @brief A class for writing a batch of registers into the FPGA. */
+/** @brief A class for writing a batch of registers into the FPGA.
+
+  Repeated writes to the same address are collapsed into the last one, which is sent in the
+  position of the last write. Use Fence() where the intermediate values must reach the FPGA.
+
+  In write-behind mode the queued writes are sent by a worker thread, and Flush() waits until
+  everything has been written. The FPGA must not be accessed directly until then.
+ */
 class WriteRegistersBatch
 {
   public:
-    WriteRegistersBatch(FPGA* fpga);
+    WriteRegistersBatch(FPGA* fpga, bool writeBehind = false);
     ~WriteRegistersBatch();
 
     OpStatus Flush();
     void WriteRegister(uint16_t addr, uint16_t value);
+    void Fence();
 
   private:
+    void Append(uint16_t addr, uint16_t value);
+    void WorkerLoop();
+
     FPGA* owner;
     std::vector<uint32_t> addrs;
     std::vector<uint32_t> values;
+    std::size_t fenceIndex;
+
+    bool writeBehind;
+    std::thread worker;
+    std::mutex queueLock;
+    std::condition_variable queueCv;
+    bool workerBusy;
+    bool terminate;
+    OpStatus workerStatus;
 };
 
 } // namespace lime
@@ -5,8 +5,13 @@
 */
 
 #include "Logger.h"
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstring> //strerror
+#include <mutex>
+#include <thread>
 
 #ifdef _MSC_VER
     #define thread_local __declspec(thread)
@@ -86,19 +91,231 @@ static void defaultLogHandler(const lime::LogLevel level, const char* message)
     fprintf(stderr, "%s\n", message);
 }
 
-static lime::LogHandler logHandler(&defaultLogHandler);
+// replaced by the callers while the drain thread delivers the queued messages
+static std::atomic<lime::LogHandler> logHandler(&defaultLogHandler);
+
+static void deliver(const lime::LogLevel level, const char* message)
+{
+    logHandler.load(std::memory_order_acquire)(level, message);
+}
+
+namespace {
+
+/** @brief Bounded lock-free multi-producer queue of formatted log messages, drained by a background thread.
+
+  The cells carry sequence numbers as in the Vyukov bounded queue: a producer claims a cell by advancing
+  the write position, formats the message straight into it and then publishes it by updating its sequence.
+ */
+class AsyncLogSink
+{
+  public:
+    AsyncLogSink()
+        : writePosition(0)
+        , readPosition(0)
+        , dropped(0)
+        , activeProducers(0)
+        , running(false)
+    {
+        for (std::size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        for (auto& level : synchronous)
+            level.store(false, std::memory_order_relaxed);
+        synchronous[static_cast<int>(lime::LogLevel::CRITICAL)].store(true, std::memory_order_relaxed);
+    }
+
+    ~AsyncLogSink() { Stop(); }
+
+    void Start()
+    {
+        std::lock_guard<std::mutex> lock(controlMutex);
+        if (running.load(std::memory_order_relaxed))
+            return;
+        running.store(true, std::memory_order_relaxed);
+        thread = std::thread(&AsyncLogSink::DrainLoop, this);
+#ifdef __linux__
+        pthread_setname_np(thread.native_handle(), "lime:Log");
+#endif
+        enabled.store(true, std::memory_order_release);
+    }
+
+    void Stop()
+    {
+        std::lock_guard<std::mutex> lock(controlMutex);
+        enabled.store(false);
+        if (!running.load(std::memory_order_relaxed))
+            return;
+        // the producers that saw the queue enabled may still be formatting into their claimed cells
+        while (activeProducers.load() != 0)
+            std::this_thread::yield();
+        running.store(false, std::memory_order_relaxed);
+        thread.join();
+        // messages pushed while the thread was stopping
+        Drain();
+    }
+
+    /// Returns false if the message has to be delivered synchronously.
+    bool Push(const lime::LogLevel level, const char* format, va_list argList)
+    {
+        if (synchronous[static_cast<int>(level)].load(std::memory_order_relaxed))
+            return false;
+        // registered before checking the flag, so Stop() either sees the producer or the producer sees it disabled
+        activeProducers.fetch_add(1);
+        const bool queued = enabled.load() && Enqueue(level, format, argList);
+        activeProducers.fetch_sub(1, std::memory_order_release);
+        return queued;
+    }
+
+    void Flush()
+    {
+        if (!running.load(std::memory_order_relaxed))
+            return;
+        const std::size_t target = writePosition.load(std::memory_order_acquire);
+        while (static_cast<intptr_t>(readPosition.load(std::memory_order_acquire) - target) < 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    void SetSynchronous(const lime::LogLevel level, const bool value)
+    {
+        synchronous[static_cast<int>(level)].store(value, std::memory_order_relaxed);
+    }
+
+    uint64_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr std::size_t capacity = 256;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        lime::LogLevel level;
+        char message[MAX_MSG_LEN];
+    };
+
+    /// Formats the message into a claimed cell, or counts it as dropped if the queue is full.
+    bool Enqueue(const lime::LogLevel level, const char* format, va_list argList)
+    {
+        std::size_t position = writePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &cells[position % capacity];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            else
+                position = writePosition.load(std::memory_order_relaxed);
+        }
+
+        cell->level = level;
+        const int length = vsnprintf(cell->message, sizeof(cell->message), format, argList);
+        if (length <= 0)
+            cell->message[0] = 0;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    void DrainLoop()
+    {
+        while (running.load(std::memory_order_relaxed))
+        {
+            if (!Drain())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    /// Delivers the published messages, returns whether there were any.
+    bool Drain()
+    {
+        bool delivered = false;
+        std::size_t position = readPosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell& cell = cells[position % capacity];
+            if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+                break;
+            if (cell.message[0])
+                deliver(cell.level, cell.message);
+            cell.sequence.store(position + capacity, std::memory_order_release);
+            ++position;
+            readPosition.store(position, std::memory_order_release);
+            delivered = true;
+        }
+
+        const uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+        if (droppedNow != reportedDrops)
+        {
+            char message[64];
+            const unsigned long long count = droppedNow - reportedDrops;
+            snprintf(message, sizeof(message), "%llu log messages dropped", count);
+            deliver(lime::LogLevel::WARNING, message);
+            reportedDrops = droppedNow;
+        }
+        return delivered;
+    }
+
+    std::array<Cell, capacity> cells;
+    alignas(64) std::atomic<std::size_t> writePosition;
+    alignas(64) std::atomic<std::size_t> readPosition;
+    std::atomic<uint64_t> dropped;
+    std::atomic<int> activeProducers;
+    uint64_t reportedDrops = 0;
+    std::array<std::atomic<bool>, 5> synchronous;
+
+    std::atomic<bool> enabled{ false };
+    std::atomic<bool> running;
+    std::mutex controlMutex;
+    std::thread thread;
+};
+
+AsyncLogSink asyncLogSink;
+
+} // namespace
 
 void lime::log(const LogLevel level, const char* format, va_list argList)
 {
+    if (asyncLogSink.Push(level, format, argList))
+        return;
+
     char buff[4096];
     int ret = vsnprintf(buff, sizeof(buff), format, argList);
     if (ret > 0)
-        logHandler(level, buff);
+        deliver(level, buff);
+}
+
+void lime::enableAsyncLogging(const bool enable)
+{
+    if (enable)
+        asyncLogSink.Start();
+    else
+        asyncLogSink.Stop();
+}
+
+void lime::setLogLevelSynchronous(const LogLevel level, const bool synchronous)
+{
+    asyncLogSink.SetSynchronous(level, synchronous);
+}
+
+void lime::flushLog(void)
+{
+    asyncLogSink.Flush();
+}
+
+uint64_t lime::getDroppedLogCount(void)
+{
+    return asyncLogSink.GetDroppedCount();
 }
 
 void lime::registerLogHandler(const LogHandler handler)
 {
-    logHandler = handler ? handler : defaultLogHandler;
+    logHandler.store(handler ? handler : defaultLogHandler, std::memory_order_release);
 }
 
 const char* lime::logLevelToName(const LogLevel level)
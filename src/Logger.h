@@ -81,12 +81,41 @@ typedef void (*LogHandler)(const LogLevel level, const char* message);
 /*!
  * Register a new system log handler.
  * Platforms should call this to replace the default stdio handler.
+ * It can be called at any time, the queued asynchronous messages go to the handler registered when they are delivered.
  */
 LIME_API void registerLogHandler(const LogHandler handler);
 
 //! Convert log level to a string name for printing
 LIME_API const char* logLevelToName(const LogLevel level);
 
+/*!
+ * Enable or disable the asynchronous delivery of the log messages.
+ * When enabled, the messages are formatted on the calling thread into a bounded lock-free queue,
+ * and a background thread passes them to the registered handler, so a slow handler does not stall the caller.
+ * When the queue is full the messages are dropped and counted.
+ * Disabling it delivers the queued messages first.
+ * The asynchronous delivery is opt-in, the library never enables it by itself: applications that log from
+ * their streaming threads should enable it before starting the streams, and disable it before exiting.
+ * limeTRX and the FFT viewer enable it while streaming, SoapyLMS7 while any of its devices is open.
+ * \param enable whether to deliver the messages asynchronously
+ */
+LIME_API void enableAsyncLogging(const bool enable);
+
+/*!
+ * Set whether the messages of a level bypass the queue and reach the handler before the log call returns.
+ * By default only the CRITICAL messages are synchronous.
+ * Synchronous messages can be delivered ahead of the queued ones.
+ * \param level the logging level to configure
+ * \param synchronous whether to deliver the messages synchronously
+ */
+LIME_API void setLogLevelSynchronous(const LogLevel level, const bool synchronous);
+
+//! Wait until all of the queued log messages have been passed to the handler
+LIME_API void flushLog(void);
+
+//! Get the total amount of log messages dropped because the queue was full
+LIME_API uint64_t getDroppedLogCount(void);
+
 /*!
  * Get the error code to string + any optional message reported.
  */
@@ -15,12 +15,35 @@
 #include <cassert>
 #include <ciso646> // alternative operators for visual c++: not, and, or...
 #include <vector>
+#include <algorithm>
+#include <tuple>
 #include "limesuite/IComms.h"
 
 using namespace std;
 using namespace lime;
 
 static const uint8_t addrSi5351 = 0xC0;
+static constexpr std::size_t maxCachedPlans = 64;
+
+/// Returns the bit mask of the outputs affected by a configuration register, all outputs if it is shared
+static uint8_t AffectedOutputs(int reg)
+{
+    if (reg >= 16 && reg <= 23) // CLKx control
+        return 1 << (reg - 16);
+    if (reg >= 42 && reg <= 89) // multisynth 0-5 parameters
+        return 1 << ((reg - 42) / 8);
+    if (reg == 90 || reg == 91) // multisynth 6-7 parameters
+        return 1 << (reg - 84);
+    if (reg >= 165 && reg <= 170) // CLK0-5 initial phase offset
+        return 1 << (reg - 165);
+    return 0xFF;
+}
+
+/// Returns whether the register holds the input or the feedback divider settings of the PLLs
+static bool IsPLLRegister(int reg)
+{
+    return reg == 15 || (reg >= 26 && reg <= 41);
+}
 
 /// Splits float into fraction integers A + B/C
 void realToFrac(const float real, int& A, int& B, int& C)
@@ -513,7 +536,9 @@ const unsigned char Si5351C::m_defaultConfiguration[] = { 0,
 // ---------------------------------------------------------------------------
 Si5351C::Si5351C(lime::II2C& i2c_comms)
     : comms(i2c_comms)
+    , m_uploadedConfigurationValid(false)
 {
+    memset(m_uploadedConfiguration, 0, 255);
     memset(m_newConfiguration, 0, 255);
     for (unsigned int i = 0; i < sizeof(m_defaultConfiguration); i += 2)
     {
@@ -528,44 +553,90 @@ Si5351C::~Si5351C()
 
 /** 
  * @brief Sends Configuration to Si5351C
+ *
+ * The first upload writes the whole configuration, the following ones write only the registers
+ * that differ from the previous upload and disable just the outputs affected by them.
  * @return The status code of the operation
 */
 Si5351C::Status Si5351C::UploadConfiguration()
 {
     std::vector<uint8_t> outBuffer;
-    //Disable outputs
-    outBuffer.push_back(3);
-    outBuffer.push_back(0xFF);
-    //Power down all output drivers
-    for (int i = 0; i < 8; ++i)
-    {
-        outBuffer.push_back(16 + i);
-        outBuffer.push_back(0x84);
-    }
-    //write new configuration
-    for (int i = 15; i <= 92; ++i)
+    if (m_uploadedConfigurationValid)
     {
-        outBuffer.push_back(i);
-        outBuffer.push_back(m_newConfiguration[i]);
+        std::vector<uint8_t> changes;
+        uint8_t affectedOutputs = 0;
+        bool pllChanged = false;
+        // configuration registers 15-92 and 149-170
+        for (int i = 15; i <= 170; i = (i == 92 ? 149 : i + 1))
+        {
+            if (m_newConfiguration[i] == m_uploadedConfiguration[i])
+                continue;
+            changes.push_back(i);
+            changes.push_back(m_newConfiguration[i]);
+            affectedOutputs |= AffectedOutputs(i);
+            pllChanged |= IsPLLRegister(i);
+        }
+        if (changes.empty() && m_newConfiguration[3] == m_uploadedConfiguration[3])
+            return Status::SUCCESS;
+
+        //Disable the reconfigured outputs
+        if (affectedOutputs)
+        {
+            outBuffer.push_back(3);
+            outBuffer.push_back(m_uploadedConfiguration[3] | affectedOutputs);
+        }
+        //write changed configuration
+        outBuffer.insert(outBuffer.end(), changes.begin(), changes.end());
+        //apply soft reset
+        if (pllChanged)
+        {
+            outBuffer.push_back(0XB1);
+            outBuffer.push_back(0xAC);
+        }
     }
-    for (int i = 149; i <= 170; ++i)
+    else
     {
-        outBuffer.push_back(i);
-        outBuffer.push_back(m_newConfiguration[i]);
+        //Disable outputs
+        outBuffer.push_back(3);
+        outBuffer.push_back(0xFF);
+        //Power down all output drivers
+        for (int i = 0; i < 8; ++i)
+        {
+            outBuffer.push_back(16 + i);
+            outBuffer.push_back(0x84);
+        }
+        //write new configuration
+        for (int i = 15; i <= 92; ++i)
+        {
+            outBuffer.push_back(i);
+            outBuffer.push_back(m_newConfiguration[i]);
+        }
+        for (int i = 149; i <= 170; ++i)
+        {
+            outBuffer.push_back(i);
+            outBuffer.push_back(m_newConfiguration[i]);
+        }
+        //apply soft reset
+        outBuffer.push_back(0XB1);
+        outBuffer.push_back(0xAC);
     }
-    //apply soft reset
-    outBuffer.push_back(0XB1);
-    outBuffer.push_back(0xAC);
     //Enabe desired outputs
     outBuffer.push_back(3);
     outBuffer.push_back(m_newConfiguration[3]);
 
     try
     {
-        comms.I2CWrite(addrSi5351, outBuffer.data(), outBuffer.size());
+        if (comms.I2CWrite(addrSi5351, outBuffer.data(), outBuffer.size()) != OpStatus::SUCCESS)
+        {
+            m_uploadedConfigurationValid = false;
+            return Status::FAILED;
+        }
+        memcpy(m_uploadedConfiguration, m_newConfiguration, sizeof(m_uploadedConfiguration));
+        m_uploadedConfigurationValid = true;
         return Status::SUCCESS;
     } catch (std::runtime_error& e)
     {
+        m_uploadedConfigurationValid = false;
         lime::error("Si5351C configuration failed %s", e.what());
         return Status::FAILED;
     }
@@ -840,12 +911,57 @@ void Si5351C::FindVCO(Si5351_Channel* clocks, Si5351_PLL* plls, const unsigned l
     }
 }
 
+bool Si5351C::PlanKey::operator<(const PlanKey& other) const
+{
+    return std::tie(inputFreqHz, outputFreqHz, powered) < std::tie(other.inputFreqHz, other.outputFreqHz, other.powered);
+}
+
+/** @brief Solves the dividers for the requested clocks, reusing the plan of previously requested ones
+*/
+void Si5351C::PlanClocks()
+{
+    PlanKey key;
+    for (int i = 0; i < 2; ++i)
+        key.inputFreqHz[i] = PLL[i].inputFreqHz;
+    for (int i = 0; i < 8; ++i)
+    {
+        key.outputFreqHz[i] = CLK[i].outputFreqHz;
+        key.powered[i] = CLK[i].powered;
+    }
+
+    auto cached = m_plans.find(key);
+    if (cached == m_plans.end())
+    {
+        FindVCO(CLK, PLL, 600000000, 900000000);
+        if (m_plans.size() >= maxCachedPlans)
+            m_plans.clear();
+        Plan plan;
+        std::copy(CLK, CLK + 8, plan.clocks.begin());
+        std::copy(PLL, PLL + 2, plan.plls.begin());
+        m_plans.emplace(key, plan);
+        return;
+    }
+
+    const Plan& plan = cached->second;
+    for (int i = 0; i < 8; ++i)
+    {
+        CLK[i].pllSource = plan.clocks[i].pllSource;
+        CLK[i].int_mode = plan.clocks[i].int_mode;
+        CLK[i].multisynthDivider = plan.clocks[i].multisynthDivider;
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        PLL[i].VCO_Hz = plan.plls[i].VCO_Hz;
+        PLL[i].feedbackDivider = plan.plls[i].feedbackDivider;
+    }
+}
+
 /** @brief Modifies register map with clock settings
     @return true if success
 */
 Si5351C::Status Si5351C::ConfigureClocks()
 {
-    FindVCO(CLK, PLL, 600000000, 900000000);
+    PlanClocks();
     int addr;
     m_newConfiguration[3] = 0;
     for (int i = 0; i < 8; ++i)
@@ -7,8 +7,10 @@
 #ifndef SI5351C_MODULE
 #define SI5351C_MODULE
 
+#include <array>
 #include <cstdint>
 #include <cstdio>
+#include <map>
 #include <string>
 #include "limesuite/config.h"
 //---------------------------------------------------------------------------
@@ -106,7 +108,23 @@ class LIME_API Si5351C
     void Reset();
 
   private:
+    /** @brief The requested clocks a frequency plan is solved for. */
+    struct PlanKey {
+        std::array<unsigned long, 2> inputFreqHz; ///< The input frequencies of the PLLs
+        std::array<unsigned long, 8> outputFreqHz; ///< The requested output frequencies
+        std::array<bool, 8> powered; ///< Whether the outputs are powered
+
+        bool operator<(const PlanKey& other) const;
+    };
+
+    /** @brief The dividers and sources solved by FindVCO() for a set of requested clocks. */
+    struct Plan {
+        std::array<Si5351_Channel, 8> clocks; ///< The solved output clocks
+        std::array<Si5351_PLL, 2> plls; ///< The solved PLLs
+    };
+
     void FindVCO(Si5351_Channel* clocks, Si5351_PLL* plls, const unsigned long Fmin, const unsigned long Fmax);
+    void PlanClocks();
     lime::II2C& comms;
 
     Si5351_PLL PLL[2];
@@ -114,6 +132,9 @@ class LIME_API Si5351C
 
     static const unsigned char m_defaultConfiguration[];
     unsigned char m_newConfiguration[255];
+    unsigned char m_uploadedConfiguration[255]; ///< The register values last written to the chip
+    bool m_uploadedConfigurationValid; ///< Whether the chip is known to hold m_uploadedConfiguration
+    std::map<PlanKey, Plan> m_plans; ///< The previously solved frequency plans
 };
 
 } // namespace lime
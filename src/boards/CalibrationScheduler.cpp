@@ -0,0 +1,56 @@
+#include "CalibrationScheduler.h"
+
+#include "Logger.h"
+
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+using namespace lime;
+
+std::size_t CalibrationScheduler::AddTask(uint32_t busId, Task task)
+{
+    mJobs.push_back({ busId, std::move(task) });
+    return mJobs.size() - 1;
+}
+
+std::vector<OpStatus> CalibrationScheduler::Run()
+{
+    std::vector<Job> jobs;
+    jobs.swap(mJobs);
+    std::vector<OpStatus> results(jobs.size(), OpStatus::ERROR);
+
+    std::map<uint32_t, std::vector<std::size_t>> queues;
+    for (std::size_t i = 0; i < jobs.size(); ++i)
+        queues[jobs[i].busId].push_back(i);
+
+    // each worker owns a distinct set of result slots, so no locking is needed
+    auto runQueue = [&jobs, &results](const std::vector<std::size_t>& queue) {
+        for (std::size_t index : queue)
+        {
+            try
+            {
+                results[index] = jobs[index].task();
+            } catch (std::exception& e)
+            {
+                results[index] = ReportError(OpStatus::ERROR, "Calibration task %i failed: %s", static_cast<int>(index), e.what());
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    auto queue = queues.begin();
+    if (queue == queues.end())
+        return results;
+
+    for (auto iter = std::next(queue); iter != queues.end(); ++iter)
+        workers.emplace_back(runQueue, std::cref(iter->second));
+
+    // the calling thread services the first bus instead of idling
+    runQueue(queue->second);
+
+    for (auto& worker : workers)
+        worker.join();
+    return results;
+}
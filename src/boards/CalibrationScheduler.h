@@ -0,0 +1,47 @@
+#ifndef LIME_CALIBRATIONSCHEDULER_H
+#define LIME_CALIBRATIONSCHEDULER_H
+
+#include "limesuite/config.h"
+#include "limesuite/OpStatus.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace lime {
+
+/** @brief Runs calibration tasks of multiple chips concurrently.
+
+  Every task is assigned to a control bus. Tasks sharing a bus are executed one after another
+  in the order they were added, tasks on different buses are executed in parallel.
+ */
+class LIME_API CalibrationScheduler
+{
+  public:
+    typedef std::function<OpStatus()> Task;
+
+    /**
+      @brief Queues a task for execution.
+      @param busId The identifier of the control bus the task uses.
+      @param task The task to execute.
+      @return The index of the task's result in the vector returned by Run().
+     */
+    std::size_t AddTask(uint32_t busId, Task task);
+
+    /**
+      @brief Executes all of the queued tasks and clears the queue.
+      @return The statuses of the tasks, in the order they were added.
+     */
+    std::vector<OpStatus> Run();
+
+  private:
+    struct Job {
+        uint32_t busId;
+        Task task;
+    };
+    std::vector<Job> mJobs;
+};
+
+} // namespace lime
+
+#endif // LIME_CALIBRATIONSCHEDULER_H
@@ -1,32 +1,85 @@
 #include "limesuite/DeviceRegistry.h"
 #include "limesuite/SDRDevice.h"
 #include "Logger.h"
+#include <chrono>
+#include <future>
 #include <mutex>
 #include <map>
 #include <memory>
 #include <iostream>
+#include <iterator>
+#include <shared_mutex>
 #include <iso646.h> // alternative operators for visual c++: not, and, or...
 
 using namespace lime;
 using namespace std::literals::string_literals;
 
-static std::mutex gRegistryMutex;
+// Entries are only added and removed while loading or unloading board support,
+// so lookups share the lock and never wait for each other.
+static std::shared_mutex gRegistryMutex;
 static std::map<std::string, DeviceRegistryEntry*> registryEntries;
 
+/// @brief Results of a single entry's discovery for a particular hint.
+struct CachedEnumeration {
+    std::chrono::steady_clock::time_point timestamp;
+    std::vector<DeviceHandle> handles;
+};
+
+static constexpr std::chrono::milliseconds enumerationCacheTTL(2000);
+static std::mutex gCacheMutex;
+// key: entry name and serialized hint
+static std::map<std::pair<std::string, std::string>, CachedEnumeration> enumerationCache;
+// key: serialized handle, value: name of the entry which discovered it
+static std::map<std::string, std::string> handleOwners;
+
 void __loadBoardSupport();
 
+/// @brief Runs the discovery of a single entry, or returns its recent results for the same hint.
+static std::vector<DeviceHandle> EnumerateEntry(const std::string& name, DeviceRegistryEntry* entry, const DeviceHandle& hint)
+{
+    const auto key = std::make_pair(name, hint.Serialize());
+    {
+        std::lock_guard<std::mutex> lock(gCacheMutex);
+        auto iter = enumerationCache.find(key);
+        if (iter != enumerationCache.end() && std::chrono::steady_clock::now() - iter->second.timestamp < enumerationCacheTTL)
+            return iter->second.handles;
+    }
+
+    std::vector<DeviceHandle> handles = entry->enumerate(hint);
+
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    enumerationCache[key] = { std::chrono::steady_clock::now(), handles };
+    for (const auto& handle : handles)
+        handleOwners[handle.Serialize()] = name;
+    return handles;
+}
+
+/// @brief Probes all of the registered entries concurrently, results are ordered the same as the entries.
+/// @note The caller must hold gRegistryMutex.
+static std::vector<std::pair<DeviceRegistryEntry*, std::vector<DeviceHandle>>> EnumerateAllEntries(const DeviceHandle& hint)
+{
+    std::vector<std::pair<DeviceRegistryEntry*, std::future<std::vector<DeviceHandle>>>> probes;
+    for (const auto& entry : registryEntries)
+        probes.emplace_back(entry.second, std::async(std::launch::async, EnumerateEntry, entry.first, entry.second, hint));
+
+    std::vector<std::pair<DeviceRegistryEntry*, std::vector<DeviceHandle>>> results;
+    for (auto& probe : probes)
+        results.emplace_back(probe.first, probe.second.get());
+    return results;
+}
+
 /*******************************************************************
  * Registry implementation
  ******************************************************************/
 std::vector<DeviceHandle> DeviceRegistry::enumerate(const DeviceHandle& hint)
 {
     __loadBoardSupport();
-    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    std::shared_lock<std::shared_mutex> lock(gRegistryMutex);
 
     std::vector<DeviceHandle> results;
-    for (const auto& entry : registryEntries)
+    for (const auto& entry : EnumerateAllEntries(hint))
     {
-        for (auto handle : entry.second->enumerate(hint))
+        for (auto handle : entry.second)
             results.push_back(handle);
     }
     return results;
@@ -35,18 +88,30 @@ std::vector<DeviceHandle> DeviceRegistry::enumerate(const DeviceHandle& hint)
 SDRDevice* DeviceRegistry::makeDevice(const DeviceHandle& handle)
 {
     __loadBoardSupport();
-    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    std::shared_lock<std::shared_mutex> lock(gRegistryMutex);
+
+    //handles returned by a previous discovery go directly to the factory that found them
+    {
+        std::unique_lock<std::mutex> cacheLock(gCacheMutex);
+        auto owner = handleOwners.find(handle.Serialize());
+        if (owner != handleOwners.end())
+        {
+            auto entry = registryEntries.find(owner->second);
+            cacheLock.unlock();
+            if (entry != registryEntries.end())
+                return entry->second->make(handle);
+        }
+    }
 
     //use the identifier as a hint to perform a discovery
     //only identifiers from the discovery function itself is used in the factory
-    for (const auto& entry : registryEntries)
+    for (const auto& entry : EnumerateAllEntries(handle))
     {
-        const auto r = entry.second->enumerate(handle);
-        if (r.empty())
+        if (entry.second.empty())
             continue;
 
-        auto realHandle = r.front(); //just pick the first
-        return entry.second->make(realHandle);
+        auto realHandle = entry.second.front(); //just pick the first
+        return entry.first->make(realHandle);
     }
 
     const std::string reason = "No devices found with given handle (" + handle.Serialize() + ")";
@@ -55,13 +120,20 @@ SDRDevice* DeviceRegistry::makeDevice(const DeviceHandle& handle)
     return nullptr;
 }
 
+void DeviceRegistry::invalidateCache(void)
+{
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    enumerationCache.clear();
+    handleOwners.clear();
+}
+
 void DeviceRegistry::freeDevice(SDRDevice* device)
 {
     //some client code may end up freeing a null connection
     if (device == nullptr)
         return;
 
-    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    std::shared_lock<std::shared_mutex> lock(gRegistryMutex);
 
     delete device;
 }
@@ -70,7 +142,7 @@ std::vector<std::string> DeviceRegistry::moduleNames(void)
 {
     __loadBoardSupport();
     std::vector<std::string> names;
-    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    std::shared_lock<std::shared_mutex> lock(gRegistryMutex);
     for (const auto& entry : registryEntries)
         names.push_back(entry.first);
     return names;
@@ -82,14 +154,20 @@ std::vector<std::string> DeviceRegistry::moduleNames(void)
 DeviceRegistryEntry::DeviceRegistryEntry(const std::string& name)
     : _name(name)
 {
-    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    std::unique_lock<std::shared_mutex> lock(gRegistryMutex);
     registryEntries[_name] = this;
     lime::debug("DeviceRegistry Added: "s + _name);
 }
 
 DeviceRegistryEntry::~DeviceRegistryEntry(void)
 {
-    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    std::unique_lock<std::shared_mutex> lock(gRegistryMutex);
     registryEntries.erase(_name);
+
+    std::lock_guard<std::mutex> cacheLock(gCacheMutex);
+    for (auto iter = enumerationCache.begin(); iter != enumerationCache.end();)
+        iter = iter->first.first == _name ? enumerationCache.erase(iter) : std::next(iter);
+    for (auto iter = handleOwners.begin(); iter != handleOwners.end();)
+        iter = iter->second == _name ? handleOwners.erase(iter) : std::next(iter);
     lime::debug("DeviceRegistry Removed: "s + _name);
 }
@@ -1,19 +1,24 @@
 #include "LMS7002M_SDRDevice.h"
 
+#include "CalibrationScheduler.h"
+#include "CommonFunctions.h"
 #include "DeviceExceptions.h"
 #include "FPGA_common.h"
 #include "limesuite/LMS7002M.h"
+#include "lms7002m/ChannelScope.h"
 #include "mcu_program/common_src/lms7002m_calibrations.h"
 #include "mcu_program/common_src/lms7002m_filters.h"
 #include "lms7002m/MCU_BD.h"
 #include "LMSBoards.h"
 #include "Logger.h"
 #include "TRXLooper.h"
+#include "TimedCommandScheduler.h"
 
 #include <algorithm>
 #include <array>
 #include <cmath>
 #include <complex>
+#include <mutex>
 
 namespace lime {
 
@@ -65,6 +70,8 @@ LMS7002M_SDRDevice::LMS7002M_SDRDevice()
 
 LMS7002M_SDRDevice::~LMS7002M_SDRDevice()
 {
+    DeleteCommandSchedulers();
+
     for (LMS7002M* soc : mLMSChips)
     {
         if (soc != nullptr)
@@ -95,6 +102,7 @@ LMS7002M_SDRDevice::~LMS7002M_SDRDevice()
 
 OpStatus LMS7002M_SDRDevice::EnableChannel(uint8_t moduleIndex, TRXDir trx, uint8_t channel, bool enable)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
     return lms->EnableChannel(trx, channel % 2, enable);
 }
@@ -116,6 +124,7 @@ const SDRDevice::Descriptor& LMS7002M_SDRDevice::GetDescriptor() const
 
 OpStatus LMS7002M_SDRDevice::Reset()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     OpStatus status;
     for (auto iter : mLMSChips)
     {
@@ -126,6 +135,13 @@ OpStatus LMS7002M_SDRDevice::Reset()
     return OpStatus::SUCCESS;
 }
 
+/// @brief Forgets the MCU programs known to be loaded, after a hardware reset of the chips.
+void LMS7002M_SDRDevice::InvalidateMCUPrograms()
+{
+    for (auto chip : mLMSChips)
+        chip->GetMCUControls()->InvalidateLoadedProgram();
+}
+
 OpStatus LMS7002M_SDRDevice::GetGPSLock(GPS_Lock* status)
 {
     uint16_t regValue = mFPGA->ReadRegister(0x114);
@@ -139,6 +155,7 @@ OpStatus LMS7002M_SDRDevice::GetGPSLock(GPS_Lock* status)
 
 double LMS7002M_SDRDevice::GetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (moduleIndex >= mLMSChips.size())
     {
         ReportError(OpStatus::OUT_OF_RANGE, "GetSample rate invalid module index (%i)", moduleIndex);
@@ -149,6 +166,7 @@ double LMS7002M_SDRDevice::GetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_
 
 double LMS7002M_SDRDevice::GetFrequency(uint8_t moduleIndex, TRXDir trx, uint8_t channel)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
 
     // TODO:
@@ -167,6 +185,7 @@ double LMS7002M_SDRDevice::GetFrequency(uint8_t moduleIndex, TRXDir trx, uint8_t
 
 OpStatus LMS7002M_SDRDevice::SetFrequency(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double frequency)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
 
     int chA = channel & (~1);
@@ -266,6 +285,7 @@ double LMS7002M_SDRDevice::GetNCOOffset(uint8_t moduleIndex, TRXDir trx, uint8_t
 
 double LMS7002M_SDRDevice::GetNCOFrequency(uint8_t moduleIndex, TRXDir trx, uint8_t channel, uint8_t index)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
 
     lms->SetActiveChannel(channel == 0 ? LMS7002M::Channel::ChA : LMS7002M::Channel::ChB);
@@ -282,6 +302,7 @@ double LMS7002M_SDRDevice::GetNCOFrequency(uint8_t moduleIndex, TRXDir trx, uint
 OpStatus LMS7002M_SDRDevice::SetNCOFrequency(
     uint8_t moduleIndex, TRXDir trx, uint8_t channel, uint8_t index, double frequency, double phaseOffset)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (index > 15)
         return ReportError(OpStatus::OUT_OF_RANGE, "%s NCO%i index invalid", ToCString(trx), index);
 
@@ -330,6 +351,7 @@ double LMS7002M_SDRDevice::GetLowPassFilter(uint8_t moduleIndex, TRXDir trx, uin
 
 OpStatus LMS7002M_SDRDevice::SetLowPassFilter(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double lpf)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
 
     LMS7002M::Channel ch = channel == 0 ? LMS7002M::Channel::ChA : LMS7002M::Channel::ChB;
@@ -375,6 +397,7 @@ OpStatus LMS7002M_SDRDevice::SetLowPassFilter(uint8_t moduleIndex, TRXDir trx, u
 
 uint8_t LMS7002M_SDRDevice::GetAntenna(uint8_t moduleIndex, TRXDir trx, uint8_t channel)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
 
     if (trx == TRXDir::Tx)
@@ -389,6 +412,7 @@ uint8_t LMS7002M_SDRDevice::GetAntenna(uint8_t moduleIndex, TRXDir trx, uint8_t
 
 OpStatus LMS7002M_SDRDevice::SetAntenna(uint8_t moduleIndex, TRXDir trx, uint8_t channel, uint8_t path)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (path >= mDeviceDescriptor.rfSOC.at(0).pathNames.size())
     {
         path = trx == TRXDir::Tx ? 1 : 2; // Default settings: Rx: LNAL, Tx: Band1
@@ -401,26 +425,84 @@ OpStatus LMS7002M_SDRDevice::SetAntenna(uint8_t moduleIndex, TRXDir trx, uint8_t
 
 OpStatus LMS7002M_SDRDevice::Calibrate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double bandwidth)
 {
-    lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
+    std::vector<CalibrationRequest> requests{ { moduleIndex, trx, channel, bandwidth, OpStatus::SUCCESS } };
+    return CalibrateChannels(requests);
+}
+
+/// @brief Runs a single calibration request, the caller has to hold the control mutex.
+/// @param request The calibration to run, receives the description of the failure.
+/// @return The status of the operation.
+OpStatus LMS7002M_SDRDevice::CalibrateChannel(CalibrationRequest& request)
+{
+    lime::LMS7002M* lms = mLMSChips.at(request.moduleIndex);
+    const uint8_t channel = request.channel;
+    const char* dirName = request.trx == TRXDir::Rx ? "Rx" : "Tx";
     lms->SetActiveChannel(static_cast<LMS7002M::Channel>((channel % 2) + 1));
-    OpStatus ret;
-    auto reg20 = lms->SPI_read(0x20);
-    lms->SPI_write(0x20, reg20 | (20 << (channel % 2)));
-    if (trx == TRXDir::Tx)
+
+    if (request.procedure == CalibrationProcedure::DCIQ)
+    {
+        OpStatus ret;
+        auto reg20 = lms->SPI_read(0x20);
+        lms->SPI_write(0x20, reg20 | (20 << (channel % 2)));
+        if (request.trx == TRXDir::Tx)
+        {
+            ret = lms->CalibrateTx(request.bandwidth, false);
+        }
+        else
+        {
+            ret = lms->CalibrateRx(request.bandwidth, false);
+        }
+        lms->SPI_write(0x20, reg20);
+        if (ret != OpStatus::SUCCESS)
+            request.error = strFormat("%s ch%i DC/IQ calibration failed", dirName, channel);
+        return ret;
+    }
+
+    // the host side calibrations keep the chip of the calling thread only, so the chips can run in parallel
+    SetupCalibrations(lms, request.bandwidth);
+    int status;
+    if (request.procedure == CalibrationProcedure::HostDCIQ)
     {
-        ret = lms->CalibrateTx(bandwidth, false);
+        status = request.trx == TRXDir::Rx ? CalibrateRx(false, false) : CalibrateTx(false);
+        if (status != MCU_BD::MCU_NO_ERROR)
+            request.error = strFormat("%s ch%i DC/IQ calibration failed: %s", dirName, channel, MCU_BD::MCUStatusMessage(status));
     }
     else
     {
-        ret = lms->CalibrateRx(bandwidth, false);
+        status = request.trx == TRXDir::Rx ? TuneRxFilter(request.lowPassFilter) : TuneTxFilter(request.lowPassFilter);
+        if (status != MCU_BD::MCU_NO_ERROR)
+            request.error = strFormat("%s ch%i filter calibration failed: %s", dirName, channel, MCU_BD::MCUStatusMessage(status));
     }
-    lms->SPI_write(0x20, reg20);
-    return ret;
+    return status == MCU_BD::MCU_NO_ERROR ? OpStatus::SUCCESS : OpStatus::ERROR;
+}
+
+OpStatus LMS7002M_SDRDevice::CalibrateChannels(std::vector<CalibrationRequest>& requests)
+{
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
+    CalibrationScheduler scheduler;
+    for (CalibrationRequest& request : requests)
+    {
+        if (request.moduleIndex >= mLMSChips.size())
+            return ReportError(OpStatus::OUT_OF_RANGE, "Calibration: invalid module index %i", request.moduleIndex);
+        // the worker threads run under the lock held by this thread
+        scheduler.AddTask(GetCalibrationBusId(request.moduleIndex), [this, &request]() { return CalibrateChannel(request); });
+    }
+
+    const std::vector<OpStatus> results = scheduler.Run();
+    OpStatus status = OpStatus::SUCCESS;
+    for (std::size_t i = 0; i < requests.size(); ++i)
+    {
+        requests[i].status = results[i];
+        if (status == OpStatus::SUCCESS)
+            status = results[i];
+    }
+    return status;
 }
 
 OpStatus LMS7002M_SDRDevice::ConfigureGFIR(
     uint8_t moduleIndex, TRXDir trx, uint8_t channel, ChannelConfig::Direction::GFIRFilter settings)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     LMS7002M* lms = mLMSChips.at(moduleIndex);
     LMS7002M::Channel enumChannel = channel > 0 ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA;
 
@@ -429,6 +511,7 @@ OpStatus LMS7002M_SDRDevice::ConfigureGFIR(
 
 OpStatus LMS7002M_SDRDevice::SetGain(uint8_t moduleIndex, TRXDir direction, uint8_t channel, eGainTypes gain, double value)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto device = mLMSChips.at(moduleIndex);
     LMS7002M::Channel enumChannel = channel > 0 ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA;
 
@@ -526,6 +609,7 @@ OpStatus LMS7002M_SDRDevice::SetGenericRxGain(lime::LMS7002M* device, LMS7002M::
 
 OpStatus LMS7002M_SDRDevice::GetGain(uint8_t moduleIndex, TRXDir direction, uint8_t channel, eGainTypes gain, double& value)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto device = mLMSChips.at(moduleIndex);
     LMS7002M::Channel enumChannel = channel > 0 ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA;
 
@@ -582,6 +666,7 @@ OpStatus LMS7002M_SDRDevice::GetGain(uint8_t moduleIndex, TRXDir direction, uint
 
 bool LMS7002M_SDRDevice::GetDCOffsetMode(uint8_t moduleIndex, TRXDir trx, uint8_t channel)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (trx == TRXDir::Rx)
     {
         auto lms = mLMSChips.at(moduleIndex);
@@ -593,6 +678,7 @@ bool LMS7002M_SDRDevice::GetDCOffsetMode(uint8_t moduleIndex, TRXDir trx, uint8_
 
 OpStatus LMS7002M_SDRDevice::SetDCOffsetMode(uint8_t moduleIndex, TRXDir trx, uint8_t channel, bool isAutomatic)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (trx == TRXDir::Tx)
         return OpStatus::NOT_SUPPORTED;
 
@@ -602,6 +688,7 @@ OpStatus LMS7002M_SDRDevice::SetDCOffsetMode(uint8_t moduleIndex, TRXDir trx, ui
 
 complex64f_t LMS7002M_SDRDevice::GetDCOffset(uint8_t moduleIndex, TRXDir trx, uint8_t channel)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     double I = 0.0;
     double Q = 0.0;
 
@@ -613,6 +700,7 @@ complex64f_t LMS7002M_SDRDevice::GetDCOffset(uint8_t moduleIndex, TRXDir trx, ui
 
 OpStatus LMS7002M_SDRDevice::SetDCOffset(uint8_t moduleIndex, TRXDir trx, uint8_t channel, const complex64f_t& offset)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     lms->Modify_SPI_Reg_bits(LMS7param(MAC), (channel % 2) + 1);
     return lms->SetDCOffset(trx, offset.real(), offset.imag());
@@ -620,6 +708,7 @@ OpStatus LMS7002M_SDRDevice::SetDCOffset(uint8_t moduleIndex, TRXDir trx, uint8_
 
 complex64f_t LMS7002M_SDRDevice::GetIQBalance(uint8_t moduleIndex, TRXDir trx, uint8_t channel)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     lms->Modify_SPI_Reg_bits(LMS7param(MAC), (channel % 2) + 1);
 
@@ -631,6 +720,7 @@ complex64f_t LMS7002M_SDRDevice::GetIQBalance(uint8_t moduleIndex, TRXDir trx, u
 
 OpStatus LMS7002M_SDRDevice::SetIQBalance(uint8_t moduleIndex, TRXDir trx, uint8_t channel, const complex64f_t& balance)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     std::complex<double> bal{ balance.real(), balance.imag() };
     double gain = std::abs(bal);
 
@@ -653,24 +743,28 @@ OpStatus LMS7002M_SDRDevice::SetIQBalance(uint8_t moduleIndex, TRXDir trx, uint8
 
 bool LMS7002M_SDRDevice::GetCGENLocked(uint8_t moduleIndex)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     return lms->GetCGENLocked();
 }
 
 double LMS7002M_SDRDevice::GetTemperature(uint8_t moduleIndex)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     return lms->GetTemperature();
 }
 
 bool LMS7002M_SDRDevice::GetSXLocked(uint8_t moduleIndex, TRXDir trx)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     return lms->GetSXLocked(trx);
 }
 
 unsigned int LMS7002M_SDRDevice::ReadRegister(uint8_t moduleIndex, unsigned int address, bool useFPGA)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (useFPGA)
     {
         return ReadFPGARegister(address);
@@ -685,23 +779,27 @@ OpStatus LMS7002M_SDRDevice::WriteRegister(uint8_t moduleIndex, unsigned int add
     if (useFPGA)
         return WriteFPGARegister(address, value);
 
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     return mLMSChips.at(moduleIndex)->SPI_write(address, value);
 }
 
 OpStatus LMS7002M_SDRDevice::LoadConfig(uint8_t moduleIndex, const std::string& filename)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     return lms->LoadConfig(filename);
 }
 
 OpStatus LMS7002M_SDRDevice::SaveConfig(uint8_t moduleIndex, const std::string& filename)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     return lms->SaveConfig(filename);
 }
 
 uint16_t LMS7002M_SDRDevice::GetParameter(uint8_t moduleIndex, uint8_t channel, const std::string& parameterKey)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     lms->SetActiveChannel(channel % 2 == 0 ? LMS7002M::Channel::ChA : LMS7002M::Channel::ChB);
 
@@ -717,6 +815,7 @@ uint16_t LMS7002M_SDRDevice::GetParameter(uint8_t moduleIndex, uint8_t channel,
 
 OpStatus LMS7002M_SDRDevice::SetParameter(uint8_t moduleIndex, uint8_t channel, const std::string& parameterKey, uint16_t value)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     lms->SetActiveChannel(channel % 2 == 0 ? LMS7002M::Channel::ChA : LMS7002M::Channel::ChB);
     return lms->Modify_SPI_Reg_bits(lms->GetParam(parameterKey), value);
@@ -724,6 +823,7 @@ OpStatus LMS7002M_SDRDevice::SetParameter(uint8_t moduleIndex, uint8_t channel,
 
 uint16_t LMS7002M_SDRDevice::GetParameter(uint8_t moduleIndex, uint8_t channel, uint16_t address, uint8_t msb, uint8_t lsb)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     lms->SetActiveChannel(channel % 2 == 0 ? LMS7002M::Channel::ChA : LMS7002M::Channel::ChB);
 
@@ -741,6 +841,7 @@ uint16_t LMS7002M_SDRDevice::GetParameter(uint8_t moduleIndex, uint8_t channel,
 OpStatus LMS7002M_SDRDevice::SetParameter(
     uint8_t moduleIndex, uint8_t channel, uint16_t address, uint8_t msb, uint8_t lsb, uint16_t value)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     auto lms = mLMSChips.at(moduleIndex);
     lms->SetActiveChannel(channel % 2 == 0 ? LMS7002M::Channel::ChA : LMS7002M::Channel::ChB);
     return lms->Modify_SPI_Reg_bits(address, msb, lsb, value);
@@ -748,6 +849,7 @@ OpStatus LMS7002M_SDRDevice::SetParameter(
 
 OpStatus LMS7002M_SDRDevice::Synchronize(bool toChip)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     OpStatus status = OpStatus::SUCCESS;
     for (auto iter : mLMSChips)
     {
@@ -792,6 +894,7 @@ OpStatus LMS7002M_SDRDevice::SetTestSignal(uint8_t moduleIndex,
     int16_t dc_i,
     int16_t dc_q)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
 
     bool div4 = signalConfiguration.divide == SDRDevice::ChannelConfig::Direction::TestSignal::Divide::Div4;
@@ -824,6 +927,7 @@ OpStatus LMS7002M_SDRDevice::SetTestSignal(uint8_t moduleIndex,
 SDRDevice::ChannelConfig::Direction::TestSignal LMS7002M_SDRDevice::GetTestSignal(
     uint8_t moduleIndex, TRXDir direction, uint8_t channel)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
     ChannelConfig::Direction::TestSignal signalConfiguration;
 
@@ -874,6 +978,7 @@ SDRDevice::ChannelConfig::Direction::TestSignal LMS7002M_SDRDevice::GetTestSigna
 
 std::vector<double> LMS7002M_SDRDevice::GetGFIRCoefficients(uint8_t moduleIndex, TRXDir trx, uint8_t channel, uint8_t gfirID)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
 
     const uint8_t count = gfirID == 2 ? 120 : 40;
@@ -887,12 +992,14 @@ std::vector<double> LMS7002M_SDRDevice::GetGFIRCoefficients(uint8_t moduleIndex,
 OpStatus LMS7002M_SDRDevice::SetGFIRCoefficients(
     uint8_t moduleIndex, TRXDir trx, uint8_t channel, uint8_t gfirID, std::vector<double> coefficients)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
     return lms->SetGFIRCoefficients(trx, gfirID, coefficients.data(), coefficients.size());
 }
 
 OpStatus LMS7002M_SDRDevice::SetGFIR(uint8_t moduleIndex, TRXDir trx, uint8_t channel, uint8_t gfirID, bool enabled)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips.at(moduleIndex);
 
     if (gfirID > 2)
@@ -926,6 +1033,8 @@ void LMS7002M_SDRDevice::StreamStop(uint8_t moduleIndex)
         return;
     }
 
+    // the scheduler reads the timestamp from the streamer
+    DeleteCommandScheduler(moduleIndex);
     mStreamers.at(moduleIndex)->Stop();
 
     if (mStreamers.at(moduleIndex) != nullptr)
@@ -936,6 +1045,93 @@ void LMS7002M_SDRDevice::StreamStop(uint8_t moduleIndex)
     mStreamers[moduleIndex] = nullptr;
 }
 
+OpStatus LMS7002M_SDRDevice::ScheduleCommand(uint8_t moduleIndex, const TimedCommand& command)
+{
+    std::lock_guard<std::recursive_mutex> lock(mCommandSchedulersMutex);
+    if (moduleIndex >= mStreamers.size() || mStreamers[moduleIndex] == nullptr)
+        return ReportError(OpStatus::INVALID_VALUE, "Timed commands require the stream of module %i to be set up", moduleIndex);
+
+    if (mCommandSchedulers.size() < mStreamers.size())
+        mCommandSchedulers.resize(mStreamers.size(), nullptr);
+
+    if (mCommandSchedulers[moduleIndex] == nullptr)
+    {
+        // the scheduler is deleted before the streamer is, see DeleteCommandScheduler()
+        TRXLooper* streamer = mStreamers[moduleIndex];
+        mCommandSchedulers[moduleIndex] = new TimedCommandScheduler(
+            [streamer]() { return streamer->GetHardwareTimestamp(); },
+            [this, moduleIndex](const TimedCommand& cmd) { return ExecuteTimedCommand(moduleIndex, cmd); },
+            GetSampleRate(moduleIndex, TRXDir::Rx, 0));
+    }
+    return mCommandSchedulers[moduleIndex]->Schedule(command);
+}
+
+void LMS7002M_SDRDevice::CancelScheduledCommands(uint8_t moduleIndex)
+{
+    std::lock_guard<std::recursive_mutex> lock(mCommandSchedulersMutex);
+    if (moduleIndex < mCommandSchedulers.size() && mCommandSchedulers[moduleIndex] != nullptr)
+        mCommandSchedulers[moduleIndex]->CancelAll();
+}
+
+OpStatus LMS7002M_SDRDevice::ExecuteTimedCommand(uint8_t moduleIndex, const TimedCommand& command)
+{
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
+    switch (command.type)
+    {
+    case TimedCommand::Type::Frequency:
+        return SetFrequency(moduleIndex, command.trx, command.channel, command.value);
+    case TimedCommand::Type::Gain:
+        return SetGain(moduleIndex, command.trx, command.channel, command.gainType, command.value);
+    case TimedCommand::Type::NCOIndex: {
+        if (command.ncoIndex > 15)
+            return ReportError(OpStatus::OUT_OF_RANGE, "%s NCO%i index invalid", ToCString(command.trx), command.ncoIndex);
+        LMS7002M* lms = mLMSChips.at(moduleIndex);
+        ChannelScope scope(lms, IntToChannel(command.channel), true);
+        return lms->Modify_SPI_Reg_bits(command.trx == TRXDir::Tx ? LMS7_SEL_TX : LMS7_SEL_RX, command.ncoIndex);
+    }
+    case TimedCommand::Type::Registers: {
+        std::vector<uint16_t> addrs;
+        std::vector<uint16_t> values;
+        addrs.reserve(command.registers.size());
+        values.reserve(command.registers.size());
+        for (const auto& reg : command.registers)
+        {
+            addrs.push_back(reg.first);
+            values.push_back(reg.second);
+        }
+        return mLMSChips.at(moduleIndex)->SPI_write_batch(addrs.data(), values.data(), addrs.size(), true);
+    }
+    }
+    return ReportError(OpStatus::INVALID_VALUE, "Unknown timed command type");
+}
+
+void LMS7002M_SDRDevice::DeleteCommandScheduler(uint8_t moduleIndex)
+{
+    TimedCommandScheduler* scheduler = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mCommandSchedulersMutex);
+        if (moduleIndex >= mCommandSchedulers.size())
+            return;
+        std::swap(scheduler, mCommandSchedulers[moduleIndex]);
+    }
+    // deleted unlocked, the command being executed might be scheduling the next one
+    delete scheduler;
+}
+
+/// @brief Stops and joins the command schedulers of every module.
+/// Has to be called before the streamers or the chips the commands use are deleted,
+/// including from the destructors of the derived devices.
+void LMS7002M_SDRDevice::DeleteCommandSchedulers()
+{
+    std::size_t count = 0;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mCommandSchedulersMutex);
+        count = mCommandSchedulers.size();
+    }
+    for (std::size_t i = 0; i < count; ++i)
+        DeleteCommandScheduler(i);
+}
+
 uint32_t LMS7002M_SDRDevice::StreamRx(uint8_t moduleIndex, complex32f_t* const* dest, uint32_t count, StreamMeta* meta)
 {
     return mStreamers[moduleIndex]->StreamRx(dest, count, meta);
@@ -1006,6 +1202,7 @@ OpStatus LMS7002M_SDRDevice::UpdateFPGAInterfaceFrequency(LMS7002M& soc, FPGA& f
         fpgaRxPLL /= std::pow(2, dec + siso);
     }
 
+    fpga.UpdateCGENConfigurationCount(chipIndex, soc.GetCGENConfigurationCount());
     OpStatus status = fpga.SetInterfaceFreq(fpgaTxPLL, fpgaRxPLL, chipIndex);
     if (status != OpStatus::SUCCESS)
         return status;
@@ -2,6 +2,7 @@
 #define LIME_LMS7002M_SDRDevice_H
 
 #include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include "limesuite/SDRDevice.h"
@@ -10,6 +11,7 @@
 namespace lime {
 
 class TRXLooper;
+class TimedCommandScheduler;
 class FPGA;
 
 /** @brief Base class for device with multiple LMS7002M chips and FPGA */
@@ -82,6 +84,33 @@ class LIME_API LMS7002M_SDRDevice : public SDRDevice
         uint8_t moduleIndex, uint8_t channel, uint16_t address, uint8_t msb, uint8_t lsb, uint16_t value) override;
 
     virtual OpStatus Calibrate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double bandwidth) override;
+
+    /** @brief The procedures a calibration request can run. */
+    enum class CalibrationProcedure : uint8_t {
+        DCIQ, ///< DC/IQ calibration by the chip's MCU, as done by Calibrate().
+        HostDCIQ, ///< DC/IQ calibration by the host side port of the MCU calibrations, as done by Configure().
+        HostLowPassFilter, ///< Low pass filter tuning by the host side port of the MCU calibrations.
+    };
+
+    /** @brief Single channel calibration request and its outcome. */
+    struct CalibrationRequest {
+        uint8_t moduleIndex; ///< The device index to calibrate.
+        TRXDir trx; ///< The direction of the channel to calibrate.
+        uint8_t channel; ///< The channel to calibrate.
+        double bandwidth; ///< The bandwidth of the channel to calibrate for (in Hz).
+        OpStatus status; ///< The result of the calibration, filled in by CalibrateChannels().
+        CalibrationProcedure procedure = CalibrationProcedure::DCIQ; ///< The procedure to run.
+        double lowPassFilter = 0; ///< The bandwidth to tune the low pass filter to (in Hz), for HostLowPassFilter.
+        std::string error; ///< The description of the failure, filled in by CalibrateChannels().
+    };
+
+    /**
+      @brief Calibrates multiple channels, chips on independent control buses are calibrated concurrently.
+      @param requests The channels to calibrate, each entry receives its own result.
+      @return OpStatus::SUCCESS if all of the calibrations succeeded, status of the first failure otherwise.
+     */
+    OpStatus CalibrateChannels(std::vector<CalibrationRequest>& requests);
+
     virtual OpStatus ConfigureGFIR(
         uint8_t moduleIndex, TRXDir trx, uint8_t channel, ChannelConfig::Direction::GFIRFilter settings) override;
 
@@ -99,6 +128,9 @@ class LIME_API LMS7002M_SDRDevice : public SDRDevice
     virtual void StreamStart(uint8_t moduleIndex) override;
     virtual void StreamStop(uint8_t moduleIndex) override;
 
+    virtual OpStatus ScheduleCommand(uint8_t moduleIndex, const TimedCommand& command) override;
+    virtual void CancelScheduledCommands(uint8_t moduleIndex) override;
+
     virtual uint32_t StreamRx(uint8_t moduleIndex, complex32f_t* const* samples, uint32_t count, StreamMeta* meta) override;
     virtual uint32_t StreamRx(uint8_t moduleIndex, complex16_t* const* samples, uint32_t count, StreamMeta* meta) override;
     virtual uint32_t StreamRx(uint8_t moduleIndex, complex12_t* const* samples, uint32_t count, StreamMeta* meta) override;
@@ -125,17 +157,34 @@ class LIME_API LMS7002M_SDRDevice : public SDRDevice
 
   protected:
     static OpStatus UpdateFPGAInterfaceFrequency(LMS7002M& soc, FPGA& fpga, uint8_t chipIndex);
+
+    /**
+      @brief Gets the control bus of the given module for calibration scheduling.
+      Modules reporting the same bus are calibrated one after another.
+      @param moduleIndex The device index.
+      @return The identifier of the module's control bus.
+     */
+    virtual uint32_t GetCalibrationBusId(uint8_t moduleIndex) const { return 0; }
     void SetGainInformationInDescriptor(RFSOCDescriptor& descriptor);
 
     OpStatus LMS7002LOConfigure(LMS7002M* chip, const SDRDevice::SDRConfig& config);
     OpStatus LMS7002ChannelConfigure(LMS7002M* chip, const SDRDevice::ChannelConfig& config, uint8_t channelIndex);
     OpStatus LMS7002ChannelCalibration(LMS7002M* chip, const SDRDevice::ChannelConfig& config, uint8_t channelIndex);
     OpStatus LMS7002TestSignalConfigure(LMS7002M* chip, const SDRDevice::ChannelConfig& config, uint8_t channelIndex);
+    OpStatus CalibrateChannel(CalibrationRequest& request);
+    OpStatus ExecuteTimedCommand(uint8_t moduleIndex, const TimedCommand& command);
+    void DeleteCommandScheduler(uint8_t moduleIndex);
+    void DeleteCommandSchedulers();
+    void InvalidateMCUPrograms();
 
     DataCallbackType mCallback_logData;
     LogCallbackType mCallback_logMessage;
     std::vector<LMS7002M*> mLMSChips;
     std::vector<TRXLooper*> mStreamers;
+    std::vector<TimedCommandScheduler*> mCommandSchedulers;
+    std::recursive_mutex mCommandSchedulersMutex; ///< Guards the creation and removal of the command schedulers.
+    /// Serializes the entry points that select a channel or access the chips, between the callers and the timed command threads.
+    std::recursive_mutex mControlMutex;
 
     Descriptor mDeviceDescriptor;
     StreamConfig mStreamConfig;
@@ -192,6 +192,7 @@ LimeSDR::LimeSDR(std::shared_ptr<IComms> spiLMS,
 
 LimeSDR::~LimeSDR()
 {
+    DeleteCommandSchedulers();
     auto& streamer = mStreamers.at(0);
     if (streamer != nullptr && streamer->IsStreamRunning())
     {
@@ -201,6 +202,7 @@ LimeSDR::~LimeSDR()
 
 OpStatus LimeSDR::Configure(const SDRConfig& cfg, uint8_t moduleIndex = 0)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     OpStatus status = OpStatus::SUCCESS;
     std::vector<std::string> errors;
     bool isValidConfig = LMS7002M_Validate(cfg, errors);
@@ -312,6 +314,7 @@ OpStatus LimeSDR::UpdateFPGAInterface(void* userData)
 
 OpStatus LimeSDR::SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double sampleRate, uint8_t oversample)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     const bool bypass = (oversample == 1) || (oversample == 0 && sampleRate > 62e6);
     uint8_t decimation = 7; // HBD_OVR_RXTSP=7 - bypass
     uint8_t interpolation = 7; // HBI_OVR_TXTSP=7 - bypass
@@ -368,6 +371,7 @@ OpStatus LimeSDR::SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel
 
 OpStatus LimeSDR::Init()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     OpStatus status;
     lime::LMS7002M* lms = mLMSChips[0];
     // TODO: write GPIO to hard reset the chip
@@ -444,11 +448,14 @@ SDRDevice::Descriptor LimeSDR::GetDeviceInfo(void)
 
 OpStatus LimeSDR::Reset()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
+    InvalidateMCUPrograms();
     return LMS64CProtocol::DeviceReset(*mSerialPort, 0);
 }
 
 OpStatus LimeSDR::EnableChannel(TRXDir dir, uint8_t channel, bool enabled)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     OpStatus status = mLMSChips[0]->EnableChannel(dir, channel, enabled);
     if (dir == TRXDir::Tx) //always enable DAC1, otherwise sample rates <2.5MHz do not work
         mLMSChips[0]->Modify_SPI_Reg_bits(LMS7_PD_TX_AFE1, 0);
@@ -658,6 +665,8 @@ OpStatus LimeSDR::StreamSetup(const StreamConfig& config, uint8_t moduleIndex)
     // Allow multiple setup calls
     if (mStreamers.at(moduleIndex) != nullptr)
     {
+        // the scheduler reads the timestamp from the streamer
+        DeleteCommandScheduler(moduleIndex);
         delete mStreamers.at(moduleIndex);
     }
 
@@ -682,6 +691,8 @@ void LimeSDR::StreamStop(uint8_t moduleIndex)
     if (!mStreamers[0])
         return;
 
+    // the scheduler reads the timestamp from the streamer
+    DeleteCommandScheduler(0);
     mStreamers[0]->Stop();
 
     delete mStreamers[0];
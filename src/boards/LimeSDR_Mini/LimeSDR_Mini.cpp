@@ -209,6 +209,7 @@ LimeSDR_Mini::LimeSDR_Mini(std::shared_ptr<IComms> spiLMS,
 
 LimeSDR_Mini::~LimeSDR_Mini()
 {
+    DeleteCommandSchedulers();
     auto& streamer = mStreamers.at(0);
     if (streamer != nullptr && streamer->IsStreamRunning())
     {
@@ -218,6 +219,7 @@ LimeSDR_Mini::~LimeSDR_Mini()
 
 OpStatus LimeSDR_Mini::Configure(const SDRConfig& cfg, uint8_t moduleIndex = 0)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     try
     {
         std::vector<std::string> errors;
@@ -309,6 +311,7 @@ OpStatus LimeSDR_Mini::Configure(const SDRConfig& cfg, uint8_t moduleIndex = 0)
 
 OpStatus LimeSDR_Mini::Init()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     lime::LMS7002M* lms = mLMSChips[0];
     OpStatus status;
     status = lms->ResetChip();
@@ -358,6 +361,8 @@ OpStatus LimeSDR_Mini::Init()
 
 OpStatus LimeSDR_Mini::Reset()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
+    InvalidateMCUPrograms();
     return LMS64CProtocol::DeviceReset(*mSerialPort, 0);
 }
 
@@ -373,6 +378,7 @@ OpStatus LimeSDR_Mini::SetClockFreq(uint8_t clk_id, double freq, uint8_t channel
 
 OpStatus LimeSDR_Mini::Synchronize(bool toChip)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (toChip)
     {
         OpStatus status = mLMSChips[0]->UploadAll();
@@ -500,6 +506,7 @@ OpStatus LimeSDR_Mini::UpdateFPGAInterface(void* userData)
 
 double LimeSDR_Mini::GetTemperature(uint8_t moduleIndex)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (mDeviceDescriptor.name == GetDeviceName(LMS_DEV_LIMESDRMINI))
     {
         throw std::logic_error("LimeSDR-Mini v1 doesn't have a temperature sensor");
@@ -510,6 +517,7 @@ double LimeSDR_Mini::GetTemperature(uint8_t moduleIndex)
 
 OpStatus LimeSDR_Mini::SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double sampleRate, uint8_t oversample)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     const bool bypass = (oversample <= 1);
     uint8_t decimation = 7; // HBD_OVR_RXTSP=7 - bypass
     uint8_t interpolation = 7; // HBI_OVR_TXTSP=7 - bypass
@@ -618,6 +626,8 @@ OpStatus LimeSDR_Mini::StreamSetup(const StreamConfig& config, uint8_t moduleInd
     // Allow multiple setup calls
     if (mStreamers.at(0) != nullptr)
     {
+        // the scheduler reads the timestamp from the streamer
+        DeleteCommandScheduler(0);
         delete mStreamers.at(0);
     }
 
@@ -647,6 +657,8 @@ void LimeSDR_Mini::StreamStop(uint8_t moduleIndex)
         return;
     }
 
+    // the scheduler reads the timestamp from the streamer
+    DeleteCommandScheduler(0);
     mStreamers[0]->Stop();
 
     delete mStreamers[0];
@@ -191,7 +191,9 @@ LimeSDR_X3::LimeSDR_X3(std::shared_ptr<IComms> spiLMS7002M,
     desc.customParameters.push_back(cp_vctcxo_dac);
     desc.customParameters.push_back(cp_temperature);
 
-    mLMS7002Mcomms[0] = std::make_shared<SlaveSelectShim>(spiLMS7002M, SPI_LMS7002M_1);
+    // all LMS7002M chips share one SPI bus, their transactions must not interleave
+    auto lmsBusLock = std::make_shared<std::mutex>();
+    mLMS7002Mcomms[0] = std::make_shared<SlaveSelectShim>(spiLMS7002M, SPI_LMS7002M_1, lmsBusLock);
 
     mFPGA = new lime::FPGA_X3(spiFPGA, mLMS7002Mcomms[0]);
     FPGA::GatewareInfo gw = mFPGA->GetGatewareInfo();
@@ -235,7 +237,7 @@ LimeSDR_X3::LimeSDR_X3(std::shared_ptr<IComms> spiLMS7002M,
     soc.pathNames[TRXDir::Rx] = { "None", "TDD", "FDD", "Calibration (LMS3)" };
     soc.pathNames[TRXDir::Tx] = { "None", "TDD", "FDD" };
     desc.rfSOC.push_back(soc);
-    mLMS7002Mcomms[1] = std::make_shared<SlaveSelectShim>(spiLMS7002M, SPI_LMS7002M_2);
+    mLMS7002Mcomms[1] = std::make_shared<SlaveSelectShim>(spiLMS7002M, SPI_LMS7002M_2, lmsBusLock);
     LMS7002M* lms2 = new LMS7002M(mLMS7002Mcomms[1]);
     lms2->ModifyRegistersDefaults(lms2and3defaultsOverride);
     mLMSChips.push_back(lms2);
@@ -245,7 +247,7 @@ LimeSDR_X3::LimeSDR_X3(std::shared_ptr<IComms> spiLMS7002M,
     soc.pathNames[TRXDir::Rx] = { "None", "LNAH", "Calibration (LMS2)" };
     soc.pathNames[TRXDir::Tx] = { "None", "Band1" };
     desc.rfSOC.push_back(soc);
-    mLMS7002Mcomms[2] = std::make_shared<SlaveSelectShim>(spiLMS7002M, SPI_LMS7002M_3);
+    mLMS7002Mcomms[2] = std::make_shared<SlaveSelectShim>(spiLMS7002M, SPI_LMS7002M_3, lmsBusLock);
     LMS7002M* lms3 = new LMS7002M(mLMS7002Mcomms[2]);
     lms3->ModifyRegistersDefaults(lms2and3defaultsOverride);
     mLMSChips.push_back(lms3);
@@ -271,6 +273,8 @@ LimeSDR_X3::LimeSDR_X3(std::shared_ptr<IComms> spiLMS7002M,
 
 LimeSDR_X3::~LimeSDR_X3()
 {
+    // the timed commands use the chips
+    DeleteCommandSchedulers();
     delete mClockGeneratorCDCM;
     delete mEqualizer;
 
@@ -532,6 +536,12 @@ void LimeSDR_X3::PostConfigure(const SDRConfig& cfg, uint8_t socIndex)
 
 OpStatus LimeSDR_X3::Configure(const SDRConfig& cfg, uint8_t socIndex)
 {
+    return ConfigureModules(cfg, { socIndex });
+}
+
+OpStatus LimeSDR_X3::ConfigureModules(const SDRConfig& cfg, const std::vector<uint8_t>& socIndexes)
+{
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     std::vector<std::string> errors;
     bool isValidConfig = LMS7002M_Validate(cfg, errors);
 
@@ -543,109 +553,132 @@ OpStatus LimeSDR_X3::Configure(const SDRConfig& cfg, uint8_t socIndex)
         return ReportError(OpStatus::ERROR, ss.str().c_str());
     }
 
-    bool rxUsed = false;
-    bool txUsed = false;
-    for (int i = 0; i < 2; ++i)
-    {
-        const ChannelConfig& ch = cfg.channel[i];
-        rxUsed |= ch.rx.enabled;
-        txUsed |= ch.tx.enabled;
-    }
-
     try
     {
         mConfigInProgress = true;
-        PreConfigure(cfg, socIndex);
+        std::vector<CalibrationRequest> calibrations;
+        for (uint8_t socIndex : socIndexes)
+            ConfigureChip(cfg, socIndex, calibrations);
 
-        // config validation complete, now do the actual configuration
-        LMS7002M* chip = mLMSChips.at(socIndex);
-        if (!cfg.skipDefaults)
+        // every chip has its own bus, so their calibrations run at the same time
+        if (CalibrateChannels(calibrations) != OpStatus::SUCCESS)
         {
-            const bool skipTune = true;
-            switch (socIndex)
+            for (const CalibrationRequest& request : calibrations)
             {
-            case 0:
-                InitLMS1(skipTune);
-                break;
-            case 1:
-                InitLMS2(skipTune);
-                break;
-            case 2:
-                InitLMS3(skipTune);
-                break;
+                if (request.status != OpStatus::SUCCESS)
+                    throw std::runtime_error(request.error);
             }
         }
 
-        LMS7002LOConfigure(chip, cfg);
+        for (uint8_t socIndex : socIndexes)
+            FinishChipConfiguration(cfg, socIndex);
 
-        if (socIndex == 0)
-            chip->Modify_SPI_Reg_bits(LMS7_PD_TX_AFE1, 0); // enabled DAC is required for FPGA to work
+        mConfigInProgress = false;
+        for (uint8_t socIndex : socIndexes)
+            PostConfigure(cfg, socIndex);
+    } //try
+    catch (std::logic_error& e)
+    {
+        return ReportError(OpStatus::ERROR, "LimeSDR_X3 config: %s", e.what());
+    } catch (std::runtime_error& e)
+    {
+        return OpStatus::ERROR;
+    }
+    return OpStatus::SUCCESS;
+}
 
-        chip->SetActiveChannel(LMS7002M::Channel::ChA);
+void LimeSDR_X3::ConfigureChip(const SDRConfig& cfg, uint8_t socIndex, std::vector<CalibrationRequest>& calibrations)
+{
+    bool rxUsed = false;
+    for (int i = 0; i < 2; ++i)
+        rxUsed |= cfg.channel[i].rx.enabled;
 
-        double sampleRate = cfg.channel[0].GetDirection(rxUsed ? TRXDir::Rx : TRXDir::Tx).sampleRate;
+    PreConfigure(cfg, socIndex);
 
-        if (socIndex == 0 && sampleRate > 0)
-        {
-            LMS1_SetSampleRate(sampleRate, cfg.channel[0].rx.oversample, cfg.channel[0].tx.oversample);
-        }
-        else if (socIndex == 1 && sampleRate > 0)
-        {
-            Equalizer::Config eqCfg;
-            for (int i = 0; i < 2; ++i)
-            {
-                eqCfg.bypassRxEqualizer[i] = true;
-                eqCfg.bypassTxEqualizer[i] = true;
-                eqCfg.cfr[i].bypass = true;
-                eqCfg.cfr[i].sleep = true;
-                eqCfg.cfr[i].bypassGain = true;
-                eqCfg.cfr[i].interpolation = cfg.channel[0].tx.oversample;
-                eqCfg.fir[i].sleep = true;
-                eqCfg.fir[i].bypass = true;
-            }
-            mEqualizer->Configure(eqCfg);
-            LMS2_SetSampleRate(sampleRate, cfg.channel[0].tx.oversample);
-        }
-        else if (socIndex == 2 && sampleRate > 0)
+    // config validation complete, now do the actual configuration
+    LMS7002M* chip = mLMSChips.at(socIndex);
+    if (!cfg.skipDefaults)
+    {
+        const bool skipTune = true;
+        switch (socIndex)
         {
-            LMS3_SetSampleRate_ExternalDAC(cfg.channel[0].rx.sampleRate, cfg.channel[1].rx.sampleRate);
+        case 0:
+            InitLMS1(skipTune);
+            break;
+        case 1:
+            InitLMS2(skipTune);
+            break;
+        case 2:
+            InitLMS3(skipTune);
+            break;
         }
+    }
 
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            chip->SetActiveChannel((ch & 1) ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA);
-            ConfigureDirection(TRXDir::Rx, chip, cfg, ch, socIndex);
-            ConfigureDirection(TRXDir::Tx, chip, cfg, ch, socIndex);
-            LMS7002TestSignalConfigure(chip, cfg.channel[ch], ch);
-        }
+    LMS7002LOConfigure(chip, cfg);
 
-        if (socIndex == 0)
+    if (socIndex == 0)
+        chip->Modify_SPI_Reg_bits(LMS7_PD_TX_AFE1, 0); // enabled DAC is required for FPGA to work
+
+    chip->SetActiveChannel(LMS7002M::Channel::ChA);
+
+    double sampleRate = cfg.channel[0].GetDirection(rxUsed ? TRXDir::Rx : TRXDir::Tx).sampleRate;
+
+    if (socIndex == 0 && sampleRate > 0)
+    {
+        LMS1_SetSampleRate(sampleRate, cfg.channel[0].rx.oversample, cfg.channel[0].tx.oversample);
+    }
+    else if (socIndex == 1 && sampleRate > 0)
+    {
+        Equalizer::Config eqCfg;
+        for (int i = 0; i < 2; ++i)
         {
-            // enabled ADC/DAC is required for FPGA to work
-            chip->Modify_SPI_Reg_bits(LMS7_PD_RX_AFE1, 0);
-            chip->Modify_SPI_Reg_bits(LMS7_PD_TX_AFE1, 0);
+            eqCfg.bypassRxEqualizer[i] = true;
+            eqCfg.bypassTxEqualizer[i] = true;
+            eqCfg.cfr[i].bypass = true;
+            eqCfg.cfr[i].sleep = true;
+            eqCfg.cfr[i].bypassGain = true;
+            eqCfg.cfr[i].interpolation = cfg.channel[0].tx.oversample;
+            eqCfg.fir[i].sleep = true;
+            eqCfg.fir[i].bypass = true;
         }
-        chip->SetActiveChannel(LMS7002M::Channel::ChA);
-
-        // Workaround: Toggle LimeLights transmit port to flush residual value from data interface
-        uint16_t txMux = chip->Get_SPI_Reg_bits(LMS7param(TX_MUX));
-        chip->Modify_SPI_Reg_bits(LMS7param(TX_MUX), 2);
-        chip->Modify_SPI_Reg_bits(LMS7param(TX_MUX), txMux);
+        mEqualizer->Configure(eqCfg);
+        LMS2_SetSampleRate(sampleRate, cfg.channel[0].tx.oversample);
+    }
+    else if (socIndex == 2 && sampleRate > 0)
+    {
+        LMS3_SetSampleRate_ExternalDAC(cfg.channel[0].rx.sampleRate, cfg.channel[1].rx.sampleRate);
+    }
 
-        mConfigInProgress = false;
-        PostConfigure(cfg, socIndex);
-    } //try
-    catch (std::logic_error& e)
+    for (int ch = 0; ch < 2; ++ch)
     {
-        return ReportError(OpStatus::ERROR, "LimeSDR_X3 config: %s", e.what());
-    } catch (std::runtime_error& e)
+        chip->SetActiveChannel((ch & 1) ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA);
+        ConfigureDirection(TRXDir::Rx, chip, cfg, ch, socIndex, calibrations);
+        ConfigureDirection(TRXDir::Tx, chip, cfg, ch, socIndex, calibrations);
+    }
+}
+
+void LimeSDR_X3::FinishChipConfiguration(const SDRConfig& cfg, uint8_t socIndex)
+{
+    LMS7002M* chip = mLMSChips.at(socIndex);
+    for (int ch = 0; ch < 2; ++ch)
+        LMS7002TestSignalConfigure(chip, cfg.channel[ch], ch);
+
+    if (socIndex == 0)
     {
-        return OpStatus::ERROR;
+        // enabled ADC/DAC is required for FPGA to work
+        chip->Modify_SPI_Reg_bits(LMS7_PD_RX_AFE1, 0);
+        chip->Modify_SPI_Reg_bits(LMS7_PD_TX_AFE1, 0);
     }
-    return OpStatus::SUCCESS;
+    chip->SetActiveChannel(LMS7002M::Channel::ChA);
+
+    // Workaround: Toggle LimeLights transmit port to flush residual value from data interface
+    uint16_t txMux = chip->Get_SPI_Reg_bits(LMS7param(TX_MUX));
+    chip->Modify_SPI_Reg_bits(LMS7param(TX_MUX), 2);
+    chip->Modify_SPI_Reg_bits(LMS7param(TX_MUX), txMux);
 }
 
-void LimeSDR_X3::ConfigureDirection(TRXDir dir, LMS7002M* chip, const SDRConfig& cfg, int ch, uint8_t socIndex)
+void LimeSDR_X3::ConfigureDirection(
+    TRXDir dir, LMS7002M* chip, const SDRConfig& cfg, int ch, uint8_t socIndex, std::vector<CalibrationRequest>& calibrations)
 {
     std::string dirName = dir == TRXDir::Rx ? "Rx" : "Tx";
     SDRDevice::ChannelConfig::Direction trx = cfg.channel[ch].GetDirection(dir);
@@ -672,46 +705,15 @@ void LimeSDR_X3::ConfigureDirection(TRXDir dir, LMS7002M* chip, const SDRConfig&
         }
     }
 
+    // the calibrations of a chip run in the order they are queued, the DC/IQ first and then the filter
+    const uint8_t channel = ch;
     if (trx.calibrate && trx.enabled)
-    {
-        SetupCalibrations(chip, trx.sampleRate);
-
-        int status;
-        if (dir == TRXDir::Rx)
-        {
-            status = CalibrateRx(false, false);
-        }
-        else
-        {
-            status = CalibrateTx(false);
-        }
-
-        if (status != MCU_BD::MCU_NO_ERROR)
-        {
-            throw std::runtime_error(
-                strFormat("%s ch%i DC/IQ calibration failed: %s", dirName, ch, MCU_BD::MCUStatusMessage(status)));
-        }
-    }
+        calibrations.push_back({ socIndex, dir, channel, trx.sampleRate, OpStatus::SUCCESS, CalibrationProcedure::HostDCIQ });
 
     if (trx.lpf > 0 && trx.enabled)
     {
-        SetupCalibrations(chip, trx.sampleRate);
-        int status;
-
-        if (dir == TRXDir::Rx)
-        {
-            status = TuneRxFilter(trx.lpf);
-        }
-        else
-        {
-            status = TuneTxFilter(trx.lpf);
-        }
-
-        if (status != MCU_BD::MCU_NO_ERROR)
-        {
-            throw std::runtime_error(
-                strFormat("%s ch%i filter calibration failed: %s", dirName, ch, MCU_BD::MCUStatusMessage(status)));
-        }
+        calibrations.push_back(
+            { socIndex, dir, channel, trx.sampleRate, OpStatus::SUCCESS, CalibrationProcedure::HostLowPassFilter, trx.lpf });
     }
 }
 
@@ -746,6 +748,7 @@ void LimeSDR_X3::SetLMSPath(const TRXDir dir, const SDRDevice::ChannelConfig::Di
 
 OpStatus LimeSDR_X3::Init()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     struct regVal {
         uint16_t adr;
         uint16_t val;
@@ -769,7 +772,9 @@ OpStatus LimeSDR_X3::Init()
 
 OpStatus LimeSDR_X3::Reset()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     OpStatus status = OpStatus::SUCCESS;
+    InvalidateMCUPrograms();
     for (uint32_t i = 0; i < mLMSChips.size(); ++i)
     {
         status = mLMS7002Mcomms[i]->ResetDevice();
@@ -781,6 +786,7 @@ OpStatus LimeSDR_X3::Reset()
 
 double LimeSDR_X3::GetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     switch (moduleIndex)
     {
     case 1:
@@ -809,6 +815,7 @@ double LimeSDR_X3::GetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channe
 
 OpStatus LimeSDR_X3::SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double sampleRate, uint8_t oversample)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     if (moduleIndex == 0 && sampleRate > 0)
     {
         LMS1_SetSampleRate(sampleRate, oversample, oversample);
@@ -851,6 +858,13 @@ OpStatus LimeSDR_X3::SetClockFreq(uint8_t clk_id, double freq, uint8_t channel)
     return chip->SetClockFreq(static_cast<LMS7002M::ClockID>(clk_id), freq);
 }
 
+uint32_t LimeSDR_X3::GetCalibrationBusId(uint8_t moduleIndex) const
+{
+    // every chip has its own slave select and the shims serialize individual transactions,
+    // so the chips' MCUs can run their calibrations at the same time
+    return moduleIndex;
+}
+
 OpStatus LimeSDR_X3::SPI(uint32_t chipSelect, const uint32_t* MOSI, uint32_t* MISO, uint32_t count)
 {
     switch (chipSelect)
@@ -873,6 +887,8 @@ OpStatus LimeSDR_X3::StreamSetup(const StreamConfig& config, uint8_t moduleIndex
     // Allow multiple setup calls
     if (mStreamers.at(moduleIndex) != nullptr)
     {
+        // the scheduler reads the timestamp from the streamer
+        DeleteCommandScheduler(moduleIndex);
         delete mStreamers.at(moduleIndex);
     }
 
@@ -1284,4 +1300,19 @@ OpStatus LimeSDR_X3::UploadTxWaveform(const StreamConfig& config, uint8_t module
     return TRXLooper_PCIE::UploadTxWaveform(mFPGA, mTRXStreamPorts[moduleIndex], config, moduleIndex, samples, count);
 }
 
+OpStatus LimeSDR_X3::UploadTxWaveform(const StreamConfig& config,
+    uint8_t moduleIndex,
+    TxWaveformSource source,
+    uint64_t count,
+    TxWaveformProgressCallback progress)
+{
+    return TRXLooper_PCIE::UploadTxWaveform(mFPGA, mTRXStreamPorts[moduleIndex], config, moduleIndex, source, count, progress);
+}
+
+OpStatus LimeSDR_X3::UploadTxWaveformFile(
+    const StreamConfig& config, uint8_t moduleIndex, const std::string& filename, TxWaveformProgressCallback progress)
+{
+    return TRXLooper_PCIE::UploadTxWaveformFile(mFPGA, mTRXStreamPorts[moduleIndex], config, moduleIndex, filename, progress);
+}
+
 } //namespace lime
@@ -28,6 +28,7 @@ class LimeSDR_X3 : public LMS7002M_SDRDevice
     virtual ~LimeSDR_X3();
 
     virtual OpStatus Configure(const SDRConfig& config, uint8_t socIndex) override;
+    virtual OpStatus ConfigureModules(const SDRConfig& config, const std::vector<uint8_t>& socIndexes) override;
 
     virtual OpStatus Init() override;
     virtual OpStatus Reset() override;
@@ -53,6 +54,15 @@ class LimeSDR_X3 : public LMS7002M_SDRDevice
     virtual OpStatus MemoryRead(std::shared_ptr<DataStorage> storage, Region region, void* data) override;
     virtual OpStatus UploadTxWaveform(
         const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count) override;
+    virtual OpStatus UploadTxWaveform(const StreamConfig& config,
+        uint8_t moduleIndex,
+        TxWaveformSource source,
+        uint64_t count,
+        TxWaveformProgressCallback progress = nullptr) override;
+    virtual OpStatus UploadTxWaveformFile(const StreamConfig& config,
+        uint8_t moduleIndex,
+        const std::string& filename,
+        TxWaveformProgressCallback progress = nullptr) override;
 
   protected:
     OpStatus InitLMS1(bool skipTune = false);
@@ -68,6 +78,7 @@ class LimeSDR_X3 : public LMS7002M_SDRDevice
     void LMS3SetPath(TRXDir dir, uint8_t chan, uint8_t path);
     void LMS3_SetSampleRate_ExternalDAC(double chA_Hz, double chB_Hz);
     static OpStatus LMS1_UpdateFPGAInterface(void* userData);
+    virtual uint32_t GetCalibrationBusId(uint8_t moduleIndex) const override;
 
     void LMS2_SetSampleRate(double f_Hz, uint8_t oversample);
 
@@ -77,7 +88,10 @@ class LimeSDR_X3 : public LMS7002M_SDRDevice
     enum class ePathLMS2_Tx : uint8_t { NONE, TDD, FDD };
 
   private:
-    void ConfigureDirection(TRXDir dir, LMS7002M* chip, const SDRConfig& cfg, int ch, uint8_t socIndex);
+    void ConfigureChip(const SDRConfig& cfg, uint8_t socIndex, std::vector<CalibrationRequest>& calibrations);
+    void FinishChipConfiguration(const SDRConfig& cfg, uint8_t socIndex);
+    void ConfigureDirection(
+        TRXDir dir, LMS7002M* chip, const SDRConfig& cfg, int ch, uint8_t socIndex, std::vector<CalibrationRequest>& calibrations);
     void SetLMSPath(const TRXDir dir, const SDRDevice::ChannelConfig::Direction& trx, const int ch, const uint8_t socIndex);
 
     CDCM_Dev* mClockGeneratorCDCM;
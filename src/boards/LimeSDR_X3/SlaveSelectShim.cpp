@@ -5,20 +5,27 @@
 using namespace lime;
 
 SlaveSelectShim::SlaveSelectShim(std::shared_ptr<IComms> comms, uint32_t slaveId)
+    : SlaveSelectShim(comms, slaveId, std::make_shared<std::mutex>()){};
+
+SlaveSelectShim::SlaveSelectShim(std::shared_ptr<IComms> comms, uint32_t slaveId, std::shared_ptr<std::mutex> busLock)
     : port(comms)
-    , slaveId(slaveId){};
+    , slaveId(slaveId)
+    , busLock(busLock){};
 
 OpStatus SlaveSelectShim::SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count)
 {
+    std::lock_guard<std::mutex> lock(*busLock);
     return port->SPI(slaveId, MOSI, MISO, count);
 }
 
 OpStatus SlaveSelectShim::SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count)
 {
+    std::lock_guard<std::mutex> lock(*busLock);
     return port->SPI(spiBusAddress, MOSI, MISO, count);
 }
 
 OpStatus SlaveSelectShim::ResetDevice()
 {
+    std::lock_guard<std::mutex> lock(*busLock);
     return port->ResetDevice(slaveId);
 }
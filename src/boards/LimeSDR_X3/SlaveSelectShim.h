@@ -4,6 +4,7 @@
 #include "limesuite/config.h"
 #include "limesuite/IComms.h"
 #include <memory>
+#include <mutex>
 
 namespace lime {
 
@@ -17,6 +18,14 @@ class LIME_API SlaveSelectShim : public ISPI
     @param slaveId The ID of the slave for this shim.
    */
     SlaveSelectShim(std::shared_ptr<IComms> comms, uint32_t slaveId);
+
+    /**
+    @brief Construct a new Slave Select Shim object sharing the bus with other shims.
+    @param comms The communications interface to use.
+    @param slaveId The ID of the slave for this shim.
+    @param busLock The lock held for the duration of each transaction, shared by all shims of the same bus.
+   */
+    SlaveSelectShim(std::shared_ptr<IComms> comms, uint32_t slaveId, std::shared_ptr<std::mutex> busLock);
     virtual OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override;
     virtual OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override;
 
@@ -29,6 +38,7 @@ class LIME_API SlaveSelectShim : public ISPI
   private:
     std::shared_ptr<IComms> port;
     uint32_t slaveId;
+    std::shared_ptr<std::mutex> busLock;
 };
 
 } // namespace lime
@@ -196,6 +196,7 @@ LimeSDR_XTRX::LimeSDR_XTRX(std::shared_ptr<IComms> spiRFsoc,
 
 LimeSDR_XTRX::~LimeSDR_XTRX()
 {
+    DeleteCommandSchedulers();
 }
 
 static OpStatus InitLMS1(LMS7002M* lms, bool skipTune = false)
@@ -236,6 +237,7 @@ static OpStatus InitLMS1(LMS7002M* lms, bool skipTune = false)
 
 OpStatus LimeSDR_XTRX::Configure(const SDRConfig& cfg, uint8_t socIndex)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     std::vector<std::string> errors;
     bool isValidConfig = LMS7002M_Validate(cfg, errors);
 
@@ -313,6 +315,7 @@ OpStatus LimeSDR_XTRX::Configure(const SDRConfig& cfg, uint8_t socIndex)
 
 OpStatus LimeSDR_XTRX::Init()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     struct regVal {
         uint16_t adr;
         uint16_t val;
@@ -337,6 +340,7 @@ OpStatus LimeSDR_XTRX::Init()
 
 OpStatus LimeSDR_XTRX::SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double sampleRate, uint8_t oversample)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlMutex);
     return LMS1_SetSampleRate(sampleRate, oversample, oversample);
 }
 
@@ -372,6 +376,8 @@ OpStatus LimeSDR_XTRX::StreamSetup(const StreamConfig& config, uint8_t moduleInd
     // Allow multiple setup calls
     if (mStreamers.at(moduleIndex) != nullptr)
     {
+        // the scheduler reads the timestamp from the streamer
+        DeleteCommandScheduler(moduleIndex);
         delete mStreamers.at(moduleIndex);
     }
 
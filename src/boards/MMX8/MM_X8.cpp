@@ -807,4 +807,19 @@ OpStatus LimeSDR_MMX8::UploadTxWaveform(const StreamConfig& config, uint8_t modu
     return mSubDevices[moduleIndex]->UploadTxWaveform(config, 0, samples, count);
 }
 
+OpStatus LimeSDR_MMX8::UploadTxWaveform(const StreamConfig& config,
+    uint8_t moduleIndex,
+    TxWaveformSource source,
+    uint64_t count,
+    TxWaveformProgressCallback progress)
+{
+    return mSubDevices[moduleIndex]->UploadTxWaveform(config, 0, source, count, progress);
+}
+
+OpStatus LimeSDR_MMX8::UploadTxWaveformFile(
+    const StreamConfig& config, uint8_t moduleIndex, const std::string& filename, TxWaveformProgressCallback progress)
+{
+    return mSubDevices[moduleIndex]->UploadTxWaveformFile(config, 0, filename, progress);
+}
+
 } //namespace lime
@@ -147,6 +147,15 @@ class LimeSDR_MMX8 : public SDRDevice
     virtual OpStatus MemoryRead(std::shared_ptr<DataStorage> storage, Region region, void* data) override;
     virtual OpStatus UploadTxWaveform(
         const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count) override;
+    virtual OpStatus UploadTxWaveform(const StreamConfig& config,
+        uint8_t moduleIndex,
+        TxWaveformSource source,
+        uint64_t count,
+        TxWaveformProgressCallback progress = nullptr) override;
+    virtual OpStatus UploadTxWaveformFile(const StreamConfig& config,
+        uint8_t moduleIndex,
+        const std::string& filename,
+        TxWaveformProgressCallback progress = nullptr) override;
 
   private:
     std::shared_ptr<IComms> mMainFPGAcomms;
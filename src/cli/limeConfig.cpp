@@ -292,13 +292,12 @@ int main(int argc, char** argv)
                     config.channel[i] = config.channel[0];
             }
         }
-        for (int moduleId : chipIndexes)
+        // configured together, so the device can calibrate the chips at the same time
+        const std::vector<uint8_t> moduleIndexes(chipIndexes.begin(), chipIndexes.end());
+        if (device->ConfigureModules(config, moduleIndexes) != OpStatus::SUCCESS)
         {
-            if (device->Configure(config, moduleId) != OpStatus::SUCCESS)
-            {
-                cerr << "Failed to configure device (chip" << moduleId << ")" << std::endl;
-                return EXIT_FAILURE;
-            }
+            cerr << "Failed to configure device" << std::endl;
+            return EXIT_FAILURE;
         }
     } catch (std::runtime_error& e)
     {
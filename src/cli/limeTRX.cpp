@@ -2,6 +2,7 @@
 #include "limesuite/DeviceRegistry.h"
 #include "limesuite/SDRDevice.h"
 #include "limesuite/StreamComposite.h"
+#include "Logger.h"
 #include <iostream>
 #include <chrono>
 #include <math.h>
@@ -598,7 +599,7 @@ int main(int argc, char** argv)
     FFTPlotter fftplot(sampleRate, fftSize, persistPlotWindows);
 #endif
 
-    SDRDevice::StreamMeta rxMeta;
+    SDRDevice::StreamMeta rxMeta{};
     SDRDevice::StreamMeta txMeta;
     txMeta.waitForTimestamp = true;
     txMeta.timestamp = sampleRate / 100; // send tx samples 10ms after start
@@ -609,6 +610,8 @@ int main(int argc, char** argv)
     if (showConstelation)
         constellationplot.Start();
 #endif
+    // the streaming threads must not wait for the console output
+    lime::enableAsyncLogging(true);
     if (useComposite)
         composite->StreamStart();
     else
@@ -661,6 +664,7 @@ int main(int argc, char** argv)
             txMeta.timestamp = rxMeta.timestamp + samplesRead + repeaterDelay;
             txMeta.waitForTimestamp = true;
             txMeta.flushPartialPacket = true;
+            txMeta.endOfBurst = false;
             if (useComposite)
                 composite->StreamTx(rxSamples, samplesRead, &txMeta);
             else
@@ -735,6 +739,7 @@ int main(int argc, char** argv)
         composite->StreamStop();
     else
         device->StreamStop(chipIndex);
+    lime::enableAsyncLogging(false);
 
     if (composite)
         delete composite;
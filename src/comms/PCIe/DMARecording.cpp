@@ -0,0 +1,233 @@
+#include "DMARecording.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "Logger.h"
+#include "threadHelper.h"
+
+using namespace lime;
+using namespace std::chrono;
+
+namespace {
+
+constexpr char recordingMagic[8] = { 'L', 'I', 'M', 'E', 'D', 'M', 'A', 'R' };
+constexpr uint16_t recordingVersion = 1;
+constexpr std::size_t headerSize = sizeof(recordingMagic) + 2 + 4 * 4;
+constexpr std::size_t recordHeaderSize = 8 + 4 + 4;
+// Records beyond this are dropped rather than blocking the streaming thread
+constexpr std::size_t maxQueuedRecords = 1024;
+
+void PutLE(uint8_t* dest, uint64_t value, int byteCount)
+{
+    for (int i = 0; i < byteCount; ++i)
+        dest[i] = (value >> (8 * i)) & 0xFF;
+}
+
+uint64_t GetLE(const uint8_t* src, int byteCount)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < byteCount; ++i)
+        value |= static_cast<uint64_t>(src[i]) << (8 * i);
+    return value;
+}
+
+} // namespace
+
+DMARecorder::DMARecorder()
+    : mReadSize(0)
+    , mRecording(false)
+    , mTerminate(false)
+    , mDropped(0)
+{
+}
+
+/// @brief Finishes the recording, writing the queued buffers.
+DMARecorder::~DMARecorder()
+{
+    Close();
+}
+
+/// @brief Creates the recording file, writes its header and starts the writing thread.
+/// @param filename The path of the file to record into.
+/// @param header The layout of the DMA buffers to record.
+/// @return The status of the operation.
+OpStatus DMARecorder::Open(const std::string& filename, const DMARecordingHeader& header)
+{
+    Close();
+    mFile.open(filename, std::ios::binary | std::ios::trunc);
+    if (!mFile.good())
+        return ReportError(OpStatus::IO_FAILURE, "DMARecorder(%s) - failed to open file", filename.c_str());
+
+    uint8_t buffer[headerSize];
+    std::copy(std::begin(recordingMagic), std::end(recordingMagic), buffer);
+    uint8_t* ptr = buffer + sizeof(recordingMagic);
+    PutLE(ptr, recordingVersion, 2);
+    PutLE(ptr + 2, header.dmaBufferSize, 4);
+    PutLE(ptr + 6, header.dmaBufferCount, 4);
+    PutLE(ptr + 10, header.readSize, 4);
+    PutLE(ptr + 14, header.packetSize, 4);
+    mFile.write(reinterpret_cast<const char*>(buffer), headerSize);
+    if (!mFile.good())
+    {
+        mFile.close();
+        return ReportError(OpStatus::IO_FAILURE, "DMARecorder(%s) - write failed", filename.c_str());
+    }
+
+    mReadSize = header.readSize;
+    mDropped = 0;
+    mTerminate = false;
+    mStart = steady_clock::now();
+    mRecording.store(true, std::memory_order_relaxed);
+    mThread = std::thread(&DMARecorder::WriterLoop, this);
+    SetOSThreadPriority(ThreadPriority::LOWEST, ThreadPolicy::DEFAULT, &mThread);
+#ifdef __linux__
+    pthread_setname_np(mThread.native_handle(), "lime:DMARecord");
+#endif
+    return OpStatus::SUCCESS;
+}
+
+/// @brief Queues a DMA buffer to be appended to the recording, never waits for the file.
+/// @param hwIndex The hardware buffer index at the time of reading.
+/// @param swIndex The index of the buffer being read.
+/// @param buffer The contents of the buffer, the read size long.
+void DMARecorder::Record(uint32_t hwIndex, uint32_t swIndex, const uint8_t* buffer)
+{
+    if (!mRecording.load(std::memory_order_relaxed))
+        return;
+
+    DMARecord record;
+    record.time_ns = duration_cast<nanoseconds>(steady_clock::now() - mStart).count();
+    record.hwIndex = hwIndex;
+    record.swIndex = swIndex;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mQueue.size() >= maxQueuedRecords)
+        {
+            ++mDropped;
+            return;
+        }
+        if (!mFreeBuffers.empty())
+        {
+            record.data = std::move(mFreeBuffers.back());
+            mFreeBuffers.pop_back();
+        }
+    }
+    record.data.resize(mReadSize);
+    std::memcpy(record.data.data(), buffer, mReadSize);
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mQueue.push_back(std::move(record));
+    }
+    mCv.notify_one();
+}
+
+/// @brief Finishes the recording, after the queued buffers are written.
+void DMARecorder::Close()
+{
+    if (mThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mTerminate = true;
+        }
+        mCv.notify_all();
+        mThread.join();
+    }
+    mRecording.store(false, std::memory_order_relaxed);
+    if (mFile.is_open())
+        mFile.close();
+    if (mDropped > 0)
+        lime::warning("DMARecorder - %lu buffers were not recorded, the file writing was too slow",
+            static_cast<unsigned long>(mDropped));
+    mDropped = 0;
+    mQueue.clear();
+    mFreeBuffers.clear();
+}
+
+void DMARecorder::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true)
+    {
+        mCv.wait(lock, [this] { return mTerminate || !mQueue.empty(); });
+        if (mQueue.empty())
+            return;
+
+        DMARecord record = std::move(mQueue.front());
+        mQueue.pop_front();
+        lock.unlock();
+
+        if (mFile.is_open())
+        {
+            uint8_t recordHeader[recordHeaderSize];
+            PutLE(recordHeader, record.time_ns, 8);
+            PutLE(recordHeader + 8, record.hwIndex, 4);
+            PutLE(recordHeader + 12, record.swIndex, 4);
+            mFile.write(reinterpret_cast<const char*>(recordHeader), recordHeaderSize);
+            mFile.write(reinterpret_cast<const char*>(record.data.data()), record.data.size());
+            if (!mFile.good())
+            {
+                lime::error("DMARecorder - write failed, recording stopped");
+                mRecording.store(false, std::memory_order_relaxed);
+                mFile.close();
+            }
+        }
+
+        lock.lock();
+        mFreeBuffers.push_back(std::move(record.data));
+    }
+}
+
+DMARecordingReader::DMARecordingReader()
+    : mHeader{}
+{
+}
+
+/// @brief Opens a recording and reads its header.
+/// @param filename The path of the recording file.
+/// @return The status of the operation.
+OpStatus DMARecordingReader::Open(const std::string& filename)
+{
+    mFile.close();
+    mFile.open(filename, std::ios::binary);
+    if (!mFile.good())
+        return ReportError(OpStatus::FILE_NOT_FOUND, "DMARecordingReader(%s) - file not found", filename.c_str());
+
+    uint8_t buffer[headerSize];
+    mFile.read(reinterpret_cast<char*>(buffer), headerSize);
+    const bool complete = static_cast<std::size_t>(mFile.gcount()) == headerSize;
+    if (!complete || !std::equal(std::begin(recordingMagic), std::end(recordingMagic), buffer))
+        return ReportError(OpStatus::INVALID_VALUE, "DMARecordingReader(%s) - invalid format", filename.c_str());
+
+    const uint8_t* ptr = buffer + sizeof(recordingMagic);
+    if (GetLE(ptr, 2) != recordingVersion)
+        return ReportError(
+            OpStatus::NOT_SUPPORTED, "DMARecordingReader(%s) - unsupported version %i", filename.c_str(), int(GetLE(ptr, 2)));
+    mHeader.dmaBufferSize = GetLE(ptr + 2, 4);
+    mHeader.dmaBufferCount = GetLE(ptr + 6, 4);
+    mHeader.readSize = GetLE(ptr + 10, 4);
+    mHeader.packetSize = GetLE(ptr + 14, 4);
+    if (mHeader.readSize > mHeader.dmaBufferSize)
+        return ReportError(OpStatus::INVALID_VALUE, "DMARecordingReader(%s) - invalid format", filename.c_str());
+    return OpStatus::SUCCESS;
+}
+
+/// @brief Reads the next recorded DMA buffer.
+/// @param[out] record The buffer read from the file.
+/// @return False once the recording has ended.
+bool DMARecordingReader::ReadNext(DMARecord& record)
+{
+    uint8_t recordHeader[recordHeaderSize];
+    mFile.read(reinterpret_cast<char*>(recordHeader), recordHeaderSize);
+    if (static_cast<std::size_t>(mFile.gcount()) != recordHeaderSize)
+        return false;
+    record.time_ns = GetLE(recordHeader, 8);
+    record.hwIndex = GetLE(recordHeader + 8, 4);
+    record.swIndex = GetLE(recordHeader + 12, 4);
+    record.data.resize(mHeader.readSize);
+    mFile.read(reinterpret_cast<char*>(record.data.data()), mHeader.readSize);
+    // a recording cut short by the end of the stream drops the partial buffer
+    return static_cast<std::size_t>(mFile.gcount()) == mHeader.readSize;
+}
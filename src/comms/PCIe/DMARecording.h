@@ -0,0 +1,91 @@
+#ifndef LIME_DMARECORDING_H
+#define LIME_DMARECORDING_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "limesuite/OpStatus.h"
+
+namespace lime {
+
+/** @brief The layout of the DMA ring buffer a recording was made with. */
+struct DMARecordingHeader {
+    uint32_t dmaBufferSize; ///< The size of a single DMA buffer.
+    uint32_t dmaBufferCount; ///< The amount of DMA buffers in the ring.
+    uint32_t readSize; ///< The amount of bytes used in each of the buffers.
+    uint32_t packetSize; ///< The size of a single data packet in the buffers.
+};
+
+/** @brief A single DMA buffer of a recording. */
+struct DMARecord {
+    uint64_t time_ns; ///< The time the buffer was read at, since the start of the recording.
+    uint32_t hwIndex; ///< The hardware buffer index at the time of reading.
+    uint32_t swIndex; ///< The index of the buffer that was read.
+    std::vector<uint8_t> data; ///< The raw contents of the buffer.
+};
+
+/**
+  @brief Records the raw DMA buffers of a live stream into a file.
+
+  Every buffer is stored along with the hardware index and the time it was read at,
+  so the stream can later be replayed with the original timing.
+  The streaming thread only copies the buffers into a queue, the file is written by a thread of the recorder.
+ */
+class DMARecorder
+{
+  public:
+    DMARecorder();
+    ~DMARecorder();
+    OpStatus Open(const std::string& filename, const DMARecordingHeader& header);
+    void Record(uint32_t hwIndex, uint32_t swIndex, const uint8_t* buffer);
+    void Close();
+
+    /// @brief Gets whether the recording is in progress.
+    /// @return True if the buffers are being recorded.
+    bool IsOpen() const { return mRecording.load(std::memory_order_relaxed); }
+
+  private:
+    void WriterLoop();
+
+    std::ofstream mFile; // used only by the writer thread while it runs
+    std::chrono::steady_clock::time_point mStart;
+    uint32_t mReadSize;
+    std::atomic<bool> mRecording;
+
+    std::mutex mLock;
+    std::condition_variable mCv;
+    std::thread mThread;
+    bool mTerminate;
+    std::deque<DMARecord> mQueue; ///< The buffers waiting to be written.
+    std::vector<std::vector<uint8_t>> mFreeBuffers; ///< Written buffers, reused for the following records.
+    uint64_t mDropped; ///< The amount of buffers not recorded, because the writer fell behind.
+};
+
+/** @brief Reads back the DMA buffers recorded by the DMARecorder. */
+class DMARecordingReader
+{
+  public:
+    DMARecordingReader();
+    OpStatus Open(const std::string& filename);
+    bool ReadNext(DMARecord& record);
+
+    /// @brief Gets the layout of the DMA ring buffer the recording was made with.
+    /// @return The header of the recording.
+    const DMARecordingHeader& GetHeader() const { return mHeader; }
+
+  private:
+    std::ifstream mFile;
+    DMARecordingHeader mHeader;
+};
+
+} // namespace lime
+
+#endif // LIME_DMARECORDING_H
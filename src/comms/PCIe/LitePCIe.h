@@ -18,11 +18,11 @@ class LIME_API LitePCIe
   public:
     static std::vector<std::string> GetDevicesWithPattern(const std::string& regex);
     LitePCIe();
-    ~LitePCIe();
+    virtual ~LitePCIe();
 
     int Open(const std::string& deviceFilename, uint32_t flags);
     void Close();
-    bool IsOpen();
+    virtual bool IsOpen();
 
     // Write/Read for communicating to control end points (SPI, I2C...)
     virtual int WriteControl(const uint8_t* buffer, int length, int timeout_ms = 100);
@@ -37,8 +37,8 @@ class LIME_API LitePCIe
 
     int GetFd() const { return mFileDescriptor; };
 
-    void RxDMAEnable(bool enabled, uint32_t bufferSize, uint8_t irqPeriod);
-    void TxDMAEnable(bool enabled);
+    virtual void RxDMAEnable(bool enabled, uint32_t bufferSize, uint8_t irqPeriod);
+    virtual void TxDMAEnable(bool enabled);
 
     /** @brief Structure for holding the Direct Memory Access (DMA) information. */
     struct DMAInfo {
@@ -54,7 +54,7 @@ class LIME_API LitePCIe
         int bufferSize;
         int bufferCount;
     };
-    DMAInfo GetDMAInfo() { return mDMA; };
+    virtual DMAInfo GetDMAInfo() { return mDMA; };
 
     /** @brief Structure for holding the current state of the Direct Memory Access (DMA). */
     struct DMAState {
@@ -64,16 +64,16 @@ class LIME_API LitePCIe
         bool enabled;
         bool genIRQ;
     };
-    DMAState GetRxDMAState();
-    DMAState GetTxDMAState();
+    virtual DMAState GetRxDMAState();
+    virtual DMAState GetTxDMAState();
 
-    int SetRxDMAState(DMAState s);
-    int SetTxDMAState(DMAState s);
+    virtual int SetRxDMAState(DMAState s);
+    virtual int SetTxDMAState(DMAState s);
 
-    bool WaitRx();
-    bool WaitTx();
+    virtual bool WaitRx();
+    virtual bool WaitTx();
 
-    void CacheFlush(bool isTx, bool toDevice, uint16_t index);
+    virtual void CacheFlush(bool isTx, bool toDevice, uint16_t index);
 
   protected:
     std::string mFilePath;
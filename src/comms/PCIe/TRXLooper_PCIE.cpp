@@ -1,19 +1,22 @@
 #include "TRXLooper_PCIE.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <chrono>
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
+#include <fstream>
+#include <future>
 #include <memory>
-#include <queue>
 #include <thread>
 #include <vector>
 
 #include "AvgRmsCounter.h"
 #include "BufferInterleaving.h"
 #include "DataPacket.h"
+#include "DMARecording.h"
 #include "FPGA_common.h"
 #include "LitePCIe.h"
 #include "limesuite/commonTypes.h"
@@ -24,7 +27,7 @@
 #include "MemoryPool.h"
 #include "TxBufferManager.h"
 
-static bool showStats = false;
+static const bool showStats = false;
 static const int statsPeriod_ms = 1000; // at 122.88 MHz MIMO, fpga tx pkt counter overflows every 272ms
 
 typedef std::chrono::steady_clock perfClock;
@@ -111,6 +114,9 @@ OpStatus TRXLooper_PCIE::Setup(const SDRDevice::StreamConfig& config)
     uint32_t values[] = { 0, 3, 0 };
     fpga->WriteRegisters(addrs, values, 3);
 
+    mStatsReporter.SetName(mRxArgs.port->GetPathName());
+    mStatsReporter.SetLogToInfo(showStats);
+
     mConfig = config;
     if (config.channels.at(lime::TRXDir::Rx).size() > 0)
         RxSetup();
@@ -132,7 +138,8 @@ int TRXLooper_PCIE::TxSetup()
     const int chCount = std::max(mConfig.channels.at(lime::TRXDir::Rx).size(), mConfig.channels.at(lime::TRXDir::Tx).size());
     const int sampleSize = (mConfig.linkFormat == SDRDevice::StreamConfig::DataFormat::I16 ? 4 : 3); // sizeof IQ pair
 
-    int samplesInPkt = 256; //(mConfig.linkFormat == SDRDevice::StreamConfig::DataFormat::I16 ? 1020 : 1360) / chCount;
+    // the packets of many channels get fewer samples, so they still fit the maximum payload
+    int samplesInPkt = std::min(256, 4080 / (sampleSize * chCount));
     const int packetSize = sizeof(StreamHeader) + samplesInPkt * sampleSize * chCount;
 
     if (mConfig.extraConfig.tx.samplesInPacket != 0)
@@ -177,14 +184,15 @@ int TRXLooper_PCIE::TxSetup()
 
     const std::string name = "MemPool_Tx" + std::to_string(chipId);
     const int upperAllocationLimit =
-        65536; //sizeof(complex32f_t) * mTx.packetsToBatch * samplesInPkt * chCount + SamplesPacketType::headerSize;
+        std::max<int>(65536, sizeof(complex32f_t) * mTx.packetsToBatch * samplesInPkt * chCount + SamplesPacketType::headerSize);
     mTx.memPool = new MemoryPool(1024, upperAllocationLimit, 4096, name);
     return 0;
 }
 
 void TRXLooper_PCIE::TransmitPacketsLoop()
 {
-    const bool mimo = std::max(mConfig.channels.at(lime::TRXDir::Tx).size(), mConfig.channels.at(lime::TRXDir::Rx).size()) > 1;
+    const uint8_t channelCount =
+        std::max(mConfig.channels.at(lime::TRXDir::Tx).size(), mConfig.channels.at(lime::TRXDir::Rx).size());
     const bool compressed = mConfig.linkFormat == SDRDevice::StreamConfig::DataFormat::I12;
     const int irqPeriod = 4;
 
@@ -197,23 +205,22 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
     auto fifo = mTx.fifo;
 
     int64_t totalBytesSent = 0; //for data rate calculation
-    int packetsSent = 0;
-    int totalPacketSent = 0;
-    std::size_t maxFIFOlevel = 0;
     int64_t lastTS = 0;
 
     struct PendingWrite {
         uint32_t id;
-        uint8_t* data;
-        int32_t offset;
         int32_t size;
     };
-    std::queue<PendingWrite> pendingWrites;
+    // ring of the submitted buffers, there can't be more of them in flight than there are DMA buffers
+    std::vector<PendingWrite> pendingWrites(bufferCount);
+    uint32_t pendingHead = 0;
+    uint32_t pendingCount = 0;
 
     uint32_t stagingBufferIndex = 0;
     SamplesPacketType* srcPkt = nullptr;
 
-    TxBufferManager<SamplesPacketType> output(mimo, compressed, mTxArgs.samplesInPacket, mTxArgs.packetsToBatch, mConfig.format);
+    TxBufferManager<SamplesPacketType> output(
+        channelCount, compressed, mTxArgs.samplesInPacket, mTxArgs.packetsToBatch, mConfig.format);
 
     mTxArgs.port->CacheFlush(true, false, 0);
     output.Reset(dmaBuffers[0], mTxArgs.bufferSize);
@@ -221,7 +228,6 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
     bool outputReady = false;
 
     AvgRmsCounter txTSAdvance;
-    AvgRmsCounter transferSize;
 
     // Initialize DMA
     mTxArgs.port->TxDMAEnable(true);
@@ -238,31 +244,58 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
 
     LitePCIe::DMAState state;
     state.swIndex = 0;
-
-    DeltaVariable<int32_t> underrun(0);
-    DeltaVariable<int32_t> loss(0);
+    state.hwIndex = 0;
+
+    // the statistics are formatted and logged by the reporter thread
+    auto publishStats = [&]() {
+        StreamStatsReporter::Snapshot snapshot;
+        snapshot.time = t2;
+        snapshot.timestamp = lastTS;
+        snapshot.bytesTransferred = totalBytesSent;
+        snapshot.packets = stats.packets;
+        snapshot.overrun = stats.overrun;
+        snapshot.underrun = stats.underrun;
+        snapshot.loss = stats.loss;
+        snapshot.fifoLevel = fifo->size();
+        snapshot.hasDMAState = true;
+        snapshot.dmaSoftwareIndex = state.swIndex;
+        snapshot.dmaHardwareIndex = state.hwIndex;
+        snapshot.hasTxAdvance = true;
+        snapshot.txAdvanceInMicroseconds = mConfig.hintSampleRate != 0;
+        double avgTxAdvance = 0, rmsTxAdvance = 0;
+        txTSAdvance.GetResult(avgTxAdvance, rmsTxAdvance);
+        snapshot.txAdvanceMin = txTSAdvance.Min();
+        snapshot.txAdvanceAverage = avgTxAdvance;
+        snapshot.txAdvanceMax = txTSAdvance.Max();
+        mStatsReporter.Publish(TRXDir::Tx, snapshot);
+    };
+    publishStats();
+    bool refreshState = true;
 
     while (mTx.terminate.load(std::memory_order_relaxed) == false)
     {
-        // check if DMA transfers have completed
-        state = mTxArgs.port->GetTxDMAState();
+        // an outdated hardware index can only overestimate the buffers in flight, so the DMA state
+        // is queried only when it limits the next submission, or when the statistics are due
+        if (refreshState || static_cast<uint16_t>(stagingBufferIndex - state.hwIndex) >= overflowLimit)
+        {
+            state = mTxArgs.port->GetTxDMAState();
+            refreshState = false;
+        }
 
         // process pending transactions
-        while (!pendingWrites.empty() && !mTx.terminate.load(std::memory_order_relaxed))
+        while (pendingCount > 0 && !mTx.terminate.load(std::memory_order_relaxed))
         {
-            PendingWrite& dataBlock = pendingWrites.front();
+            const PendingWrite& dataBlock = pendingWrites[pendingHead];
             if (dataBlock.id - state.hwIndex > 255)
             {
                 totalBytesSent += dataBlock.size;
-                pendingWrites.pop();
+                pendingHead = (pendingHead + 1) % bufferCount;
+                --pendingCount;
             }
             else
                 break;
         }
 
-        // get input data
-        maxFIFOlevel = std::max(maxFIFOlevel, fifo->size());
-
         // collect and transform samples data to output buffer
         while (!outputReady && output.hasSpace() && !mTx.terminate.load(std::memory_order_relaxed))
         {
@@ -287,6 +320,8 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
                         break;
                     }
                 }
+                if (srcPkt->useTimestamp)
+                    mTxBurstEnd.store(txBurstActive, std::memory_order_relaxed);
             }
 
             // drop old packets before forming, Rx is needed to get current timestamp
@@ -303,7 +338,6 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
                     txTSAdvance.Add(txAdvance);
                 if (txAdvance <= 0)
                 {
-                    underrun.add(1);
                     ++stats.underrun;
                     mTx.memPool->Free(srcPkt);
                     srcPkt = nullptr;
@@ -344,9 +378,7 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
         {
             PendingWrite wrInfo;
             wrInfo.id = stagingBufferIndex;
-            wrInfo.offset = 0;
             wrInfo.size = output.size();
-            wrInfo.data = output.data();
             // write or schedule write
             state.swIndex = stagingBufferIndex;
             state.bufferSize = wrInfo.size;
@@ -354,7 +386,8 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
 
             StreamHeader* pkt = reinterpret_cast<StreamHeader*>(output.data());
             lastTS = pkt->counter;
-            if (mConfig.channels.at(lime::TRXDir::Rx).size() > 0) // Rx is needed for current timestamp
+            // Rx is needed for current timestamp, samples sent between bursts are not expected to be on time
+            if (mConfig.channels.at(lime::TRXDir::Rx).size() > 0 && mTxBurstEnd.load(std::memory_order_relaxed) != txBurstIdle)
             {
                 int64_t rxNow = mRx.lastTimestamp.load(std::memory_order_relaxed);
                 const int64_t txAdvance = pkt->counter - rxNow;
@@ -367,7 +400,6 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
                     txTSAdvance.Add(txAdvance);
                 if (txAdvance <= 0)
                 {
-                    underrun.add(1);
                     ++stats.underrun;
                     // TODO: first packet in the buffer is already late, could just skip this
                     // buffer transmission, but packets at the end of buffer might just still
@@ -394,14 +426,27 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
             {
                 //lime::debug("Sent sw: %li hw: %li, diff: %li", stagingBufferIndex, reader.hw_count, stagingBufferIndex-reader.hw_count);
                 outputReady = false;
-                pendingWrites.push(wrInfo);
-                transferSize.Add(wrInfo.size);
+                if (pendingCount == static_cast<uint32_t>(bufferCount))
+                {
+                    // the oldest buffer must have been reused by now
+                    totalBytesSent += pendingWrites[pendingHead].size;
+                    pendingHead = (pendingHead + 1) % bufferCount;
+                    --pendingCount;
+                }
+                pendingWrites[(pendingHead + pendingCount) % bufferCount] = wrInfo;
+                ++pendingCount;
                 ++stagingBufferIndex;
                 stagingBufferIndex &= 0xFFFF;
-                packetsSent += output.packetCount();
-                totalPacketSent += output.packetCount();
                 stats.timestamp = lastTS;
                 stats.bytesTransferred += wrInfo.size;
+                if (output.endsBurst())
+                {
+                    // the stream becomes idle once the hardware has transmitted the end of the burst
+                    mTxBurstEnd.store(output.endTimestamp(), std::memory_order_relaxed);
+                    ++stats.burstsCompleted;
+                    if (mConfig.statusCallback)
+                        mStatsReporter.PublishStatus(TRXDir::Tx, stats);
+                }
                 mTxArgs.port->CacheFlush(true, false, stagingBufferIndex % bufferCount);
                 output.Reset(dmaBuffers[stagingBufferIndex % bufferCount], mTxArgs.bufferSize);
             }
@@ -412,54 +457,8 @@ void TRXLooper_PCIE::TransmitPacketsLoop()
         if (timePeriod >= statsPeriod_ms || mTx.terminate.load(std::memory_order_relaxed))
         {
             t1 = t2;
-
-            state = mTxArgs.port->GetTxDMAState();
-            double dataRate = 1000.0 * totalBytesSent / timePeriod;
-            double avgTransferSize = 0, rmsTransferSize = 0;
-            transferSize.GetResult(avgTransferSize, rmsTransferSize);
-
-            double avgTxAdvance = 0, rmsTxAdvance = 0;
-            txTSAdvance.GetResult(avgTxAdvance, rmsTxAdvance);
-            loss.set(stats.loss);
-            if (showStats || mCallback_logMessage)
-            {
-                char msg[512];
-                snprintf(msg,
-                    sizeof(msg) - 1,
-                    "%s Tx: %3.3f MB/s | TS:%li pkt:%li o:%i shw:%u/%u(%+i) u:%i(%+i) l:%i(%+i) tsAdvance:%+.0f/%+.0f/%+.0f%s, "
-                    "f:%li",
-                    mRxArgs.port->GetPathName().c_str(),
-                    dataRate / 1000000.0,
-                    lastTS,
-                    stats.packets,
-                    stats.overrun,
-                    state.swIndex,
-                    state.hwIndex,
-                    state.swIndex - state.hwIndex,
-                    underrun.value(),
-                    underrun.delta(),
-                    loss.value(),
-                    loss.delta(),
-                    txTSAdvance.Min(),
-                    avgTxAdvance,
-                    txTSAdvance.Max(),
-                    (mConfig.hintSampleRate ? "us" : ""),
-                    fifo->size());
-                if (showStats)
-                    lime::info("%s", msg);
-                if (mCallback_logMessage)
-                {
-                    bool showAsWarning = underrun.delta() || loss.delta();
-                    SDRDevice::LogLevel level = showAsWarning ? SDRDevice::LogLevel::WARNING : SDRDevice::LogLevel::DEBUG;
-                    mCallback_logMessage(level, msg);
-                }
-            }
-            loss.checkpoint();
-            underrun.checkpoint();
-            packetsSent = 0;
-            totalBytesSent = 0;
-            mTx.stats.dataRate_Bps = dataRate;
-            maxFIFOlevel = 0;
+            publishStats();
+            refreshState = true;
         }
     }
 }
@@ -505,7 +504,7 @@ int TRXLooper_PCIE::RxSetup()
     }
 
     int samplesInPkt = std::clamp(requestSamplesInPkt, 64, maxSamplesInPkt);
-    int payloadSize = requestSamplesInPkt * sampleSize * chCount;
+    int payloadSize = samplesInPkt * sampleSize * chCount;
 
     // iqSamplesCount must be N*16, or N*8 depending on device BUS width
     const uint32_t iqSamplesCount = (payloadSize / (sampleSize * 2)) & ~0xF; //magic number needed for fpga's FSMs
@@ -569,11 +568,27 @@ int TRXLooper_PCIE::RxSetup()
     mRxArgs.samplesInPacket = samplesInPkt;
 
     const std::string name = "MemPool_Rx" + std::to_string(chipId);
+    // the channelizer can deliver more channels than it receives
+    const int outputChCount = std::max<int>(chCount, GetRxOutputChannelCount());
     const int upperAllocationLimit =
-        sizeof(complex32f_t) * mRx.packetsToBatch * samplesInPkt * chCount + SamplesPacketType::headerSize;
+        sizeof(complex32f_t) * mRx.packetsToBatch * samplesInPkt * outputChCount + SamplesPacketType::headerSize;
     mRx.memPool = new MemoryPool(1024, upperAllocationLimit, 4096, name);
 
     const int32_t readSize = mRxArgs.packetSize * mRxArgs.packetsToBatch;
+
+    mRxRecorder.reset();
+    if (!mConfig.extraConfig.rxDMARecordingFile.empty())
+    {
+        DMARecordingHeader header;
+        header.dmaBufferSize = dma.bufferSize;
+        header.dmaBufferCount = dma.bufferCount;
+        header.readSize = readSize;
+        header.packetSize = packetSize;
+        mRxRecorder = std::make_unique<DMARecorder>();
+        if (mRxRecorder->Open(mConfig.extraConfig.rxDMARecordingFile, header) != OpStatus::SUCCESS)
+            mRxRecorder.reset();
+    }
+
     mRxArgs.port->RxDMAEnable(true, readSize, irqPeriod);
     return 0;
 }
@@ -600,8 +615,8 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
         mConfig.format == SDRDevice::StreamConfig::DataFormat::F32 ? sizeof(complex32f_t) : sizeof(complex16_t);
     const int32_t outputPktSize = SamplesPacketType::headerSize + mRxArgs.packetsToBatch * samplesInPkt * outputSampleSize;
 
-    DeltaVariable<int32_t> overrun(0);
-    DeltaVariable<int32_t> loss(0);
+    uint32_t overrun = 0;
+    uint32_t loss = 0;
 
     // Anticipate the overflow 2 interrupts early, just in case of missing an interrupt
     // Avoid situations where CPU and device is at the same buffer index
@@ -622,9 +637,27 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
     auto t1 = perfClock::now();
     auto t2 = t1;
 
-    int32_t Bps = 0;
-
     LitePCIe::DMAState dma;
+    dma.swIndex = 0;
+    dma.hwIndex = 0;
+
+    // the statistics are formatted and logged by the reporter thread
+    auto publishStats = [&]() {
+        StreamStatsReporter::Snapshot snapshot;
+        snapshot.time = t2;
+        snapshot.timestamp = stats.timestamp;
+        snapshot.bytesTransferred = stats.bytesTransferred;
+        snapshot.packets = stats.packets;
+        snapshot.overrun = overrun;
+        snapshot.loss = loss;
+        snapshot.fifoLevel = fifo->size();
+        snapshot.hasDMAState = true;
+        snapshot.dmaSoftwareIndex = dma.swIndex;
+        snapshot.dmaHardwareIndex = dma.hwIndex;
+        mStatsReporter.Publish(TRXDir::Rx, snapshot);
+    };
+    publishStats();
+
     int64_t lastHwIndex = 0;
     int64_t expectedTS = 0;
     SamplesPacketType* outputPkt = nullptr;
@@ -637,48 +670,16 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
         if (dma.hwIndex != lastHwIndex)
         {
             const int bytesTransferred = (dma.hwIndex - lastHwIndex) * readSize;
-            Bps += bytesTransferred;
             stats.bytesTransferred += bytesTransferred;
             lastHwIndex = dma.hwIndex;
         }
 
-        // print stats
         t2 = perfClock::now();
         auto timePeriod = duration_cast<milliseconds>(t2 - t1).count();
         if (timePeriod >= statsPeriod_ms)
         {
             t1 = t2;
-            double dataRateBps = 1000.0 * Bps / timePeriod;
-            stats.dataRate_Bps = dataRateBps;
-            mRx.stats.dataRate_Bps = dataRateBps;
-
-            char msg[512];
-            snprintf(msg,
-                sizeof(msg) - 1,
-                "%s Rx: %3.3f MB/s | TS:%li pkt:%li o:%i(%+i) l:%i(%+i) dma:%u/%u(%u) swFIFO:%li",
-                mRxArgs.port->GetPathName().c_str(),
-                stats.dataRate_Bps / 1e6,
-                stats.timestamp,
-                stats.packets,
-                overrun.value(),
-                overrun.delta(),
-                loss.value(),
-                loss.delta(),
-                dma.swIndex,
-                dma.hwIndex,
-                dma.hwIndex - dma.swIndex,
-                mRx.fifo->size());
-            if (showStats)
-                lime::info("%s", msg);
-            if (mCallback_logMessage)
-            {
-                bool showAsWarning = overrun.delta() || loss.delta();
-                SDRDevice::LogLevel level = showAsWarning ? SDRDevice::LogLevel::WARNING : SDRDevice::LogLevel::DEBUG;
-                mCallback_logMessage(level, msg);
-            }
-            overrun.checkpoint();
-            loss.checkpoint();
-            Bps = 0;
+            publishStats();
         }
 
         uint16_t buffersAvailable = dma.hwIndex - dma.swIndex;
@@ -690,7 +691,7 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
             // jump CPU to 1 buffer behind hardware index, to avoid device starting to write into buffer being read by CPU
             dma.swIndex = (dma.hwIndex - 1);
             ++stats.loss;
-            overrun.add(1);
+            ++overrun;
         }
 
         if (!buffersAvailable)
@@ -711,23 +712,30 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
 
         mRxArgs.port->CacheFlush(false, false, dma.swIndex % bufferCount);
         uint8_t* buffer = dmaBuffers[dma.swIndex % bufferCount];
-        const FPGA_RxDataPacket* pkt = reinterpret_cast<const FPGA_RxDataPacket*>(buffer);
-        if (outputPkt)
-            outputPkt->timestamp = pkt->counter;
-
+        if (mRxRecorder)
+            mRxRecorder->Record(dma.hwIndex, dma.swIndex, buffer);
         const int srcPktCount = mRxArgs.packetsToBatch;
         for (int i = 0; i < srcPktCount; ++i)
         {
-            pkt = reinterpret_cast<const FPGA_RxDataPacket*>(&buffer[packetSize * i]);
+            const FPGA_RxDataPacket* pkt = reinterpret_cast<const FPGA_RxDataPacket*>(&buffer[packetSize * i]);
             if (pkt->counter - expectedTS != 0)
             {
                 //lime::info("Loss: pkt:%i exp: %li, got: %li, diff: %li", stats.packets+i, expectedTS, pkt->counter, pkt->counter-expectedTS);
                 ++stats.loss;
-                loss.add(1);
+                ++loss;
             }
-            if (pkt->txWasDropped())
+            if (pkt->txWasDropped() && mTxBurstEnd.load(std::memory_order_relaxed) != txBurstIdle)
                 ++mTx.stats.loss;
 
+            // StreamRx() would drop it anyway
+            if (IsBeforeRxSeek(pkt->counter, samplesInPkt))
+            {
+                expectedTS = pkt->counter + samplesInPkt;
+                continue;
+            }
+
+            if (outputPkt->empty())
+                outputPkt->timestamp = pkt->counter;
             const int payloadSize = packetSize - 16;
             const int samplesProduced = Deinterleave(outputPkt->back(), pkt->data, payloadSize, conversion);
             outputPkt->SetSize(outputPkt->size() + samplesProduced);
@@ -736,8 +744,12 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
         stats.packets += srcPktCount;
         stats.timestamp = expectedTS;
         mRx.lastTimestamp.store(expectedTS, std::memory_order_relaxed);
+        int64_t txBurstEnd = mTxBurstEnd.load(std::memory_order_relaxed);
+        // the hardware has transmitted the whole Tx burst, fails if the Tx thread has started the next one meanwhile
+        if (txBurstEnd >= 0 && expectedTS >= txBurstEnd)
+            mTxBurstEnd.compare_exchange_strong(txBurstEnd, txBurstIdle, std::memory_order_relaxed);
 
-        if (outputPkt)
+        if (outputPkt && !outputPkt->empty())
         {
             if (mConfig.extraConfig.negateQ)
             {
@@ -753,6 +765,8 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
                     break;
                 }
             }
+            CorrectRx(outputPkt);
+            DecimateRx(outputPkt);
             if (fifo->push(outputPkt, false))
             {
                 //maxFIFOlevel = std::max(maxFIFOlevel, (int)rxFIFO.size());
@@ -775,7 +789,7 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
         ++mRxArgs.cnt;
         // one callback for the entire batch
         if (reportProblems && mConfig.statusCallback)
-            mConfig.statusCallback(false, &stats, mConfig.userData);
+            mStatsReporter.PublishStatus(TRXDir::Rx, stats);
         std::this_thread::yield();
     }
 
@@ -790,6 +804,22 @@ void TRXLooper_PCIE::ReceivePacketsLoop()
 void TRXLooper_PCIE::RxTeardown()
 {
     mRxArgs.port->RxDMAEnable(false, mRxArgs.bufferSize, 1);
+    if (mRxRecorder)
+        mRxRecorder->Close();
+}
+
+static std::size_t SampleSize(SDRDevice::StreamConfig::DataFormat format)
+{
+    switch (format)
+    {
+    case SDRDevice::StreamConfig::DataFormat::F32:
+        return sizeof(complex32f_t);
+    case SDRDevice::StreamConfig::DataFormat::I12:
+        return sizeof(complex12_t);
+    case SDRDevice::StreamConfig::DataFormat::I16:
+    default:
+        return sizeof(complex16_t);
+    }
 }
 
 /// @copydoc SDRDevice::UploadTxWaveform()
@@ -802,10 +832,48 @@ OpStatus TRXLooper_PCIE::UploadTxWaveform(FPGA* fpga,
     const void** samples,
     uint32_t count)
 {
-    const int samplesInPkt = 256;
-    const bool useChannelB = config.channels.at(lime::TRXDir::Tx).size() > 1;
+    const std::size_t sampleSize = SampleSize(config.format);
+    const std::size_t channelCount = config.channels.at(lime::TRXDir::Tx).size() == 2 ? 2 : 1;
+    uint32_t offset = 0;
+    auto source = [&](void* const* dest, uint32_t maxCount) {
+        const uint32_t toCopy = std::min(maxCount, count - offset);
+        for (std::size_t ch = 0; ch < channelCount; ++ch)
+            std::memcpy(dest[ch], static_cast<const uint8_t*>(samples[ch]) + offset * sampleSize, toCopy * sampleSize);
+        offset += toCopy;
+        return toCopy;
+    };
+    return UploadTxWaveform(fpga, port, config, moduleIndex, source, count);
+}
+
+/** @brief Uploads the waveform into the FPGA's replay buffer, reading it from the source in bounded chunks.
+    The next chunk is read while the current one is converted straight into the DMA buffers.
+    @param fpga The FPGA to upload the waveform to.
+    @param port The PCIe port to transfer the samples through.
+    @param config The stream configuration of the waveform.
+    @param moduleIndex The index of the module to upload to.
+    @param source The function supplying the samples.
+    @param count The total amount of samples in each channel.
+    @param progress The function to report the progress to, or to cancel the upload with (optional).
+    @return The status of the operation, OpStatus::ABORTED if the upload was cancelled.
+ */
+OpStatus TRXLooper_PCIE::UploadTxWaveform(FPGA* fpga,
+    std::shared_ptr<LitePCIe> port,
+    const lime::SDRDevice::StreamConfig& config,
+    uint8_t moduleIndex,
+    SDRDevice::TxWaveformSource source,
+    uint64_t count,
+    SDRDevice::TxWaveformProgressCallback progress)
+{
+    const uint32_t samplesInPkt = 256;
+    const uint32_t chunkSamples = samplesInPkt * 64;
     const bool mimo = config.channels.at(lime::TRXDir::Tx).size() == 2;
-    const bool compressed = config.linkFormat == SDRDevice::StreamConfig::DataFormat::I12;
+    const std::size_t sampleSize = SampleSize(config.format);
+
+    DataConversion conversion;
+    conversion.srcFormat = config.format;
+    conversion.destFormat = config.linkFormat;
+    conversion.channelCount = mimo ? 2 : 1;
+
     fpga->WriteRegister(0xFFFF, 1 << moduleIndex);
     fpga->WriteRegister(0x000C, mimo ? 0x3 : 0x1); //channels 0,1
     if (config.linkFormat == SDRDevice::StreamConfig::DataFormat::I16)
@@ -820,78 +888,157 @@ OpStatus TRXLooper_PCIE::UploadTxWaveform(FPGA* fpga,
     for (uint32_t i = 0; i < dmaBuffers.size(); ++i)
         dmaBuffers[i] = dma.txMemory + dma.bufferSize * i;
 
+    // two chunks, one being filled by the source while the other is transferred
+    std::vector<uint8_t> chunkMemory[2][2];
+    std::array<void*, 2> chunkPointers[2];
+    for (int c = 0; c < 2; ++c)
+    {
+        for (int ch = 0; ch < conversion.channelCount; ++ch)
+        {
+            chunkMemory[c][ch].resize(chunkSamples * sampleSize);
+            chunkPointers[c][ch] = chunkMemory[c][ch].data();
+        }
+    }
+    auto readChunk = [&](int c) {
+        return std::async(std::launch::async, [&, c]() { return source(chunkPointers[c].data(), chunkSamples); });
+    };
+
     port->TxDMAEnable(true);
 
-    uint32_t samplesRemaining = count;
+    OpStatus status = OpStatus::SUCCESS;
+    uint64_t samplesSent = 0;
     uint8_t dmaIndex = 0;
     LitePCIe::DMAState state;
     state.swIndex = 0;
 
-    while (samplesRemaining > 0)
+    int currentChunk = 0;
+    std::future<uint32_t> pendingChunk = readChunk(currentChunk);
+    while (status == OpStatus::SUCCESS && samplesSent < count)
     {
-        state = port->GetTxDMAState();
-        port->WaitTx(); // block until there is a free DMA buffer
-
-        int samplesToSend = samplesRemaining > samplesInPkt ? samplesInPkt : samplesRemaining;
-        int samplesDataSize = 0;
+        const uint32_t chunkSize = std::min<uint64_t>(pendingChunk.get(), count - samplesSent);
+        if (chunkSize == 0)
+            break;
+        const int nextChunk = currentChunk ^ 1;
+        if (samplesSent + chunkSize < count)
+            pendingChunk = readChunk(nextChunk);
+
+        uint32_t chunkOffset = 0;
+        while (chunkOffset < chunkSize)
+        {
+            state = port->GetTxDMAState();
+            port->WaitTx(); // block until there is a free DMA buffer
 
-        port->CacheFlush(true, false, dmaIndex);
-        FPGA_TxDataPacket* pkt = reinterpret_cast<FPGA_TxDataPacket*>(dmaBuffers[dmaIndex]);
-        pkt->counter = 0;
-        pkt->reserved[0] = 0;
+            const uint32_t samplesToSend = std::min(chunkSize - chunkOffset, samplesInPkt);
+            const void* src[2];
+            for (int ch = 0; ch < conversion.channelCount; ++ch)
+                src[ch] = chunkMemory[currentChunk][ch].data() + chunkOffset * sampleSize;
 
-        if (config.format == SDRDevice::StreamConfig::DataFormat::I16)
-        {
-            const lime::complex16_t* src[2] = { &static_cast<const lime::complex16_t*>(samples[0])[count - samplesRemaining],
-                useChannelB ? &static_cast<const lime::complex16_t*>(samples[1])[count - samplesRemaining] : nullptr };
-            samplesDataSize = FPGA::Samples2FPGAPacketPayload(src, samplesToSend, mimo, compressed, pkt->data);
-        }
-        else if (config.format == SDRDevice::StreamConfig::DataFormat::F32)
-        {
-            const lime::complex32f_t* src[2] = { &static_cast<const lime::complex32f_t*>(samples[0])[count - samplesRemaining],
-                useChannelB ? &static_cast<const lime::complex32f_t*>(samples[1])[count - samplesRemaining] : nullptr };
-            samplesDataSize = FPGA::Samples2FPGAPacketPayloadFloat(src, samplesToSend, mimo, compressed, pkt->data);
-        }
+            port->CacheFlush(true, false, dmaIndex);
+            FPGA_TxDataPacket* pkt = reinterpret_cast<FPGA_TxDataPacket*>(dmaBuffers[dmaIndex]);
+            pkt->counter = 0;
+            const int samplesDataSize = Interleave(pkt->data, src, samplesToSend, conversion);
 
-        int payloadSize = (samplesDataSize / 4) * 4;
-        if (samplesDataSize % 4 != 0)
-            lime::warning("Packet samples count not multiple of 4");
-        pkt->reserved[2] = (payloadSize >> 8) & 0xFF; //WFM loading
-        pkt->reserved[1] = payloadSize & 0xFF; //WFM loading
-        pkt->reserved[0] = 0x1 << 5; //WFM loading
+            int payloadSize = (samplesDataSize / 4) * 4;
+            if (samplesDataSize % 4 != 0)
+                lime::warning("Packet samples count not multiple of 4");
+            pkt->reserved[2] = (payloadSize >> 8) & 0xFF; //WFM loading
+            pkt->reserved[1] = payloadSize & 0xFF; //WFM loading
+            pkt->reserved[0] = 0x1 << 5; //WFM loading
 
-        port->CacheFlush(true, true, dmaIndex);
+            port->CacheFlush(true, true, dmaIndex);
 
-        state.swIndex = dmaIndex;
-        state.bufferSize = 16 + payloadSize;
-        state.genIRQ = (dmaIndex % 4) == 0;
+            state.swIndex = dmaIndex;
+            state.bufferSize = 16 + payloadSize;
+            state.genIRQ = (dmaIndex % 4) == 0;
 
-        // DMA memory is write only, to read from the buffer will trigger Bus errors
-        int ret = port->SetTxDMAState(state);
-        if (ret)
-        {
-            if (errno == EINVAL)
+            // DMA memory is write only, to read from the buffer will trigger Bus errors
+            int ret = port->SetTxDMAState(state);
+            if (ret)
             {
-                port->TxDMAEnable(false);
-                return ReportError(OpStatus::IO_FAILURE, "Failed to submit dma write (%i) %s", errno, strerror(errno));
+                if (errno == EINVAL)
+                {
+                    status = ReportError(OpStatus::IO_FAILURE, "Failed to submit dma write (%i) %s", errno, strerror(errno));
+                    break;
+                }
+            }
+            else
+            {
+                chunkOffset += samplesToSend;
+                samplesSent += samplesToSend;
+                dmaIndex = (dmaIndex + 1) % dma.bufferCount;
             }
         }
-        else
-        {
-            samplesRemaining -= samplesToSend;
-            dmaIndex = (dmaIndex + 1) % dma.bufferCount;
-        }
+
+        if (status == OpStatus::SUCCESS && progress && !progress(samplesSent, count))
+            status = OpStatus::ABORTED;
+        currentChunk = nextChunk;
     }
+    // the source may still be filling the other chunk
+    if (pendingChunk.valid())
+        pendingChunk.wait();
 
-    /*Give some time to load samples to FPGA*/
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    if (status == OpStatus::SUCCESS)
+    {
+        /*Give some time to load samples to FPGA*/
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
     port->TxDMAEnable(false);
 
     fpga->WriteRegister(0x000D, 0); // WFM_LOAD off
-    if (samplesRemaining == 0)
-        return OpStatus::SUCCESS;
-    else
+    if (status != OpStatus::SUCCESS)
+        return status;
+    if (samplesSent < count)
         return ReportError(OpStatus::ERROR, "Failed to upload waveform");
+    return OpStatus::SUCCESS;
+}
+
+/** @brief Uploads a waveform file into the FPGA's replay buffer without loading the whole file into memory.
+    The file holds raw samples in the StreamConfig::format, with the channels interleaved sample by sample.
+    @param fpga The FPGA to upload the waveform to.
+    @param port The PCIe port to transfer the samples through.
+    @param config The stream configuration of the waveform.
+    @param moduleIndex The index of the module to upload to.
+    @param filename The path of the waveform file.
+    @param progress The function to report the progress to, or to cancel the upload with (optional).
+    @return The status of the operation.
+ */
+OpStatus TRXLooper_PCIE::UploadTxWaveformFile(FPGA* fpga,
+    std::shared_ptr<LitePCIe> port,
+    const lime::SDRDevice::StreamConfig& config,
+    uint8_t moduleIndex,
+    const std::string& filename,
+    SDRDevice::TxWaveformProgressCallback progress)
+{
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return ReportError(OpStatus::FILE_NOT_FOUND, "Failed to open waveform file %s", filename.c_str());
+
+    const std::size_t sampleSize = SampleSize(config.format);
+    const std::size_t channelCount = config.channels.at(lime::TRXDir::Tx).size() == 2 ? 2 : 1;
+    const std::size_t frameSize = sampleSize * channelCount;
+    const uint64_t count = static_cast<uint64_t>(file.tellg()) / frameSize;
+    file.seekg(0);
+
+    std::vector<uint8_t> frames;
+    auto source = [&](void* const* dest, uint32_t maxCount) -> uint32_t {
+        frames.resize(static_cast<std::size_t>(maxCount) * frameSize);
+        file.read(reinterpret_cast<char*>(frames.data()), frames.size());
+        const uint32_t framesRead = file.gcount() / frameSize;
+        if (channelCount == 1)
+        {
+            std::memcpy(dest[0], frames.data(), framesRead * sampleSize);
+            return framesRead;
+        }
+        for (uint32_t i = 0; i < framesRead; ++i)
+        {
+            for (std::size_t ch = 0; ch < channelCount; ++ch)
+            {
+                std::memcpy(static_cast<uint8_t*>(dest[ch]) + i * sampleSize, &frames[i * frameSize + ch * sampleSize], sampleSize);
+            }
+        }
+        return framesRead;
+    };
+    return UploadTxWaveform(fpga, port, config, moduleIndex, source, count, progress);
 }
 
 } // namespace lime
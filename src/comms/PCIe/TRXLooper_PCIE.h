@@ -1,6 +1,9 @@
 #ifndef TRXLooper_PCIE_H
 #define TRXLooper_PCIE_H
 
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "TRXLooper.h"
@@ -9,6 +12,7 @@
 
 namespace lime {
 
+class DMARecorder;
 class LitePCIe;
 
 /** @brief Class responsible for receiving and transmitting continuous sample data from a PCIe device */
@@ -27,6 +31,19 @@ class TRXLooper_PCIE : public TRXLooper
         uint8_t moduleIndex,
         const void** samples,
         uint32_t count);
+    static OpStatus UploadTxWaveform(FPGA* fpga,
+        std::shared_ptr<LitePCIe> port,
+        const SDRDevice::StreamConfig& config,
+        uint8_t moduleIndex,
+        SDRDevice::TxWaveformSource source,
+        uint64_t count,
+        SDRDevice::TxWaveformProgressCallback progress = nullptr);
+    static OpStatus UploadTxWaveformFile(FPGA* fpga,
+        std::shared_ptr<LitePCIe> port,
+        const SDRDevice::StreamConfig& config,
+        uint8_t moduleIndex,
+        const std::string& filename,
+        SDRDevice::TxWaveformProgressCallback progress = nullptr);
 
     /** @brief The transfer arguments for the PCIe transfer. */
     struct TransferArgs {
@@ -52,6 +69,9 @@ class TRXLooper_PCIE : public TRXLooper
 
     TransferArgs mRxArgs;
     TransferArgs mTxArgs;
+
+    /// Records the raw Rx DMA buffers, if requested by the stream configuration.
+    std::unique_ptr<DMARecorder> mRxRecorder;
 };
 
 } // namespace lime
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <numeric>
 
 #include "BufferInterleaving.h"
 #include "limesuite/SDRDevice.h"
@@ -18,12 +19,12 @@ template<class T> class TxBufferManager
 {
   public:
     /// @brief Constructs a new TxBufferManager object.
-    /// @param mimo Whether the stream is a Multiple In Multiple Out (MIMO) stream.
+    /// @param channelCount The amount of channels interleaved in the stream.
     /// @param compressed Whether the stream is in 12-bit or in 16-bit format (true for 12-bit).
     /// @param maxSamplesInPkt The maximum amount of samples allowed in a single packet.
     /// @param maxPacketsInBatch The maximum amount of packets allowed in a single transfer batch.
     /// @param inputFormat The input format of the samples for the device.
-    TxBufferManager(bool mimo,
+    TxBufferManager(uint8_t channelCount,
         bool compressed,
         uint32_t maxSamplesInPkt,
         uint32_t maxPacketsInBatch,
@@ -37,12 +38,17 @@ template<class T> class TxBufferManager
         , maxSamplesInPkt(maxSamplesInPkt)
         , packetsCreated(0)
         , payloadSize(0)
+        , burstEnded(false)
     {
-        bytesForFrame = (compressed ? 3 : 4) * (mimo ? 2 : 1);
+        bytesForFrame = (compressed ? 3 : 4) * channelCount;
         conversion.srcFormat = inputFormat; //SDRDevice::StreamConfig::DataFormat::F32;
         conversion.destFormat = compressed ? SDRDevice::StreamConfig::DataFormat::I12 : SDRDevice::StreamConfig::DataFormat::I16;
-        conversion.channelCount = mimo ? 2 : 1;
+        conversion.channelCount = channelCount;
         maxPayloadSize = std::min(4080u, bytesForFrame * maxSamplesInPkt);
+        // full packets end on the bus width, so the following packet can be placed right after them
+        const uint32_t alignedPayloadStep = std::lcm<uint32_t>(bytesForFrame, busWidthBytes);
+        if (maxPayloadSize >= alignedPayloadStep)
+            maxPayloadSize -= maxPayloadSize % alignedPayloadStep;
     }
 
     /// @brief Resets the buffer to point to an empty buffer.
@@ -52,6 +58,7 @@ template<class T> class TxBufferManager
     {
         packetsCreated = 0;
         bytesUsed = 0;
+        burstEnded = false;
         mData = memPtr;
         mCapacity = capacity;
         std::memset(mData, 0, capacity);
@@ -65,9 +72,10 @@ template<class T> class TxBufferManager
     /// @return Whether there still is space or not.
     constexpr bool hasSpace() const
     {
-        const bool packetNotFull = payloadSize < maxPayloadSize;
         const bool spaceAvailable = mCapacity - bytesUsed > sizeof(StreamHeader);
-        return packetNotFull && spaceAvailable;
+        if (!packetFull())
+            return spaceAvailable;
+        return spaceAvailable && canStartPacket();
     }
 
     /// @brief Adds samples from the given source packet into the transfer.
@@ -78,8 +86,13 @@ template<class T> class TxBufferManager
         bool sendBuffer = false;
         while (!src->empty())
         {
-            if (payloadSize >= maxPayloadSize || payloadSize == maxSamplesInPkt * bytesForFrame)
+            if (payloadSize > 0 && (packetFull() || !continuesPacket(*src)))
             {
+                if (!canStartPacket())
+                {
+                    sendBuffer = true;
+                    break;
+                }
                 header = reinterpret_cast<StreamHeader*>(mData + bytesUsed);
                 header->Clear();
                 payloadPtr = reinterpret_cast<uint8_t*>(header) + sizeof(StreamHeader);
@@ -110,37 +123,28 @@ template<class T> class TxBufferManager
             else
                 sendBuffer = true;
 
-            if (packetsCreated >= maxPacketsInBatch && !hasSpace())
-                sendBuffer = true;
-
-            if (bytesUsed >= mCapacity - sizeof(StreamHeader))
-                sendBuffer = true; // not enough space for more packets, need to flush
-            if (reinterpret_cast<uint64_t>(payloadPtr) & 0xF)
-                sendBuffer = true; // next packets payload memory is not suitably aligned for vectorized filling
-
+            if (!hasSpace())
+                sendBuffer = true; // the batch is complete or no other packet fits
             if (sendBuffer)
-            {
-                const int busWidthBytes = 16;
-                int extraBytes = bytesUsed % busWidthBytes;
-                if (extraBytes != 0)
-                {
-                    //printf("Patch buffer, bytes %i, extra: %i, last payload: %i\n", bytesUsed, extraBytes, payloadSize);
-                    // patch last packet so that whole buffer size would be multiple of bus width
-                    int padding = busWidthBytes - extraBytes;
-                    std::memset(payloadPtr, 0, padding);
-                    payloadSize += padding;
-                    bytesUsed += padding;
-                    header->SetPayloadSize(payloadSize);
-                    //printf("Patch buffer, bytes %i, last payload: %i\n", bytesUsed, payloadSize);
-                }
                 break;
-            }
         }
-        if (!hasSpace())
-            return true;
-        return src->flush || sendBuffer;
+        if (src->endOfBurst && src->empty())
+            burstEnded = true; // nothing follows the burst, so the last packet goes out now instead of waiting for more samples
+
+        const bool send = sendBuffer || burstEnded || src->flush;
+        if (send)
+            PadToBusWidth();
+        return send;
     }
 
+    /// @brief Gets whether the transfer holds the end of a Tx burst.
+    /// @return True if the last consumed packet ended a burst.
+    constexpr bool endsBurst() const { return burstEnded; };
+
+    /// @brief Gets the timestamp following the last sample of the transfer, including the padding.
+    /// @return The timestamp of the sample the hardware transmits after this transfer.
+    int64_t endTimestamp() const { return header->counter + payloadSize / bytesForFrame; };
+
     /// @brief Gets the current size of the transfer.
     /// @return The amount of bytes this transfer is currently using.
     constexpr uint32_t size() const { return bytesUsed; };
@@ -154,6 +158,43 @@ template<class T> class TxBufferManager
     constexpr uint16_t packetCount() const { return packetsCreated; };
 
   private:
+    static constexpr uint32_t busWidthBytes = 16;
+
+    /// @brief Checks if the current packet can not take any more samples.
+    constexpr bool packetFull() const { return payloadSize >= maxPayloadSize; }
+
+    /// @brief Checks if another packet can be appended after the current one.
+    constexpr bool canStartPacket() const
+    {
+        // the packet header has to be aligned to the bus width
+        return packetsCreated < maxPacketsInBatch && bytesUsed % busWidthBytes == 0 &&
+               mCapacity - bytesUsed > 2 * sizeof(StreamHeader);
+    }
+
+    /// @brief Checks if the source samples are a direct continuation of the current packet.
+    /// @param src The source packet to check.
+    /// @return False if the samples need a packet with a different timestamp.
+    bool continuesPacket(const T& src) const
+    {
+        if (src.useTimestamp == header->getIgnoreTimestamp())
+            return false;
+        return !src.useTimestamp || src.timestamp == static_cast<uint64_t>(header->counter) + payloadSize / bytesForFrame;
+    }
+
+    /// @brief Patches the last packet so that the whole buffer size would be a multiple of the bus width.
+    void PadToBusWidth()
+    {
+        int extraBytes = bytesUsed % busWidthBytes;
+        if (extraBytes == 0)
+            return;
+        int padding = busWidthBytes - extraBytes;
+        std::memset(payloadPtr, 0, padding);
+        payloadPtr += padding;
+        payloadSize += padding;
+        bytesUsed += padding;
+        header->SetPayloadSize(payloadSize);
+    }
+
     DataConversion conversion;
     StreamHeader* header;
     uint8_t* payloadPtr;
@@ -166,6 +207,7 @@ template<class T> class TxBufferManager
     uint16_t packetsCreated;
     uint32_t payloadSize;
     uint8_t bytesForFrame;
+    bool burstEnded;
 };
 
 } // namespace lime
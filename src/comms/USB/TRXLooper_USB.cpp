@@ -24,6 +24,7 @@ TRXLooper_USB::TRXLooper_USB(std::shared_ptr<USBGeneric> comms, FPGA* f, LMS7002
     , rxEndPt(rxEndPt)
     , txEndPt(txEndPt)
 {
+    mStatsReporter.SetLogToInfo(true);
 }
 
 TRXLooper_USB::~TRXLooper_USB()
@@ -51,6 +52,9 @@ OpStatus TRXLooper_USB::Setup(const lime::SDRDevice::StreamConfig& config)
 {
     mConfig = config;
 
+    // transfer completions gate the streaming threads, so the event thread is scheduled like them
+    comms->SetEventsThreadPriority(ThreadPriority::HIGHEST, ThreadPolicy::PREEMPTIVE, config.extraConfig.usbEventsCpu);
+
     if (config.channels.at(TRXDir::Rx).size() > 0)
     {
         RxSetup();
@@ -119,10 +123,6 @@ void TRXLooper_USB::TransmitPacketsLoop()
     std::vector<uint8_t> buffers(batchCount * bufferSize, 0);
     int bufferIndex = 0;
 
-    auto t1 = std::chrono::high_resolution_clock::now();
-    auto t2 = t1;
-    uint64_t totalBytesSent = 0; //for data rate calculation
-
     SamplesPacketType* srcPkt = nullptr;
 
     bool isBufferFull = false;
@@ -133,8 +133,7 @@ void TRXLooper_USB::TransmitPacketsLoop()
     const bool packed = mConfig.linkFormat == SDRDevice::StreamConfig::DataFormat::I12;
     uint32_t samplesInPkt = (packed ? 1360 : 1020) / conversion.channelCount;
 
-    const bool mimo = std::max(mConfig.channels.at(lime::TRXDir::Tx).size(), mConfig.channels.at(lime::TRXDir::Rx).size()) > 1;
-    const int bytesForFrame = (packed ? 3 : 4) * (mimo ? 2 : 1);
+    const int bytesForFrame = (packed ? 3 : 4) * conversion.channelCount;
     uint32_t maxPayloadSize = std::min(4080u, bytesForFrame * samplesInPkt);
 
     const uint8_t safeTxEndPt = txEndPt; // To make sure no undefined behaviour happens when killing the thread
@@ -147,6 +146,24 @@ void TRXLooper_USB::TransmitPacketsLoop()
         lock.unlock();
     }
 
+    auto t1 = std::chrono::steady_clock::now();
+    auto t2 = t1;
+
+    // the statistics are formatted and logged by the reporter thread
+    auto publishStats = [&]() {
+        StreamStatsReporter::Snapshot snapshot;
+        snapshot.time = t2;
+        snapshot.timestamp = mTx.stats.timestamp;
+        snapshot.bytesTransferred = mTx.stats.bytesTransferred;
+        snapshot.packets = mTx.stats.packets;
+        snapshot.overrun = mTx.stats.overrun;
+        snapshot.underrun = mTx.stats.underrun;
+        snapshot.loss = mTx.stats.loss;
+        snapshot.fifoLevel = mTx.fifo->size();
+        mStatsReporter.Publish(TRXDir::Tx, snapshot);
+    };
+    publishStats();
+
     StreamHeader* header = reinterpret_cast<StreamHeader*>(&buffers[bufferIndex * bufferSize]);
     uint8_t* payloadPtr = reinterpret_cast<uint8_t*>(header) + sizeof(StreamHeader);
 
@@ -158,7 +175,6 @@ void TRXLooper_USB::TransmitPacketsLoop()
             if (comms->WaitForXfer(handles[bufferIndex], timeToWaitMs))
             {
                 int bytesSent = comms->FinishDataXfer(&buffers[bufferIndex * bufferSize], bufferSize, handles[bufferIndex]);
-                totalBytesSent += bytesSent;
                 mTx.stats.bytesTransferred += bytesSent;
                 handles[bufferIndex] = -1;
                 mTx.stats.packets++;
@@ -243,23 +259,15 @@ void TRXLooper_USB::TransmitPacketsLoop()
             }
         }
 
-        t2 = std::chrono::high_resolution_clock::now();
-        auto timePeriod = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
-
-        if (timePeriod >= std::chrono::milliseconds(1000))
+        t2 = std::chrono::steady_clock::now();
+        if (t2 - t1 >= std::chrono::milliseconds(1000))
         {
             t1 = t2;
-
-            float dataRate = 1000.0 * totalBytesSent / timePeriod.count();
-            lime::info("Tx: %.3f MB/s", dataRate / 1000000.0);
-            totalBytesSent = 0;
-
-            mTx.stats.dataRate_Bps = dataRate;
+            publishStats();
         }
     }
 
     comms->AbortEndpointXfers(safeTxEndPt);
-    mTx.stats.dataRate_Bps = 0;
 }
 
 int TRXLooper_USB::RxSetup()
@@ -270,8 +278,10 @@ int TRXLooper_USB::RxSetup()
     const int samplesInPkt = (mConfig.linkFormat == SDRDevice::StreamConfig::DataFormat::I16 ? 1020 : 1360) / channelCount;
     const uint8_t packetsToBatch = mRx.packetsToBatch;
 
+    // the channelizer can deliver more channels than it receives
+    const int outputChannelCount = std::max<int>(channelCount, GetRxOutputChannelCount());
     const int upperAllocationLimit =
-        sizeof(complex32f_t) * packetsToBatch * samplesInPkt * channelCount + SamplesPacketType::headerSize;
+        sizeof(complex32f_t) * packetsToBatch * samplesInPkt * outputChannelCount + SamplesPacketType::headerSize;
 
     const int memPoolBlockCount = 1024;
     const int memPoolAlignment = 4096;
@@ -320,9 +330,22 @@ void TRXLooper_USB::ReceivePacketsLoop()
         lock.unlock();
     }
 
-    auto t1 = std::chrono::high_resolution_clock::now();
+    auto t1 = std::chrono::steady_clock::now();
     auto t2 = t1;
-    uint64_t totalBytesReceived = 0; //for data rate calculation
+
+    // the statistics are formatted and logged by the reporter thread
+    auto publishStats = [&]() {
+        StreamStatsReporter::Snapshot snapshot;
+        snapshot.time = t2;
+        snapshot.timestamp = stats.timestamp;
+        snapshot.bytesTransferred = stats.bytesTransferred;
+        snapshot.packets = stats.packets;
+        snapshot.overrun = stats.overrun;
+        snapshot.loss = stats.loss;
+        snapshot.fifoLevel = mRx.fifo->size();
+        mStatsReporter.Publish(TRXDir::Rx, snapshot);
+    };
+    publishStats();
 
     for (int i = 0; i < batchCount; ++i)
     {
@@ -340,7 +363,6 @@ void TRXLooper_USB::ReceivePacketsLoop()
             {
                 bytesReceived = comms->FinishDataXfer(&buffers[bufferIndex * bufferSize], bufferSize, handles[bufferIndex]);
                 stats.packets++;
-                totalBytesReceived += bytesReceived;
                 stats.bytesTransferred += bytesReceived;
 
                 if (bytesReceived != bufferSize)
@@ -385,6 +407,15 @@ void TRXLooper_USB::ReceivePacketsLoop()
                 ++mTx.stats.loss;
             }
 
+            // StreamRx() would drop it anyway
+            if (IsBeforeRxSeek(pkt->counter, samplesInPkt))
+            {
+                expectedTS = pkt->counter + samplesInPkt;
+                mRx.lastTimestamp.store(expectedTS, std::memory_order_relaxed);
+                stats.timestamp = expectedTS;
+                continue;
+            }
+
             int payloadSize = pkt->GetPayloadSize();
 
             if (payloadSize == 256 || payloadSize == 0)
@@ -394,11 +425,14 @@ void TRXLooper_USB::ReceivePacketsLoop()
 
             const int samplesProduced = Deinterleave(outputPkt->back(), pkt->data, payloadSize, conversion);
             outputPkt->SetSize(outputPkt->size() + samplesProduced);
+            outputPkt->timestamp = pkt->counter;
             expectedTS = pkt->counter + samplesProduced;
             mRx.lastTimestamp.store(expectedTS, std::memory_order_relaxed);
             stats.timestamp = expectedTS;
 
             NegateQ(outputPkt, TRXDir::Rx);
+            CorrectRx(outputPkt);
+            DecimateRx(outputPkt);
 
             if (mRx.fifo->push(outputPkt, false))
             {
@@ -418,23 +452,15 @@ void TRXLooper_USB::ReceivePacketsLoop()
         handles[bufferIndex] = comms->BeginDataXfer(&buffers[bufferIndex * bufferSize], bufferSize, rxEndPt);
         bufferIndex = (bufferIndex + 1) % batchCount;
 
-        t2 = std::chrono::high_resolution_clock::now();
-        auto timePeriod = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
-
-        if (timePeriod >= std::chrono::milliseconds(1000))
+        t2 = std::chrono::steady_clock::now();
+        if (t2 - t1 >= std::chrono::milliseconds(1000))
         {
             t1 = t2;
-
-            float dataRate = 1000.0 * totalBytesReceived / timePeriod.count();
-            lime::info("Rx: %.3f MB/s", dataRate / 1000000.0);
-            mRx.stats.dataRate_Bps = dataRate;
-
-            totalBytesReceived = 0;
+            publishStats();
         }
     }
 
     comms->AbortEndpointXfers(safeRxEndPt);
-    mRx.stats.dataRate_Bps = 0;
 }
 
 void TRXLooper_USB::NegateQ(SamplesPacketType* packet, TRXDir direction)
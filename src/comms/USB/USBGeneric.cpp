@@ -2,22 +2,22 @@
 #include "Logger.h"
 
 #include <cassert>
+#ifdef __linux__
+    #include <pthread.h>
+#endif
 
 using namespace std::literals::string_literals;
 
 namespace lime {
 
 #ifdef __unix__
-int USBGeneric::activeUSBconnections = 0;
-std::thread USBGeneric::gUSBProcessingThread{};
-
 void USBGeneric::HandleLibusbEvents()
 {
     struct timeval tv;
     tv.tv_sec = 0;
     tv.tv_usec = 100000;
 
-    while (activeUSBconnections > 0)
+    while (!mEventsTerminate.load(std::memory_order_relaxed))
     {
         int returnCode = libusb_handle_events_timeout_completed(ctx, &tv, NULL);
 
@@ -27,6 +27,31 @@ void USBGeneric::HandleLibusbEvents()
         }
     }
 }
+
+void USBGeneric::StartEventsThread()
+{
+    if (mEventsThread.joinable())
+    {
+        return;
+    }
+
+    mEventsTerminate.store(false, std::memory_order_relaxed);
+    mEventsThread = std::thread(&USBGeneric::HandleLibusbEvents, this);
+    // Transfer completions gate the streaming threads, so service them at the same priority.
+    SetOSThreadPriority(ThreadPriority::HIGHEST, ThreadPolicy::PREEMPTIVE, &mEventsThread);
+    #ifdef __linux__
+    pthread_setname_np(mEventsThread.native_handle(), "lime:USBEvents");
+    #endif
+}
+
+void USBGeneric::StopEventsThread()
+{
+    mEventsTerminate.store(true, std::memory_order_relaxed);
+    if (mEventsThread.joinable())
+    {
+        mEventsThread.join();
+    }
+}
 #endif // __UNIX__
 
 USBGeneric::USBGeneric(void* usbContext)
@@ -35,22 +60,25 @@ USBGeneric::USBGeneric(void* usbContext)
 {
 #ifdef __unix__
     dev_handle = nullptr;
-    ctx = reinterpret_cast<libusb_context*>(usbContext);
+    ctx = nullptr;
+    mEventsTerminate.store(true, std::memory_order_relaxed);
 
-    if (ctx == nullptr)
+    if (usbContext == nullptr)
     {
         return;
     }
 
-    if (activeUSBconnections == 0)
-    {
-        ++activeUSBconnections;
-        gUSBProcessingThread = std::thread(&USBGeneric::HandleLibusbEvents, this);
-    }
-    else
+    // Each device gets a session of its own, so its events are handled without contending
+    // for the event lock of the other devices' sessions.
+    int returnCode = libusb_init(&ctx);
+    if (returnCode < 0)
     {
-        ++activeUSBconnections;
+        lime::error("USBGeneric: libusb_init failed: %s", libusb_strerror(static_cast<libusb_error>(returnCode)));
+        ctx = nullptr;
+        return;
     }
+
+    StartEventsThread();
 #endif
 }
 
@@ -58,15 +86,41 @@ USBGeneric::~USBGeneric()
 {
     Disconnect();
 #ifdef __unix__
-    --activeUSBconnections;
+    StopEventsThread();
 
-    if (activeUSBconnections == 0)
+    if (ctx != nullptr)
     {
-        if (gUSBProcessingThread.joinable())
+        libusb_exit(ctx);
+        ctx = nullptr;
+    }
+#endif
+}
+
+int USBGeneric::SetEventsThreadPriority(ThreadPriority priority, ThreadPolicy policy, int cpuIndex)
+{
+#ifdef __unix__
+    if (!mEventsThread.joinable())
+    {
+        return -1;
+    }
+
+    int status = SetOSThreadPriority(priority, policy, &mEventsThread);
+    #ifdef __linux__
+    if (cpuIndex >= 0)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpuIndex, &cpuset);
+        if (pthread_setaffinity_np(mEventsThread.native_handle(), sizeof(cpu_set_t), &cpuset) != 0)
         {
-            gUSBProcessingThread.join();
+            lime::debug("SetEventsThreadPriority: Failed to set affinity to CPU %i", cpuIndex);
+            status = -1;
         }
     }
+    #endif
+    return status;
+#else
+    return 0;
 #endif
 }
 
@@ -244,25 +298,20 @@ int32_t USBGeneric::ControlTransfer(
 static void process_libusbtransfer(libusb_transfer* trans)
 {
     USBTransferContext* context = static_cast<USBTransferContext*>(trans->user_data);
-    std::unique_lock<std::mutex> lck(context->transferLock);
     switch (trans->status)
     {
     case LIBUSB_TRANSFER_CANCELLED:
-        context->bytesXfered = trans->actual_length;
-        context->done.store(true);
+        context->SignalDone(trans->actual_length);
         break;
     case LIBUSB_TRANSFER_COMPLETED:
-        context->bytesXfered = trans->actual_length;
-        context->done.store(true);
+        context->SignalDone(trans->actual_length);
         break;
     case LIBUSB_TRANSFER_ERROR:
         lime::error("USB TRANSFER ERROR");
-        context->bytesXfered = trans->actual_length;
-        context->done.store(true);
+        context->SignalDone(trans->actual_length);
         break;
     case LIBUSB_TRANSFER_TIMED_OUT:
-        context->bytesXfered = trans->actual_length;
-        context->done.store(true);
+        context->SignalDone(trans->actual_length);
         break;
     case LIBUSB_TRANSFER_OVERFLOW:
         lime::error("USB transfer overflow");
@@ -272,11 +321,9 @@ static void process_libusbtransfer(libusb_transfer* trans)
         break;
     case LIBUSB_TRANSFER_NO_DEVICE:
         lime::error("USB transfer no device");
-        context->done.store(true);
+        context->SignalDone(context->bytesXfered);
         break;
     }
-    lck.unlock();
-    context->cv.notify_one();
 }
 #endif
 
@@ -313,10 +360,7 @@ bool USBGeneric::WaitForXfer(int contextHandle, int32_t timeout_ms)
 #ifdef __unix__
     if (contextHandle >= 0 && contexts[contextHandle].isTransferUsed == true)
     {
-        // Blocking not to waste CPU
-        std::unique_lock<std::mutex> lck(contexts[contextHandle].transferLock);
-        return contexts[contextHandle].cv.wait_for(
-            lck, std::chrono::milliseconds(timeout_ms), [&]() { return contexts[contextHandle].done.load(); });
+        return contexts[contextHandle].WaitDone(timeout_ms);
     }
 #endif
     return true; // There is nothing to wait for (signal wait finished)
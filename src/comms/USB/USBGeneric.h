@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <thread>
 #include "USBTransferContext.h"
+#include "threadHelper.h"
 
 #ifdef __unix__
     #ifdef __GNUC__
@@ -27,9 +29,10 @@ class USBGeneric
     /**
       @brief Construct a new USBGeneric object.
 
-      If this is the first object of this kind being constructed on a UNIX system
-      it also creates the thread to handle USB events.
-      @param usbContext The USB context to use.
+      On UNIX systems, if a USB context is given, the object opens its own libusb session
+      and creates a thread dedicated to handling this device's USB events, so that transfer
+      completions of several devices are not serialized through one thread.
+      @param usbContext The USB context of the device registry (nullptr to not handle any USB events).
      */
     USBGeneric(void* usbContext);
     virtual ~USBGeneric();
@@ -109,6 +112,15 @@ class USBGeneric
      */
     virtual void AbortEndpointXfers(uint8_t endPointAddr);
 
+    /**
+      @brief Sets the scheduling of the thread handling this device's USB events.
+      @param priority The priority of the thread.
+      @param policy The scheduling policy of the thread.
+      @param cpuIndex The CPU core to pin the thread to (-1 to leave the affinity unchanged).
+      @return 0 on success, (-1) on failure.
+     */
+    int SetEventsThreadPriority(ThreadPriority priority, ThreadPolicy policy, int cpuIndex = -1);
+
   protected:
     static const int USB_MAX_CONTEXTS{ 16 }; //maximum number of contexts for asynchronous transfers
 
@@ -121,12 +133,14 @@ class USBGeneric
     virtual void WaitForXfers(uint8_t endPointAddr);
 
 #ifdef __unix__
-    static int activeUSBconnections;
-    static std::thread gUSBProcessingThread;
-
     libusb_device_handle* dev_handle; //a device handle
-    libusb_context* ctx; //a libusb session
+    libusb_context* ctx; //a libusb session, owned by this device
+
+    std::thread mEventsThread; ///< The thread handling this device's USB events.
+    std::atomic<bool> mEventsTerminate;
 
+    void StartEventsThread();
+    void StopEventsThread();
     virtual void HandleLibusbEvents();
 #endif
 };
@@ -1,5 +1,8 @@
 #include "USBTransferContext.h"
 
+#include <chrono>
+#include <thread>
+
 using namespace lime;
 
 USBTransferContext::USBTransferContext()
@@ -9,6 +12,7 @@ USBTransferContext::USBTransferContext()
     transfer = libusb_alloc_transfer(0);
     bytesXfered = 0;
     done.store(false);
+    waiting.store(false);
 #endif
 }
 
@@ -30,3 +34,41 @@ bool USBTransferContext::Reset()
 {
     return !isTransferUsed;
 }
+
+#ifdef __unix__
+void USBTransferContext::SignalDone(long bytesTransferred)
+{
+    bytesXfered = bytesTransferred;
+    done.store(true);
+    // Only take the lock if someone is actually sleeping on the condition variable,
+    // otherwise the completion is just a store that the waiter picks up by polling.
+    if (waiting.load())
+    {
+        {
+            std::lock_guard<std::mutex> lck(transferLock);
+        }
+        cv.notify_one();
+    }
+}
+
+bool USBTransferContext::WaitDone(int32_t timeout_ms)
+{
+    // Transfers usually complete shortly after being waited on, so spin for a little while
+    // before falling back to the blocking wait.
+    constexpr int spinCount = 64;
+    for (int i = 0; i < spinCount; ++i)
+    {
+        if (done.load(std::memory_order_acquire))
+        {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lck(transferLock);
+    waiting.store(true);
+    const bool finished = cv.wait_for(lck, std::chrono::milliseconds(timeout_ms), [&]() { return done.load(); });
+    waiting.store(false);
+    return finished;
+}
+#endif
@@ -2,6 +2,7 @@
 #define LIME_USBTRANSFERCONTEXT_H
 
 #include <atomic>
+#include <cstdint>
 #include <condition_variable>
 #include <mutex>
 
@@ -34,9 +35,23 @@ class USBTransferContext
     bool isTransferUsed; ///< A flag to mark if this transfer is currently being used.
 
 #ifdef __unix__
+    /**
+      @brief Marks the transfer as finished and wakes up the waiting thread, if there is one.
+      @param bytesTransferred The amount of bytes transferred.
+     */
+    void SignalDone(long bytesTransferred);
+
+    /**
+      @brief Waits until the transfer is marked as finished.
+      @param timeout_ms The amount of time to wait (in ms).
+      @return Whether the transfer has finished (true = finished).
+     */
+    bool WaitDone(int32_t timeout_ms);
+
     libusb_transfer* transfer;
     long bytesXfered;
     std::atomic<bool> done;
+    std::atomic<bool> waiting; ///< Set while a thread is blocked on the condition variable.
     std::mutex transferLock;
     std::condition_variable cv;
 #else
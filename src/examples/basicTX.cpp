@@ -130,6 +130,7 @@ int main(int argc, char** argv)
     txMeta.timestamp = 0;
     txMeta.waitForTimestamp = true;
     txMeta.flushPartialPacket = true;
+    txMeta.endOfBurst = false;
 
     uint32_t totalSamplesSent = 0;
 
@@ -128,7 +128,7 @@ int main(int argc, char** argv)
     uint32_t totalSamplesSent = 0;
     float maxSignalAmplitude = 0;
 
-    SDRDevice::StreamMeta rxMeta;
+    SDRDevice::StreamMeta rxMeta{};
     while (std::chrono::high_resolution_clock::now() - startTime < std::chrono::seconds(10) && !stopProgram)
     {
         uint32_t samplesRead = device->StreamRx(chipIndex, rxSamples, samplesInBuffer, &rxMeta);
@@ -146,6 +146,7 @@ int main(int argc, char** argv)
         txMeta.timestamp = rxMeta.timestamp + samplesInBuffer * 64;
         txMeta.waitForTimestamp = true;
         txMeta.flushPartialPacket = false;
+        txMeta.endOfBurst = false;
         uint32_t samplesSent = device->StreamTx(chipIndex, rxSamples, samplesInBuffer, &txMeta);
         if (samplesSent < 0)
         {
@@ -450,6 +450,8 @@ void fftviewer_frFFTviewer::StreamingLoop(
 
     const lime::complex32f_t* src[2] = { txPattern[0].data(), txPattern[1].data() };*/
 
+    // the streaming threads must not wait for the GUI log handler
+    lime::enableAsyncLogging(true);
     try
     {
         pthis->device->StreamSetup(config, chipIndex);
@@ -475,9 +477,10 @@ void fftviewer_frFFTviewer::StreamingLoop(
     SDRDevice::StreamMeta txMeta;
     txMeta.waitForTimestamp = syncTx;
     txMeta.flushPartialPacket = true;
+    txMeta.endOfBurst = false;
     int fftCounter = 0;
 
-    SDRDevice::StreamMeta rxMeta;
+    SDRDevice::StreamMeta rxMeta{};
 
     while (pthis->stopProcessing.load() == false)
     {
@@ -635,6 +638,7 @@ void fftviewer_frFFTviewer::StreamingLoop(
     kiss_fft_free(m_fftCalcPlan);
     pthis->stopProcessing.store(true);
     pthis->device->StreamStop(chipIndex);
+    lime::enableAsyncLogging(false);
 
     for (int i = 0; i < channelsCount; ++i)
         delete[] buffers[i];
@@ -22,6 +22,8 @@ class LIME_API DeviceRegistry
     /*!
      * Discovery identifiers that can be used to create a connection.
      * The hint may contain a connection type, serial number, IP address, etc.
+     * All registry entries are probed concurrently, and each entry's results
+     * are reused for a short time or until invalidateCache() is called.
      * \param hint An optional connection handle with some fields filled-in
      * \return A list of handles which can be used to make a connection
      */
@@ -29,12 +31,18 @@ class LIME_API DeviceRegistry
 
     /*!
      * Create a connection from an identifying handle.
+     * Handles returned by enumerate() are opened without another discovery.
      * Returns a null pointer when no factories are available.
      * \param handle A connection handle with fields filled-in
      * \return A pointer to a connection instance (or null)
      */
     static SDRDevice* makeDevice(const DeviceHandle& handle);
 
+    /*!
+     * Forget the cached discovery results, for example when a device is plugged in or removed.
+     */
+    static void invalidateCache(void);
+
     /*!
      * Free an connection created by makeConnection().
      * \param conn The connection to free.
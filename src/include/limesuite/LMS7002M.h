@@ -200,6 +200,20 @@ class LIME_API LMS7002M
      */
     OpStatus SaveConfig(const std::string& filename);
 
+    /*!
+     * @brief Saves the register cache of both channels to a binary snapshot file
+     * @param filename destination filename
+     * @return The status of the operation
+     */
+    OpStatus SaveSnapshot(const std::string& filename);
+
+    /*!
+     * @brief Restores registers from a binary snapshot file in a single SPI batch and updates the register cache
+     * @param filename Snapshot source file, created by SaveSnapshot()
+     * @return The status of the operation
+     */
+    OpStatus LoadSnapshot(const std::string& filename);
+
     /*!
      * @brief Returns given parameter value from chip register
      * @param param LMS7002M control parameter
@@ -270,6 +284,15 @@ class LIME_API LMS7002M
      */
     static const LMS7Parameter& GetParam(const std::string& name);
 
+    /*!
+     * @brief Get parameter by its register address and bits
+     * @param address The SPI address of the parameter.
+     * @param msb The index of the most significant bit of the parameter.
+     * @param lsb The index of the least significant bit of the parameter.
+     * @return A constant reference to the parameter
+     */
+    static const LMS7Parameter& GetParam(uint16_t address, uint8_t msb, uint8_t lsb);
+
     /*!
      * @brief Calibrates Receiver. DC offset, IQ gains, IQ phase correction
      * @param bandwidth_Hz The bandwidth to calibrate the device for (in Hz)
@@ -512,6 +535,13 @@ class LIME_API LMS7002M
      */
     bool GetCGENLocked(void);
 
+    /*!
+     * @brief Gets how many times the clock generator was tuned, reset or loaded from a configuration.
+     * The LimeLight interface clocks derived from it may have changed whenever the count changes.
+     * @return The clock generator configuration count.
+     */
+    uint32_t GetCGENConfigurationCount() const;
+
     /*!
      * @brief Returns currently set SXR/SXT frequency
      * @param dir Rx/Tx module selection
@@ -528,6 +558,32 @@ class LIME_API LMS7002M
      */
     OpStatus SetFrequencySX(TRXDir dir, float_type freq_Hz, SX_details* output = nullptr);
 
+    /*!
+     * @brief Tunes the SX to each of the given frequencies and stores the resulting register sets for fast hopping.
+     * The synthesizer configuration in use before the call is restored afterwards.
+     * The profiles are discarded when the reference clock changes.
+     * @param dir Rx/Tx module selection
+     * @param frequencies The frequencies (in Hz) to prepare, their order defines the profile indexes
+     * @return The status of the operation
+     */
+    OpStatus PrepareHopProfiles(TRXDir dir, const std::vector<float_type>& frequencies);
+
+    /*!
+     * @brief Switches the SX to a profile prepared by PrepareHopProfiles().
+     * Only the registers differing from the current configuration are written, in a single batch without VCO tuning.
+     * @param dir Rx/Tx module selection
+     * @param index The index of the profile to apply
+     * @return The status of the operation
+     */
+    OpStatus ApplyHopProfile(TRXDir dir, std::size_t index);
+
+    /*!
+     * @brief Gets the amount of prepared hopping profiles.
+     * @param dir Rx/Tx module selection
+     * @return The amount of profiles available to ApplyHopProfile()
+     */
+    std::size_t GetHopProfileCount(TRXDir dir) const;
+
     /*!
      * @brief Sets SX frequency with Reference clock spur cancelation
      * @param dir Rx/Tx module selection
@@ -919,11 +975,25 @@ class LIME_API LMS7002M
      */
     virtual OpStatus SetDefaults(MemorySection module);
 
+    /// The SX registers written by SetFrequencySX(), stored by the hopping profiles.
+    static constexpr uint16_t hopProfileFirstAddress = 0x011C;
+    static constexpr std::size_t hopProfileRegisterCount = 7;
+
+    /// @brief The complete, tuned SX register set for one frequency.
+    struct SXHopProfile {
+        float_type frequency;
+        std::array<uint16_t, hopProfileRegisterCount> registers;
+    };
+
+    void ReadHopProfile(TRXDir dir, SXHopProfile& profile) const;
+    OpStatus WriteHopProfile(TRXDir dir, const SXHopProfile& profile);
+
     LMS7002M_RegistersMap* BackupRegisterMap(void);
     void RestoreRegisterMap(LMS7002M_RegistersMap* backup);
 
     CGENChangeCallbackType mCallback_onCGENChange;
     void* mCallback_onCGENChange_userData;
+    uint32_t mCGENConfigurationCount;
 
     MCU_BD* mcuControl;
     bool useCache;
@@ -965,6 +1035,7 @@ class LIME_API LMS7002M
     std::shared_ptr<ISPI> controlPort;
     std::array<int, 2> opt_gain_tbb;
     double _cachedRefClockRate;
+    std::array<std::vector<SXHopProfile>, 2> mHopProfiles;
     OpStatus LoadConfigLegacyFile(const std::string& filename);
 };
 } // namespace lime
@@ -8,6 +8,7 @@ SDRDevice::StreamConfig::Extras::Extras()
     : usePoll{ true }
     , negateQ{ false }
     , waitPPS{ false }
+    , usbEventsCpu{ -1 }
 {
 }
 
@@ -17,6 +18,22 @@ SDRDevice::StreamConfig::Extras::PacketTransmission::PacketTransmission()
 {
 }
 
+SDRDevice::StreamConfig::Extras::RxDecimation::RxDecimation()
+    : ratio{ 1 }
+    , channelize{ false }
+    , subChannels{ 0 }
+    , bandwidth{ 0.8f }
+    , tapsPerPhase{ 16 }
+{
+}
+
+SDRDevice::StreamConfig::Extras::RxCorrection::RxCorrection()
+    : dcOffset{ false }
+    , iqImbalance{ false }
+    , averagingLength{ 65536 }
+{
+}
+
 SDRDevice::StreamConfig::StreamConfig()
     : format{ DataFormat::I16 }
     , linkFormat{ DataFormat::I16 }
@@ -34,6 +51,22 @@ SDRDevice::StreamConfig::StreamConfig()
 const char SDRDevice::Descriptor::DEVICE_NUMBER_SEPARATOR_SYMBOL = '@';
 const char SDRDevice::Descriptor::PATH_SEPARATOR_SYMBOL = '/';
 
+OpStatus SDRDevice::ConfigureModules(const SDRConfig& config, const std::vector<uint8_t>& moduleIndexes)
+{
+    for (uint8_t moduleIndex : moduleIndexes)
+    {
+        OpStatus status = Configure(config, moduleIndex);
+        if (status != OpStatus::SUCCESS)
+            return status;
+    }
+    return OpStatus::SUCCESS;
+}
+
+OpStatus SDRDevice::ScheduleCommand(uint8_t moduleIndex, const TimedCommand& command)
+{
+    return ReportError(OpStatus::NOT_IMPLEMENTED, "ScheduleCommand not implemented");
+}
+
 OpStatus SDRDevice::SPI(uint32_t chipSelect, const uint32_t* MOSI, uint32_t* MISO, uint32_t count)
 {
     return ReportError(OpStatus::NOT_IMPLEMENTED, "TransactSPI not implemented");
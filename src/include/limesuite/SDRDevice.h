@@ -2,6 +2,7 @@
 #define LIME_SDRDevice_H
 
 #include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -140,6 +141,7 @@ class LIME_API SDRDevice
         uint32_t underrun; ///< The amount of packets underrun.
         uint32_t loss; ///< The amount of packets that are lost.
         uint32_t late; ///< The amount of packets that arrived late for transmitting and were dropped.
+        uint32_t burstsCompleted; ///< The amount of Tx bursts (see StreamMeta::endOfBurst) handed over to the hardware.
     };
 
     /// @brief Describes the status of a global positioning system.
@@ -165,6 +167,41 @@ class LIME_API SDRDevice
                 uint32_t packetsInBatch; ///< The amount of packets to send in a single transfer.
             };
 
+            /**
+             * @brief The settings structure for the host-side decimation of the received samples.
+             *
+             * The stage runs on the receive thread, so StreamRx() returns the decimated samples.
+             * The Rx timestamps stay in the hardware sample domain, shared with Tx and the timed commands, so the
+             * timestamps of consecutive decimated samples are @ref ratio apart, starting at multiples of the ratio.
+             */
+            struct RxDecimation {
+                RxDecimation();
+
+                uint8_t ratio; ///< The decimation ratio, 1 disables the stage.
+                /// Split the band into @ref ratio channels spaced by the output sample rate, instead of keeping the center one.
+                /// Only a single Rx channel can be channelized.
+                bool channelize;
+                /// The channelizer outputs to deliver to StreamRx() (at most 2). Channel k is centered at k times
+                /// the output sample rate, the ones above ratio/2 wrap around to the negative frequencies.
+                std::vector<uint8_t> subChannels;
+                float bandwidth; ///< The passband width as a fraction of the output sample rate (0;1).
+                uint8_t tapsPerPhase; ///< The filter length of each polyphase branch.
+            };
+
+            /**
+             * @brief The settings structure for the host-side correction of the received samples.
+             *
+             * The DC offset and the IQ imbalance of each Rx channel are tracked continuously from the received samples,
+             * the corrections estimated from the previous packets are applied to the following ones.
+             */
+            struct RxCorrection {
+                RxCorrection();
+
+                bool dcOffset; ///< Whether to remove the DC offset.
+                bool iqImbalance; ///< Whether to correct the IQ gain and phase imbalance.
+                uint32_t averagingLength; ///< The amount of samples the estimates are averaged over.
+            };
+
             Extras();
             bool usePoll; ///< Whether to use a polling strategy for PCIe devices.
 
@@ -173,6 +210,14 @@ class LIME_API SDRDevice
 
             bool negateQ; ///< Whether to negate the Q element before sending the data or not.
             bool waitPPS; ///< Start sampling from next following PPS.
+            /// PCIe only: the file to record the raw Rx DMA buffers into, for replaying the stream off-site.
+            /// Empty to disable the recording.
+            std::string rxDMARecordingFile;
+            /// USB only: the CPU core to pin the USB event handling thread of the device to, -1 to leave it unpinned.
+            int16_t usbEventsCpu;
+
+            RxCorrection rxCorrection; ///< Configuration of the host-side Rx DC and IQ correction stage.
+            RxDecimation rxDecimation; ///< Configuration of the host-side Rx decimation stage.
         };
 
         /// @brief The definition of the function that gets called whenever a stream status changes.
@@ -201,7 +246,8 @@ class LIME_API SDRDevice
         float hintSampleRate;
         bool alignPhase; ///< Attempt to do phases alignment between paired channels
 
-        StatusCallbackFunc statusCallback; ///< Function to call on a status change.
+        /// Function to call on a status change, called from a low priority thread of the stream, not the streaming threads.
+        StatusCallbackFunc statusCallback;
         void* userData; ///<  Data that will be supplied to statusCallback
         // TODO: callback for drops and errors
 
@@ -215,19 +261,75 @@ class LIME_API SDRDevice
          * In RX: time when the first sample in the returned buffer was received.
          * In TX: time when the first sample in the submitted buffer should be send.
          */
-        uint64_t timestamp;
+        uint64_t timestamp = 0;
 
         /**
-         * In RX: not used/ignored.
+         * In RX: drop the samples received before the specified timestamp, the returned buffer starts at it
+         * (or at the first sample received after it, if it was lost). Without the decimation stage the
+         * dropped packets are not even converted.
          * In TX: wait for the specified HW timestamp before broadcasting data over the air.
          */
-        bool waitForTimestamp;
+        bool waitForTimestamp = false;
 
         /**
          * In RX: not used/ignored.
          * In TX: send samples to HW even if packet is not completely filled (end TX burst).
          */
-        bool flushPartialPacket;
+        bool flushPartialPacket = false;
+
+        /**
+         * In RX: not used/ignored.
+         * In TX: the submitted samples end the burst. The final packet is padded and sent right away,
+         * and once the burst is handed over to the hardware StreamConfig::statusCallback is called
+         * with StreamStats::burstsCompleted incremented. Underruns and drops are not counted after the
+         * hardware has transmitted the end of the burst, until the next timestamped burst.
+         */
+        bool endOfBurst = false;
+    };
+
+    /// @brief The outcome of a timed command.
+    struct TimedCommandResult {
+        uint64_t targetTimestamp; ///< The timestamp the command was scheduled for.
+        uint64_t executedTimestamp; ///< The timestamp at which the command finished executing.
+        OpStatus status; ///< The status of the command (OpStatus::ABORTED if it was cancelled).
+    };
+
+    /// @brief The definition of a function to call when a timed command is completed.
+    typedef void (*TimedCommandCallback)(const TimedCommandResult& result, void* userData);
+
+    /// @brief An operation to execute when the stream reaches a given sample timestamp.
+    struct TimedCommand {
+        /// @brief The kind of operation to execute.
+        enum class Type : uint8_t {
+            Frequency, ///< Sets the RF frequency to value.
+            Gain, ///< Sets the gain of gainType to value.
+            NCOIndex, ///< Switches to the NCO with ncoIndex.
+            Registers, ///< Writes the list of registers.
+        };
+
+        TimedCommand()
+            : timestamp(0)
+            , type(Type::Registers)
+            , trx(TRXDir::Rx)
+            , channel(0)
+            , value(0)
+            , gainType(eGainTypes::UNKNOWN)
+            , ncoIndex(0)
+            , callback(nullptr)
+            , userData(nullptr)
+        {
+        }
+
+        uint64_t timestamp; ///< The hardware timestamp (see GetHardwareTimestamp()) at which the command should take effect.
+        Type type; ///< The kind of operation to execute.
+        TRXDir trx; ///< The direction of the channel to modify.
+        uint8_t channel; ///< The channel to modify.
+        double value; ///< The frequency (in Hz) or gain (in dB) to set.
+        eGainTypes gainType; ///< The gain to set.
+        uint8_t ncoIndex; ///< The NCO index to switch to.
+        std::vector<std::pair<uint16_t, uint16_t>> registers; ///< RF chip register address and value pairs to write.
+        TimedCommandCallback callback; ///< The function to call with the outcome of the command (optional).
+        void* userData; ///< Data that will be supplied to the callback.
     };
 
     /// @brief Configuration of a single channel.
@@ -353,6 +455,13 @@ class LIME_API SDRDevice
     /// @return The status of the operation.
     virtual OpStatus Configure(const SDRConfig& config, uint8_t moduleIndex) = 0;
 
+    /// @brief Configures several devices with the same configuration.
+    /// Devices that can calibrate their chips concurrently do so, otherwise the same as calling Configure() for each of them.
+    /// @param config The configuration to set up the devices with.
+    /// @param moduleIndexes The device indexes to configure.
+    /// @return The status of the operation.
+    virtual OpStatus ConfigureModules(const SDRConfig& config, const std::vector<uint8_t>& moduleIndexes);
+
     /// @brief Gets the Descriptor of the SDR Device.
     /// @return The Descriptor of the device.
     virtual const Descriptor& GetDescriptor() const = 0;
@@ -771,6 +880,59 @@ class LIME_API SDRDevice
         return OpStatus::NOT_IMPLEMENTED;
     }
 
+    /// @brief Fills the per channel buffers with the next part of the waveform.
+    /// It is called from a worker thread, while the previous part is being transferred.
+    /// @param dest The buffers to fill, one for each channel, in the StreamConfig::format.
+    /// @param maxCount The maximum amount of samples to write into each buffer.
+    /// @return The amount of samples written, 0 once the waveform has ended.
+    typedef std::function<uint32_t(void* const* dest, uint32_t maxCount)> TxWaveformSource;
+
+    /// @brief Reports the waveform upload progress.
+    /// @param samplesSent The amount of samples transferred so far.
+    /// @param samplesTotal The total amount of samples in the waveform.
+    /// @return False to cancel the upload.
+    typedef std::function<bool(uint64_t samplesSent, uint64_t samplesTotal)> TxWaveformProgressCallback;
+
+    /// @brief Uploads waveform to on board memory, reading it from the source in bounded chunks.
+    /// @param config The configuration of the stream.
+    /// @param moduleIndex The index of the device to upload the waveform to.
+    /// @param source The function supplying the samples.
+    /// @param count The total amount of samples in each channel.
+    /// @param progress The function to report the progress to, or to cancel the upload with (optional).
+    /// @return Operation status, OpStatus::ABORTED if the upload was cancelled.
+    virtual OpStatus UploadTxWaveform(const StreamConfig& config,
+        uint8_t moduleIndex,
+        TxWaveformSource source,
+        uint64_t count,
+        TxWaveformProgressCallback progress = nullptr)
+    {
+        return OpStatus::NOT_IMPLEMENTED;
+    }
+
+    /// @brief Uploads waveform file to on board memory without loading the whole file into memory.
+    /// The file holds raw samples in the StreamConfig::format, with the channels interleaved sample by sample.
+    /// @param config The configuration of the stream.
+    /// @param moduleIndex The index of the device to upload the waveform to.
+    /// @param filename The path of the waveform file.
+    /// @param progress The function to report the progress to, or to cancel the upload with (optional).
+    /// @return Operation status, OpStatus::ABORTED if the upload was cancelled.
+    virtual OpStatus UploadTxWaveformFile(
+        const StreamConfig& config, uint8_t moduleIndex, const std::string& filename, TxWaveformProgressCallback progress = nullptr)
+    {
+        return OpStatus::NOT_IMPLEMENTED;
+    }
+
+    /// @brief Queues a command to be executed when the stream reaches the command's timestamp.
+    /// Commands are fired ahead of their timestamp by the measured control latency, the stream has to be set up.
+    /// @param moduleIndex The index of the device to execute the command on.
+    /// @param command The command to execute.
+    /// @return The status of the operation.
+    virtual OpStatus ScheduleCommand(uint8_t moduleIndex, const TimedCommand& command);
+
+    /// @brief Cancels all of the queued timed commands, their callbacks receive OpStatus::ABORTED.
+    /// @param moduleIndex The index of the device to cancel the commands on.
+    virtual void CancelScheduledCommands(uint8_t moduleIndex){};
+
     /// @copydoc ISPI::SPI()
     /// @param spiBusAddress The SPI address of the device to use.
     virtual OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count);
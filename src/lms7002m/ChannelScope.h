@@ -0,0 +1,90 @@
+/**
+@file	ChannelScope.h
+@author	Lime Microsystems
+@brief	Scoped LMS7002M channel selection
+*/
+
+#ifndef LIME_CHANNELSCOPE_H
+#define LIME_CHANNELSCOPE_H
+
+#include "limesuite/LMS7002M.h"
+
+#include <cassert>
+
+namespace lime {
+
+constexpr LMS7002M::Channel IntToChannel(int channel)
+{
+    return channel > 0 ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA;
+}
+
+/** @brief Switches LMS7002M SPI to requested channel and restores previous channel when going out of scope */
+class ChannelScope
+{
+  public:
+    /**
+   * @brief Saves the current channel and restores it at scope exit.
+   * @param chip The chip to use.
+   * @param useCache Whether to use caching or not.
+   */
+    ChannelScope(LMS7002M* chip, bool useCache = false)
+        : mChip(chip)
+        , mStoredValue(chip->GetActiveChannel(!useCache))
+        , mNeedsRestore(true)
+    {
+    }
+
+    /**
+      @brief Convenient constructor when using explicit MAC value.
+      @param chip The chip to use.
+      @param mac The channel to use.
+      @param useCache Whether to use caching or not.
+     */
+    ChannelScope(LMS7002M* chip, LMS7002M::Channel mac, bool useCache = false)
+        : mChip(chip)
+        , mStoredValue(chip->GetActiveChannel(!useCache))
+        , mNeedsRestore(false)
+    {
+        if (mStoredValue == mac)
+            return;
+
+        mChip->SetActiveChannel(mac);
+        mNeedsRestore = true;
+    }
+
+    /**
+      @brief Convenient constructor when using channel index starting from 0.
+      @param chip The chip to use.
+      @param index The channel index.
+      @param useCache Whether to use caching or not.
+     */
+    ChannelScope(LMS7002M* chip, uint8_t index, bool useCache = false)
+        : mChip(chip)
+        , mNeedsRestore(false)
+    {
+        assert(index < 2);
+        mStoredValue = chip->GetActiveChannel(!useCache);
+        auto expectedChannel = IntToChannel(index);
+        if (mStoredValue == expectedChannel)
+            return;
+
+        mChip->SetActiveChannel(expectedChannel);
+        mNeedsRestore = true;
+    }
+
+    /** @brief Destroy the Channel Scope object and reset the active channel. */
+    ~ChannelScope()
+    {
+        if (mNeedsRestore)
+            mChip->SetActiveChannel(mStoredValue);
+    }
+
+  private:
+    LMS7002M* mChip; ///< The chip to modify
+    LMS7002M::Channel mStoredValue; ///< The channel to restore to
+    bool mNeedsRestore; ///< Whether the channel needs restoring or not
+};
+
+} // namespace lime
+
+#endif // LIME_CHANNELSCOPE_H
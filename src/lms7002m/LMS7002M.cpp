@@ -16,6 +16,10 @@
 #include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <thread>
 
@@ -31,6 +35,7 @@
 #include "lms_gfir.h"
 #include "limesuite/commonTypes.h"
 #include "limesuite/IComms.h"
+#include "ChannelScope.h"
 #include "LMS7002M_RegistersMap.h"
 #include "Logger.h"
 #include "mcu_programs.h"
@@ -43,11 +48,6 @@ constexpr std::array<std::array<float_type, 2>, 3> LMS7002M::gVCO_frequency_tabl
 };
 constexpr std::array<float_type, 2> LMS7002M::gCGEN_VCO_frequencies{ 1930e6, 2940e6 };
 
-constexpr LMS7002M::Channel IntToChannel(int channel)
-{
-    return channel > 0 ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA;
-}
-
 /// Define for parameter enumeration if prefix might be needed
 extern std::vector<std::reference_wrapper<const LMS7Parameter>> LMS7parameterList;
 
@@ -103,73 +103,6 @@ const std::map<LMS7002M::MemorySection, std::array<uint16_t, 2>> LMS7002M::Memor
     { LMS7002M::MemorySection::RSSI_DC_CONFIG, { 0x0640, 0x0641 } },
 };
 
-/** @brief Switches LMS7002M SPI to requested channel and restores previous channel when going out of scope */
-class ChannelScope
-{
-  public:
-    /**
-   * @brief Saves the current channel and restores it at scope exit.
-   * @param chip The chip to use.
-   * @param useCache Whether to use caching or not.
-   */
-    ChannelScope(LMS7002M* chip, bool useCache = false)
-        : mChip(chip)
-        , mStoredValue(chip->GetActiveChannel(!useCache))
-        , mNeedsRestore(true)
-    {
-    }
-
-    /**
-      @brief Convenient constructor when using explicit MAC value.
-      @param chip The chip to use.
-      @param mac The channel to use.
-      @param useCache Whether to use caching or not.
-     */
-    ChannelScope(LMS7002M* chip, LMS7002M::Channel mac, bool useCache = false)
-        : mChip(chip)
-        , mStoredValue(chip->GetActiveChannel(!useCache))
-        , mNeedsRestore(false)
-    {
-        if (mStoredValue == mac)
-            return;
-
-        mChip->SetActiveChannel(mac);
-        mNeedsRestore = true;
-    }
-
-    /**
-      @brief Convenient constructor when using channel index starting from 0.
-      @param chip The chip to use.
-      @param index The channel index.
-      @param useCache Whether to use caching or not.
-     */
-    ChannelScope(LMS7002M* chip, uint8_t index, bool useCache = false)
-        : mChip(chip)
-        , mNeedsRestore(false)
-    {
-        assert(index < 2);
-        mStoredValue = chip->GetActiveChannel(!useCache);
-        auto expectedChannel = IntToChannel(index);
-        if (mStoredValue == expectedChannel)
-            return;
-
-        mChip->SetActiveChannel(expectedChannel);
-        mNeedsRestore = true;
-    }
-
-    /** @brief Destroy the Channel Scope object and reset the active channel. */
-    ~ChannelScope()
-    {
-        if (mNeedsRestore)
-            mChip->SetActiveChannel(mStoredValue);
-    }
-
-  private:
-    LMS7002M* mChip; ///< The chip to modify
-    LMS7002M::Channel mStoredValue; ///< The channel to restore to
-    bool mNeedsRestore; ///< Whether the channel needs restoring or not
-};
-
 /** @brief Simple logging function to print status messages
     @param text message to print
     @param type message type for filtering specific information
@@ -247,6 +180,7 @@ It requires IConnection to be set by SetConnection() to communicate with chip
 LMS7002M::LMS7002M(std::shared_ptr<ISPI> port)
     : mCallback_onCGENChange(nullptr)
     , mCallback_onCGENChange_userData(nullptr)
+    , mCGENConfigurationCount(0)
     , useCache(0)
     , mRegistersMap(new LMS7002M_RegistersMap())
     , controlPort(port)
@@ -427,6 +361,7 @@ OpStatus LMS7002M::EnableChannel(TRXDir dir, const uint8_t channel, const bool e
 OpStatus LMS7002M::ResetChip()
 {
     OpStatus status;
+    ++mCGENConfigurationCount;
 
     const std::vector<uint16_t> usedAddresses = mRegistersMap->GetUsedAddresses(0);
 
@@ -454,6 +389,7 @@ OpStatus LMS7002M::ResetChip()
 
     status = SPI_write_batch(addrs.data(), values.data(), addrs.size(), true);
     status = Modify_SPI_Reg_bits(LMS7param(MIMO_SISO), 0); //enable B channel after reset
+    mcuControl->InvalidateLoadedProgram();
     return status;
 }
 
@@ -463,6 +399,7 @@ OpStatus LMS7002M::SoftReset()
     auto reg_0x002E = this->SPI_read(0x002E, true);
     this->SPI_write(0x0020, 0x0);
     this->SPI_write(0x0020, reg_0x0020);
+    mcuControl->InvalidateLoadedProgram();
     this->SPI_write(0x002E, reg_0x002E); //must write, enables/disabled MIMO channel B
     return OpStatus::SUCCESS;
 }
@@ -657,6 +594,8 @@ OpStatus LMS7002M::LoadConfig(const std::string& filename, bool tuneDynamicValue
         return ReportError(OpStatus::FILE_NOT_FOUND, "LoadConfig(%s) - file not found", filename.c_str());
     }
     f.close();
+    // the loaded registers may reconfigure the clock generator
+    ++mCGENConfigurationCount;
 
     uint16_t addr = 0;
     uint16_t value = 0;
@@ -858,6 +797,187 @@ OpStatus LMS7002M::SaveConfig(const std::string& filename)
     return OpStatus::SUCCESS;
 }
 
+namespace {
+/// Binary register snapshot layout, all fields little-endian:
+/// magic[8], version u16, chip revision u16 (register 0x002F), SX reference clock u64 (Hz),
+/// then for channels A and B: register count u16 followed by (address u16, value u16) pairs,
+/// and a CRC-32 over all of the preceding bytes.
+constexpr char snapshotMagic[8] = { 'L', 'M', 'S', '7', 'S', 'N', 'A', 'P' };
+constexpr uint16_t snapshotVersion = 1;
+
+uint32_t SnapshotCRC32(const std::vector<uint8_t>& data)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint8_t byte : data)
+    {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+void PutLE(std::vector<uint8_t>& buffer, uint64_t value, int byteCount)
+{
+    for (int i = 0; i < byteCount; ++i)
+        buffer.push_back((value >> (8 * i)) & 0xFF);
+}
+
+uint64_t GetLE(const uint8_t* src, int byteCount)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < byteCount; ++i)
+        value |= static_cast<uint64_t>(src[i]) << (8 * i);
+    return value;
+}
+} // namespace
+
+OpStatus LMS7002M::SaveSnapshot(const std::string& filename)
+{
+    std::vector<uint8_t> buffer(std::begin(snapshotMagic), std::end(snapshotMagic));
+    PutLE(buffer, snapshotVersion, 2);
+    PutLE(buffer, SPI_read(0x002F), 2);
+    PutLE(buffer, static_cast<uint64_t>(std::llround(GetReferenceClk_SX(TRXDir::Rx))), 8);
+
+    for (uint8_t channel = 0; channel < 2; ++channel)
+    {
+        std::vector<uint16_t> addresses = mRegistersMap->GetUsedAddresses(channel);
+        PutLE(buffer, addresses.size(), 2);
+        for (uint16_t address : addresses)
+        {
+            PutLE(buffer, address, 2);
+            PutLE(buffer, mRegistersMap->GetValue(channel, address), 2);
+        }
+    }
+    PutLE(buffer, SnapshotCRC32(buffer), 4);
+
+    std::ofstream fout(filename, std::ios::binary);
+    if (!fout.good())
+        return ReportError(OpStatus::IO_FAILURE, "SaveSnapshot(%s) - failed to open file", filename.c_str());
+    fout.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return fout.good() ? OpStatus::SUCCESS : ReportError(OpStatus::IO_FAILURE, "SaveSnapshot(%s) - write failed", filename.c_str());
+}
+
+OpStatus LMS7002M::LoadSnapshot(const std::string& filename)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    if (!fin.good())
+        return ReportError(OpStatus::FILE_NOT_FOUND, "LoadSnapshot(%s) - file not found", filename.c_str());
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+    constexpr size_t headerSize = sizeof(snapshotMagic) + 2 + 2 + 8;
+    if (buffer.size() < headerSize + 4 || !std::equal(std::begin(snapshotMagic), std::end(snapshotMagic), buffer.begin()))
+        return ReportError(OpStatus::INVALID_VALUE, "LoadSnapshot(%s) - invalid format", filename.c_str());
+
+    const uint32_t storedCRC = GetLE(&buffer[buffer.size() - 4], 4);
+    buffer.resize(buffer.size() - 4);
+    if (storedCRC != SnapshotCRC32(buffer))
+        return ReportError(OpStatus::INVALID_VALUE, "LoadSnapshot(%s) - checksum mismatch", filename.c_str());
+
+    const uint8_t* ptr = &buffer[sizeof(snapshotMagic)];
+    if (GetLE(ptr, 2) != snapshotVersion)
+        return ReportError(
+            OpStatus::NOT_SUPPORTED, "LoadSnapshot(%s) - unsupported version %i", filename.c_str(), int(GetLE(ptr, 2)));
+    const uint16_t chipRevision = GetLE(ptr + 2, 2);
+    const float_type refClk_Hz = GetLE(ptr + 4, 8);
+    ptr += 12;
+
+    if (controlPort)
+    {
+        const uint16_t connectedRevision = SPI_read(0x002F, true);
+        if (connectedRevision != chipRevision)
+            return ReportError(OpStatus::INVALID_VALUE,
+                "LoadSnapshot(%s) - snapshot of chip revision 0x%04X, connected chip is 0x%04X",
+                filename.c_str(),
+                chipRevision,
+                connectedRevision);
+    }
+
+    const uint8_t* const end = buffer.data() + buffer.size();
+    std::array<std::vector<std::pair<uint16_t, uint16_t>>, 2> registers;
+    for (auto& channelRegisters : registers)
+    {
+        if (end - ptr < 2)
+            return ReportError(OpStatus::INVALID_VALUE, "LoadSnapshot(%s) - truncated file", filename.c_str());
+        const uint16_t count = GetLE(ptr, 2);
+        ptr += 2;
+        if (end - ptr < count * 4)
+            return ReportError(OpStatus::INVALID_VALUE, "LoadSnapshot(%s) - truncated file", filename.c_str());
+        channelRegisters.reserve(count);
+        for (uint16_t i = 0; i < count; ++i, ptr += 4)
+            channelRegisters.push_back({ static_cast<uint16_t>(GetLE(ptr, 2)), static_cast<uint16_t>(GetLE(ptr + 2, 2)) });
+    }
+
+    auto isReadOnly = [](uint16_t address) {
+        for (const auto& reg : readOnlyRegisters)
+            if (reg.address == address)
+                return reg.mask == 0;
+        return false;
+    };
+
+    // Whole restore goes out as one batch, MAC register writes inside of it
+    // steer both the chip and the register cache to the right channel.
+    const uint16_t macAddress = LMS7param(MAC).address;
+    uint16_t x0020_value = 0;
+    std::vector<uint16_t> addrToWrite;
+    std::vector<uint16_t> dataToWrite;
+    addrToWrite.reserve(registers[0].size() + registers[1].size() + 16);
+    dataToWrite.reserve(addrToWrite.capacity());
+    for (const auto& reg : registers[0])
+        if (reg.first == macAddress)
+            x0020_value = reg.second;
+
+    addrToWrite.push_back(macAddress);
+    dataToWrite.push_back((x0020_value & ~0x0003) | static_cast<uint16_t>(Channel::ChA));
+    for (const auto& reg : registers[0])
+    {
+        if (reg.first == macAddress || isReadOnly(reg.first))
+            continue;
+        if (reg.first >= 0x5C3 && reg.first <= 0x5CA) //enable analog DC correction
+        {
+            addrToWrite.push_back(reg.first);
+            dataToWrite.push_back(reg.second & 0x3FFF);
+            addrToWrite.push_back(reg.first);
+            dataToWrite.push_back(reg.second | 0x8000);
+        }
+        else
+        {
+            addrToWrite.push_back(reg.first);
+            dataToWrite.push_back(reg.second);
+        }
+    }
+
+    addrToWrite.push_back(macAddress);
+    dataToWrite.push_back((x0020_value & ~0x0003) | static_cast<uint16_t>(Channel::ChB));
+    for (const auto& reg : registers[1])
+    {
+        if (isReadOnly(reg.first))
+            continue;
+        addrToWrite.push_back(reg.first);
+        dataToWrite.push_back(reg.second);
+    }
+
+    // restore channel selection and reset logic registers, same as ResetLogicRegisters()
+    addrToWrite.insert(addrToWrite.end(), { macAddress, macAddress, macAddress });
+    dataToWrite.insert(dataToWrite.end(),
+        { x0020_value, static_cast<uint16_t>(x0020_value & 0x553F), static_cast<uint16_t>(x0020_value | 0xFFC0) });
+
+    if (addrToWrite.size() > std::numeric_limits<uint16_t>::max())
+        return ReportError(OpStatus::INVALID_VALUE, "LoadSnapshot(%s) - too many registers", filename.c_str());
+
+    OpStatus status = SPI_write_batch(addrToWrite.data(), dataToWrite.data(), addrToWrite.size(), true);
+    if (status != OpStatus::SUCCESS)
+        return status;
+
+    SetReferenceClk_SX(TRXDir::Rx, refClk_Hz);
+    SetReferenceClk_SX(TRXDir::Tx, refClk_Hz);
+    ++mCGENConfigurationCount;
+
+    if (mCallback_onCGENChange && !Get_SPI_Reg_bits(LMS7param(PD_VCO_CGEN)))
+        return mCallback_onCGENChange(mCallback_onCGENChange_userData);
+    return OpStatus::SUCCESS;
+}
+
 OpStatus LMS7002M::SetRBBPGA_dB(const float_type value, const Channel channel)
 {
     ChannelScope scope(this, channel);
@@ -1292,6 +1412,12 @@ OpStatus LMS7002M::SetPath(TRXDir direction, uint8_t channel, uint8_t path)
 
 OpStatus LMS7002M::SetReferenceClk_SX(TRXDir dir, float_type freq_Hz)
 {
+    if (freq_Hz != _cachedRefClockRate)
+    {
+        // the dividers of the prepared profiles no longer match
+        for (auto& profiles : mHopProfiles)
+            profiles.clear();
+    }
     _cachedRefClockRate = freq_Hz;
     return OpStatus::SUCCESS;
 }
@@ -1444,6 +1570,7 @@ bool LMS7002M::GetSXLocked(TRXDir dir)
 
 OpStatus LMS7002M::TuneCGENVCO()
 {
+    ++mCGENConfigurationCount;
 #ifndef NDEBUG
     lime::debug("ICT_VCO_CGEN: %d", Get_SPI_Reg_bits(LMS7param(ICT_VCO_CGEN)));
 #endif
@@ -1709,17 +1836,61 @@ OpStatus LMS7002M::Modify_SPI_Reg_mask(
     return status;
 }
 
+static constexpr uint32_t ParameterBitsKey(uint16_t address, uint8_t msb, uint8_t lsb)
+{
+    return (static_cast<uint32_t>(address) << 16) | (msb << 8) | lsb;
+}
+
+/// @brief Gets the index of the parameters by name, built on first use.
+/// When several parameters share a name, the first one in the parameter list is kept.
+static const std::unordered_map<std::string_view, const LMS7Parameter*>& ParametersByName()
+{
+    static const std::unordered_map<std::string_view, const LMS7Parameter*> index = []() {
+        std::unordered_map<std::string_view, const LMS7Parameter*> parameters;
+        parameters.reserve(LMS7parameterList.size());
+        for (const LMS7Parameter& parameter : LMS7parameterList)
+            parameters.emplace(parameter.name, &parameter);
+        return parameters;
+    }();
+    return index;
+}
+
+/// @brief Gets the index of the parameters by their register address and bits, built on first use.
+/// When several parameters share the same bits, the first one in the parameter list is kept.
+static const std::unordered_map<uint32_t, const LMS7Parameter*>& ParametersByBits()
+{
+    static const std::unordered_map<uint32_t, const LMS7Parameter*> index = []() {
+        std::unordered_map<uint32_t, const LMS7Parameter*> parameters;
+        parameters.reserve(LMS7parameterList.size());
+        for (const LMS7Parameter& parameter : LMS7parameterList)
+            parameters.emplace(ParameterBitsKey(parameter.address, parameter.msb, parameter.lsb), &parameter);
+        return parameters;
+    }();
+    return index;
+}
+
 const LMS7Parameter& LMS7002M::GetParam(const std::string& name)
 {
-    for (const LMS7Parameter& parameter : LMS7parameterList)
+    const auto& parameters = ParametersByName();
+    const auto iter = parameters.find(name);
+    if (iter == parameters.end())
+        throw std::logic_error("Parameter " + name + " not found");
+
+    return *iter->second;
+}
+
+const LMS7Parameter& LMS7002M::GetParam(uint16_t address, uint8_t msb, uint8_t lsb)
+{
+    const auto& parameters = ParametersByBits();
+    const auto iter = parameters.find(ParameterBitsKey(address, msb, lsb));
+    if (iter == parameters.end())
     {
-        if (std::string(parameter.name) == name)
-        {
-            return parameter;
-        }
+        char bits[64];
+        snprintf(bits, sizeof(bits), "0x%04X[%i:%i]", address, msb, lsb);
+        throw std::logic_error("Parameter at " + std::string(bits) + " not found");
     }
 
-    throw std::logic_error("Parameter " + name + " not found");
+    return *iter->second;
 }
 
 OpStatus LMS7002M::SetFrequencySX(TRXDir dir, float_type freq_Hz, SX_details* output)
@@ -1892,6 +2063,89 @@ OpStatus LMS7002M::SetFrequencySX(TRXDir dir, float_type freq_Hz, SX_details* ou
     return OpStatus::SUCCESS;
 }
 
+void LMS7002M::ReadHopProfile(TRXDir dir, SXHopProfile& profile) const
+{
+    const uint8_t bank = dir == TRXDir::Tx ? 1 : 0;
+    for (std::size_t i = 0; i < hopProfileRegisterCount; ++i)
+        profile.registers[i] = mRegistersMap->GetValue(bank, hopProfileFirstAddress + i);
+}
+
+OpStatus LMS7002M::WriteHopProfile(TRXDir dir, const SXHopProfile& profile)
+{
+    const uint8_t bank = dir == TRXDir::Tx ? 1 : 0;
+    const uint16_t macAddress = LMS7param(MAC).address;
+    const uint16_t macValue = mRegistersMap->GetValue(0, macAddress);
+    const uint16_t sxMacValue = (macValue & ~0x0003) | (dir == TRXDir::Tx ? 2 : 1);
+
+    std::array<uint16_t, hopProfileRegisterCount + 2> addrs;
+    std::array<uint16_t, hopProfileRegisterCount + 2> values;
+    uint16_t count = 0;
+    if (macValue != sxMacValue)
+    {
+        addrs[count] = macAddress;
+        values[count++] = sxMacValue;
+    }
+    const uint16_t firstRegister = count;
+    for (std::size_t i = 0; i < hopProfileRegisterCount; ++i)
+    {
+        const uint16_t address = hopProfileFirstAddress + i;
+        if (mRegistersMap->GetValue(bank, address) == profile.registers[i])
+            continue;
+        addrs[count] = address;
+        values[count++] = profile.registers[i];
+    }
+    if (count == firstRegister)
+        return OpStatus::SUCCESS;
+    if (macValue != sxMacValue)
+    {
+        addrs[count] = macAddress;
+        values[count++] = macValue;
+    }
+    return SPI_write_batch(addrs.data(), values.data(), count, true);
+}
+
+OpStatus LMS7002M::PrepareHopProfiles(TRXDir dir, const std::vector<float_type>& frequencies)
+{
+    auto& profiles = mHopProfiles.at(dir == TRXDir::Tx ? 1 : 0);
+    profiles.clear();
+
+    SXHopProfile original;
+    ReadHopProfile(dir, original);
+
+    std::vector<SXHopProfile> prepared(frequencies.size());
+    for (std::size_t i = 0; i < frequencies.size(); ++i)
+    {
+        OpStatus status = SetFrequencySX(dir, frequencies[i]);
+        if (status != OpStatus::SUCCESS)
+        {
+            WriteHopProfile(dir, original);
+            return status;
+        }
+        prepared[i].frequency = frequencies[i];
+        ReadHopProfile(dir, prepared[i]);
+    }
+
+    profiles = std::move(prepared);
+    return WriteHopProfile(dir, original);
+}
+
+OpStatus LMS7002M::ApplyHopProfile(TRXDir dir, std::size_t index)
+{
+    const auto& profiles = mHopProfiles.at(dir == TRXDir::Tx ? 1 : 0);
+    if (index >= profiles.size())
+        return ReportError(OpStatus::OUT_OF_RANGE,
+            "SX%s hop profile %zu not prepared (%zu available)",
+            dir == TRXDir::Tx ? "T" : "R",
+            index,
+            profiles.size());
+    return WriteHopProfile(dir, profiles[index]);
+}
+
+std::size_t LMS7002M::GetHopProfileCount(TRXDir dir) const
+{
+    return mHopProfiles.at(dir == TRXDir::Tx ? 1 : 0).size();
+}
+
 OpStatus LMS7002M::SetFrequencySXWithSpurCancelation(TRXDir dir, float_type freq_Hz, float_type BW)
 {
     const float BWOffset = 2e6;
@@ -2168,9 +2422,7 @@ OpStatus LMS7002M::SPI_write(uint16_t address, uint16_t data, bool toChip)
     if (address == 0x0640 || address == 0x0641)
     {
         MCU_BD* mcu = GetMCUControls();
-        mcu->RunProcedure(MCU_FUNCTION_GET_PROGRAM_ID);
-        if (mcu->WaitForMCU(100) != MCU_ID_CALIBRATIONS_SINGLE_IMAGE)
-            mcu->Program_MCU(mcu_program_lms7_dc_iq_calibration_bin, MCU_BD::MCU_PROG_MODE::SRAM);
+        mcu->EnsureProgramLoaded(mcu_program_lms7_dc_iq_calibration_bin, MCU_ID_CALIBRATIONS_SINGLE_IMAGE);
         SPI_write(0x002D, address);
         SPI_write(0x020C, data);
         mcu->RunProcedure(7);
@@ -2235,9 +2487,7 @@ uint16_t LMS7002M::SPI_read(uint16_t address, bool fromChip, OpStatus* status)
         if (address == 0x0640 || address == 0x0641)
         {
             MCU_BD* mcu = GetMCUControls();
-            mcu->RunProcedure(MCU_FUNCTION_GET_PROGRAM_ID);
-            if (mcu->WaitForMCU(100) != MCU_ID_CALIBRATIONS_SINGLE_IMAGE)
-                mcu->Program_MCU(mcu_program_lms7_dc_iq_calibration_bin, MCU_BD::MCU_PROG_MODE::SRAM);
+            mcu->EnsureProgramLoaded(mcu_program_lms7_dc_iq_calibration_bin, MCU_ID_CALIBRATIONS_SINGLE_IMAGE);
             SPI_write(0x002D, address);
             mcu->RunProcedure(8);
             mcu->WaitForMCU(50);
@@ -2284,6 +2534,9 @@ OpStatus LMS7002M::SPI_write_batch(const uint16_t* spiAddr, const uint16_t* spiD
         //refresh mac, because batch might also change active channel
         if (spiAddr[i] == LMS7param(MAC).address)
             mac = mRegistersMap->GetValue(0, LMS7param(MAC).address) & 0x0003;
+        //MCU control register write can reset the MCU and its program
+        if (spiAddr[i] == 0x0002)
+            mcuControl->InvalidateLoadedProgram();
     }
 
     if (data.size() == 0)
@@ -3269,6 +3522,11 @@ OpStatus LMS7002M::SetGFIRFilter(TRXDir dir, Channel ch, bool enabled, double ba
     return ResetLogicRegisters();
 }
 
+uint32_t LMS7002M::GetCGENConfigurationCount() const
+{
+    return mCGENConfigurationCount;
+}
+
 void LMS7002M::SetOnCGENChangeCallback(CGENChangeCallbackType callback, void* userData)
 {
     mCallback_onCGENChange = callback;
@@ -205,16 +205,9 @@ OpStatus LMS7002M::CalibrateTx(float_type bandwidth_Hz, bool useExtLoopback)
         band ? "BAND2" : "BAND1",
         Get_SPI_Reg_bits(LMS7_CG_IAMP_TBB));
 
-    uint8_t mcuID = mcuControl->ReadMCUProgramID();
-    lime::debug(
-        "Current MCU firmware: %i, %s", mcuID, mcuID == MCU_ID_CALIBRATIONS_SINGLE_IMAGE ? "DC/IQ calibration full" : "unknown");
-    if (mcuID != MCU_ID_CALIBRATIONS_SINGLE_IMAGE)
-    {
-        lime::debug("Uploading DC/IQ calibration firmware"s);
-        status = mcuControl->Program_MCU(mcu_program_lms7_dc_iq_calibration_bin, MCU_BD::MCU_PROG_MODE::SRAM);
-        if (status != 0)
-            return OpStatus::ERROR;
-    }
+    status = mcuControl->EnsureProgramLoaded(mcu_program_lms7_dc_iq_calibration_bin, MCU_ID_CALIBRATIONS_SINGLE_IMAGE);
+    if (status != 0)
+        return OpStatus::ERROR;
 
     //set reference clock parameter inside MCU
     long refClk = GetReferenceClk_SX(TRXDir::Rx);
@@ -322,16 +315,8 @@ OpStatus LMS7002M::CalibrateRx(float_type bandwidth_Hz, bool useExtLoopback)
 
     int dcoffi(0), dcoffq(0), gcorri(0), gcorrq(0), phaseOffset(0);
     //check if MCU has correct firmware
-    uint8_t mcuID = mcuControl->ReadMCUProgramID();
-    lime::debug(
-        "Current MCU firmware: %i, %s", mcuID, mcuID == MCU_ID_CALIBRATIONS_SINGLE_IMAGE ? "DC/IQ calibration full" : "unknown");
-    if (mcuID != MCU_ID_CALIBRATIONS_SINGLE_IMAGE)
-    {
-        lime::debug("Uploading DC/IQ calibration firmware");
-        int status = mcuControl->Program_MCU(mcu_program_lms7_dc_iq_calibration_bin, MCU_BD::MCU_PROG_MODE::SRAM);
-        if (status != 0)
-            return OpStatus::ERROR;
-    }
+    if (mcuControl->EnsureProgramLoaded(mcu_program_lms7_dc_iq_calibration_bin, MCU_ID_CALIBRATIONS_SINGLE_IMAGE) != 0)
+        return OpStatus::ERROR;
 
     //set reference clock parameter inside MCU
     long refClk = GetReferenceClk_SX(TRXDir::Rx);
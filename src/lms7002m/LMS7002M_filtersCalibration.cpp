@@ -91,11 +91,8 @@ OpStatus LMS7002M::TuneRxFilter(float_type rx_lpf_freq_RF)
         Log(LogType::LOG_WARNING, "Rx LPF min bandwidth is 4MHz when TIA gain is set to -12 dB");
     }
 
-    if (mcuControl->ReadMCUProgramID() != MCU_ID_CALIBRATIONS_SINGLE_IMAGE)
-    {
-        if ((status = mcuControl->Program_MCU(mcu_program_lms7_dc_iq_calibration_bin, MCU_BD::MCU_PROG_MODE::SRAM)))
-            return ReportError(OpStatus::ERROR, "Tune Rx Filter: failed to program MCU");
-    }
+    if ((status = mcuControl->EnsureProgramLoaded(mcu_program_lms7_dc_iq_calibration_bin, MCU_ID_CALIBRATIONS_SINGLE_IMAGE)))
+        return ReportError(OpStatus::ERROR, "Tune Rx Filter: failed to program MCU");
 
     //set reference clock parameter inside MCU
     long refClk = GetReferenceClk_SX(TRXDir::Rx);
@@ -149,11 +146,8 @@ OpStatus LMS7002M::TuneTxFilter(const float_type tx_lpf_freq_RF)
     if (!controlPort)
         return ReportError(OpStatus::IO_FAILURE, "Tune Tx Filter: No device connected");
 
-    if (mcuControl->ReadMCUProgramID() != MCU_ID_CALIBRATIONS_SINGLE_IMAGE)
-    {
-        if ((status = mcuControl->Program_MCU(mcu_program_lms7_dc_iq_calibration_bin, MCU_BD::MCU_PROG_MODE::SRAM)))
-            return ReportError(OpStatus::ERROR, "Tune Tx Filter: failed to program MCU");
-    }
+    if ((status = mcuControl->EnsureProgramLoaded(mcu_program_lms7_dc_iq_calibration_bin, MCU_ID_CALIBRATIONS_SINGLE_IMAGE)))
+        return ReportError(OpStatus::ERROR, "Tune Tx Filter: failed to program MCU");
 
     int ind = this->GetActiveChannelIndex() % 2;
     opt_gain_tbb[ind] = -1;
@@ -13,6 +13,9 @@ using namespace std;
 #include <assert.h>
 #include <thread>
 #include <list>
+#include <algorithm>
+#include <chrono>
+#include <vector>
 #include "limesuite/LMS7002M.h"
 #include "Logger.h"
 
@@ -31,6 +34,8 @@ MCU_BD::MCU_BD()
     stepsDone = 0;
     aborted = false;
     m_callback = nullptr;
+    mVerifiedProgramID = 0;
+    mPolledUploadRequired = false;
     //ctor
     int i = 0;
     m_serPort = NULL;
@@ -58,6 +63,7 @@ MCU_BD::~MCU_BD()
 void MCU_BD::Initialize(std::shared_ptr<ISPI> pSerPort, unsigned size)
 {
     m_serPort = pSerPort;
+    mVerifiedProgramID = 0;
 
     if (size > MCU_PROGRAM_SIZE)
     {
@@ -504,72 +510,36 @@ int MCU_BD::Program_MCU(const uint8_t* buffer, const MCU_BD::MCU_PROG_MODE mode)
     if (!m_serPort)
         return ReportError(ENOLINK, "Device not connected");
 
+    mVerifiedProgramID = 0;
 #ifndef NDEBUG
     auto timeStart = std::chrono::high_resolution_clock::now();
 #endif
     try
     {
         const auto timeout = std::chrono::milliseconds(100);
-        const uint32_t controlAddr = 0x0002;
-        const uint32_t statusReg = 0x0003;
-        const uint32_t addrDTM = 0x0004; //data to MCU
-        const uint16_t EMTPY_WRITE_BUFF = 1 << 0;
         const uint16_t PROGRAMMED = 1 << 6;
-        const uint8_t fifoLen = 64;
-        uint32_t wrdata[fifoLen];
-        uint32_t rddata = 0;
-        bool abort = false;
-        //reset MCU, set mode
-        wrdata[0] = (1 << 31) | controlAddr << 16 | 0;
-        wrdata[1] = (1 << 31) | controlAddr << 16 | (static_cast<uint32_t>(mode) & 0x3);
-
-        m_serPort->SPI(wrdata, nullptr, 2);
-
-        if (m_callback)
-            abort = m_callback(0, byte_array_size, "");
-
-        for (uint16_t i = 0; i < byte_array_size && !abort; i += fifoLen)
+        bool programmed = false;
+        if (!mPolledUploadRequired)
         {
-            //wait till EMPTY_WRITE_BUFF = 1
-            bool fifoEmpty = false;
-            wrdata[0] = statusReg;
-            auto t1 = std::chrono::high_resolution_clock::now();
-            auto t2 = t1;
-            do
+            // MCU drains the write FIFO faster than SPI can fill it, so the image is sent in large
+            // batches without checking the FIFO state, the PROGRAMMED flag confirms the result.
+            int status = UploadProgram(buffer, mode, false);
+            if (status != 0)
+                return status;
+            programmed = WaitForStatusFlag(PROGRAMMED, timeout);
+            if (!programmed)
             {
-                m_serPort->SPI(wrdata, &rddata, 1);
-                fifoEmpty = rddata & EMTPY_WRITE_BUFF;
-                t2 = std::chrono::high_resolution_clock::now();
-            } while ((!fifoEmpty) && (t2 - t1) < timeout);
-
-            if (!fifoEmpty)
-                return ReportError(ETIMEDOUT, "MCU FIFO full");
-
-            //write 32 bytes into FIFO
-            for (uint8_t j = 0; j < fifoLen; ++j)
-                wrdata[j] = (1 << 31) | addrDTM << 16 | buffer[i + j];
-
-            m_serPort->SPI(wrdata, nullptr, fifoLen);
-            if (m_callback)
-                abort = m_callback(i + fifoLen, byte_array_size, "");
-#ifndef NDEBUG
-            lime::debug("MCU programming : %4i/%4li\r", i + fifoLen, long(byte_array_size));
-#endif
-        };
-        if (abort)
-            return ReportError(-1, "operation aborted by user");
-
-        //wait until programmed flag
-        wrdata[0] = statusReg;
-        bool programmed = false;
-        auto t1 = std::chrono::high_resolution_clock::now();
-        auto t2 = t1;
-        do
+                lime::debug("MCU batched programming failed, falling back to FIFO polling"s);
+                mPolledUploadRequired = true;
+            }
+        }
+        if (!programmed)
         {
-            m_serPort->SPI(wrdata, &rddata, 1);
-            programmed = rddata & PROGRAMMED;
-            t2 = std::chrono::high_resolution_clock::now();
-        } while ((!programmed) && (t2 - t1) < timeout);
+            int status = UploadProgram(buffer, mode, true);
+            if (status != 0)
+                return status;
+            programmed = WaitForStatusFlag(PROGRAMMED, timeout);
+        }
 
 #ifndef NDEBUG
         auto timeEnd = std::chrono::high_resolution_clock::now();
@@ -588,8 +558,109 @@ int MCU_BD::Program_MCU(const uint8_t* buffer, const MCU_BD::MCU_PROG_MODE mode)
     }
 }
 
+/** @brief Resets the MCU and writes the program image into its write FIFO
+    @param buffer The program image
+    @param mode MCU memory initialization mode
+    @param pollFifo Whether to wait for the FIFO to empty before writing every FIFO length worth of bytes
+    @return 0:success, else error code
+*/
+int MCU_BD::UploadProgram(const uint8_t* buffer, const MCU_PROG_MODE mode, bool pollFifo)
+{
+    const auto timeout = std::chrono::milliseconds(100);
+    const uint32_t controlAddr = 0x0002;
+    const uint32_t addrDTM = 0x0004; //data to MCU
+    const uint16_t EMTPY_WRITE_BUFF = 1 << 0;
+    const uint16_t fifoLen = 64;
+    const uint16_t batchLen = pollFifo ? fifoLen : 1024;
+    std::vector<uint32_t> wrdata(batchLen);
+    bool abort = false;
+    //reset MCU, set mode
+    wrdata[0] = (1 << 31) | controlAddr << 16 | 0;
+    wrdata[1] = (1 << 31) | controlAddr << 16 | (static_cast<uint32_t>(mode) & 0x3);
+
+    m_serPort->SPI(wrdata.data(), nullptr, 2);
+
+    if (m_callback)
+        abort = m_callback(0, byte_array_size, "");
+
+    for (uint16_t i = 0; i < byte_array_size && !abort; i += batchLen)
+    {
+        if (pollFifo && !WaitForStatusFlag(EMTPY_WRITE_BUFF, timeout))
+            return ReportError(ETIMEDOUT, "MCU FIFO full");
+
+        const uint16_t count = std::min<int>(batchLen, byte_array_size - i);
+        for (uint16_t j = 0; j < count; ++j)
+            wrdata[j] = (1 << 31) | addrDTM << 16 | buffer[i + j];
+
+        m_serPort->SPI(wrdata.data(), nullptr, count);
+        if (m_callback)
+            abort = m_callback(i + count, byte_array_size, "");
+#ifndef NDEBUG
+        lime::debug("MCU programming : %4i/%4li\r", i + count, long(byte_array_size));
+#endif
+    }
+    if (abort)
+        return ReportError(-1, "operation aborted by user");
+    return 0;
+}
+
+/** @brief Polls the MCU status register until the given flag is set
+    @param flag The status register bit mask to wait for
+    @param timeout The maximum amount of time to wait
+    @return Whether the flag got set
+*/
+bool MCU_BD::WaitForStatusFlag(uint16_t flag, std::chrono::microseconds timeout)
+{
+    const uint32_t statusReg = 0x0003;
+    uint32_t rddata = 0;
+    const auto t1 = std::chrono::steady_clock::now();
+    do
+    {
+        m_serPort->SPI(&statusReg, &rddata, 1);
+        if (rddata & flag)
+            return true;
+    } while (std::chrono::steady_clock::now() - t1 < timeout);
+    return false;
+}
+
+/** @brief Uploads the program to MCU, unless it is already known to be loaded
+
+    The loaded program is remembered until a reset that wipes the MCU calls InvalidateLoadedProgram(),
+    so repeated calibrations neither read back the program ID nor reupload the image.
+    @param binArray The program image
+    @param programID The ID the program reports once it's running
+    @param mode MCU memory initialization mode
+    @return 0:success, else error code
+*/
+int MCU_BD::EnsureProgramLoaded(const uint8_t* binArray, uint8_t programID, const MCU_PROG_MODE mode)
+{
+    if (mVerifiedProgramID == programID)
+        return 0;
+
+    uint8_t loadedID = ReadMCUProgramID();
+    lime::debug("Current MCU firmware: %i, required: %i", loadedID, programID);
+    if (loadedID != programID)
+    {
+        lime::debug("Uploading MCU firmware %i", programID);
+        int status = Program_MCU(binArray, mode);
+        if (status != 0)
+            return status;
+        loadedID = ReadMCUProgramID();
+        if (loadedID != programID)
+            return ReportError(EIO, "MCU reports program ID %i after uploading program %i", loadedID, programID);
+    }
+    mVerifiedProgramID = programID;
+    return 0;
+}
+
+void MCU_BD::InvalidateLoadedProgram()
+{
+    mVerifiedProgramID = 0;
+}
+
 void MCU_BD::Reset_MCU()
 {
+    mVerifiedProgramID = 0;
     unsigned short tempi = 0x0000; // was 0x0000
     mSPI_write(0x8002, tempi);
     tempi = 0x0000;
@@ -987,14 +1058,18 @@ int MCU_BD::WaitForMCU(uint32_t timeout_ms)
     auto t1 = std::chrono::high_resolution_clock::now();
     auto t2 = t1;
     unsigned short value = 0;
-    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    // Short procedures finish within microseconds, calibrations take hundreds of milliseconds,
+    // so back off exponentially between polls.
+    auto pollDelay = std::chrono::microseconds(5);
+    const auto maxPollDelay = std::chrono::microseconds(1000);
     do
     {
+        std::this_thread::sleep_for(pollDelay);
+        pollDelay = std::min(pollDelay * 2, maxPollDelay);
         value = mSPI_read(0x0001) & 0xFF;
+        t2 = std::chrono::high_resolution_clock::now();
         if (value != 0xFF) //working
             break;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        t2 = std::chrono::high_resolution_clock::now();
     } while (std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() < timeout_ms);
     mSPI_write(0x0006, 0); //return SPI control to PC
     //if((value & 0x7f) != 0)
@@ -1066,6 +1141,7 @@ MCU_BD::OperationStatus MCU_BD::SetDebugMode(bool enabled, MCU_BD::MCU_PROG_MODE
     }
     if (enabled)
         regValue |= 0xC0;
+    mVerifiedProgramID = 0;
     mSPI_write(0x8002, regValue);
     return OperationStatus::SUCCESS;
 }
@@ -8,6 +8,7 @@
 #define MCU_BD_H
 
 #include <atomic>
+#include <chrono>
 #include <string>
 #include <functional>
 #include <memory>
@@ -96,6 +97,12 @@ class LIME_API MCU_BD
     int m_bLoadedProd;
     int byte_array_size;
 
+    uint8_t mVerifiedProgramID; ///< ID of the program known to be running in the MCU, 0 if unknown
+    bool mPolledUploadRequired; ///< Set once batched programming failed, to always wait for the write FIFO
+
+    int UploadProgram(const uint8_t* buffer, const MCU_PROG_MODE mode, bool pollFifo);
+    bool WaitForStatusFlag(uint16_t flag, std::chrono::microseconds timeout);
+
     void IncrementStepsDone(unsigned short amount = 1, const char* message = "");
     void SetStepsDone(unsigned short amount, const char* message = "");
 
@@ -128,6 +135,9 @@ class LIME_API MCU_BD
     int Read_SFR();
     int Program_MCU(int m_iMode1, int m_iMode0);
     int Program_MCU(const uint8_t* binArray, const MCU_PROG_MODE mode);
+    int EnsureProgramLoaded(const uint8_t* binArray, uint8_t programID, const MCU_PROG_MODE mode = MCU_PROG_MODE::SRAM);
+    /// Forgets which program is loaded, after a reset that wipes the MCU
+    void InvalidateLoadedProgram();
     void Reset_MCU();
     void RunTest_MCU(int m_iMode1, int m_iMode0, unsigned short test_code, int m_iDebug);
     int RunProductionTest_MCU();
@@ -30,7 +30,7 @@ GNUPlotPipe txDCPlot;
     #include <gnuPlotPipe.h>
 
 typedef std::vector<std::pair<float, float>> MeasurementsVector;
-MeasurementsVector gMeasurements;
+thread_local MeasurementsVector gMeasurements;
 
 void SortMeasurements(MeasurementsVector& vec)
 {
@@ -75,8 +75,8 @@ int16_t toSigned(int16_t val, uint8_t msblsb)
     return val;
 }
 
-float bandwidthRF = 5e6; //Calibration bandwidth
-uint16_t RSSIDelayCounter = 1; // MCU timer delay between RSSI measurements
+THREAD_LOCAL float bandwidthRF = 5e6; //Calibration bandwidth
+THREAD_LOCAL uint16_t RSSIDelayCounter = 1; // MCU timer delay between RSSI measurements
 #define calibrationSXOffset_Hz 1e6
 #define offsetNCO 0.1e6
 #define calibUserBwDivider 5
@@ -84,7 +84,7 @@ uint16_t RSSIDelayCounter = 1; // MCU timer delay between RSSI measurements
 // external loopback selection
 // [2] tx band, when calibrating Rx, 0-band1, 1-band2
 // [1:0] SEL_PATH_RFE, when calibrating Tx
-uint8_t extLoopbackPair = 0;
+THREAD_LOCAL uint8_t extLoopbackPair = 0;
 
 int16_t clamp(int16_t value, int16_t minBound, int16_t maxBound)
 {
@@ -116,7 +116,7 @@ void LoadDC_REG_TX_IQ()
     FlipRisingEdge(TSGDCLDQ_TXTSP);
 }
 
-extern float_type RefClk;
+extern THREAD_LOCAL float_type RefClk;
 void UpdateRSSIDelay()
 {
     const uint16_t sampleCount = (2 << 7) << Get_SPI_Reg_bits(AGC_AVG_RXTSP);
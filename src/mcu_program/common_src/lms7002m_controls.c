@@ -21,14 +21,14 @@ uint16_t gComparatorDelayCounter = 0xFF00; // ~100us @ ref 30.72MHz
 #define VERBOSE 0
 
 //TODO add functions to modify reference clock
-float_type RefClk = 30.72e6; //board reference clock
+THREAD_LOCAL float_type RefClk = 30.72e6; //board reference clock
 
 uint16_t pow2(const uint8_t power)
 {
     return 1 << power;
 }
 
-xdata uint16_t x0020state;
+THREAD_LOCAL xdata uint16_t x0020state;
 ROM const uint16_t chipStateAddr[] = {
     0x0021,
     0x002F, //LimeLight
@@ -53,7 +53,7 @@ ROM const uint16_t chipStateAddr[] = {
     0x5C0,
     0x5C0 //DC Calibration Configuration
 };
-xdata uint16_t chipStateData[500];
+THREAD_LOCAL xdata uint16_t chipStateData[500];
 
 void SaveChipState(bool wr)
 {
@@ -15,6 +15,7 @@ typedef bit bool;
     #define false 0
     #define true 1
     #define ROM code
+    #define THREAD_LOCAL
 #else //for convenience when compiling for PC
     #include <stdint.h>
     #include <stdbool.h>
@@ -22,6 +23,12 @@ typedef bit bool;
     #define ROM
     #define xdata
     #define bdata
+    // the host port keeps the chip being calibrated in globals, each thread calibrates its own chip
+    #ifdef __cplusplus
+        #define THREAD_LOCAL thread_local
+    #else
+        #define THREAD_LOCAL
+    #endif
 #endif
 
 #endif
@@ -3,10 +3,11 @@
 #include "limesuite/LMS7002M.h"
 #include "limesuite/commonTypes.h"
 
-static lime::LMS7002M* serPort;
+// SetupCalibrations() selects the chip for the calling thread only, so chips can be calibrated in parallel
+static thread_local lime::LMS7002M* serPort;
 
-extern "C" float bandwidthRF;
-extern "C" float RefClk;
+extern "C" thread_local float bandwidthRF;
+extern "C" thread_local float RefClk;
 
 void SetupCalibrations(lime::LMS7002M* chip, double BW)
 {
@@ -3,21 +3,31 @@
 #include "FPGA_common.h"
 #include "samplesConversion.h"
 
+#include <algorithm>
+#include <type_traits>
+
 namespace lime {
 
 template<class SrcT, class DestT>
 static int DeinterleaveMIMO(DestT* const* dest, const uint8_t* buffer, uint32_t length, const DataConversion& fmt)
 {
-    int samplesProduced = length / sizeof(SrcT);
-    const bool mimo = fmt.channelCount > 1;
-    if (!mimo)
-        PathSelection(dest[0], reinterpret_cast<const SrcT*>(buffer), length / sizeof(SrcT));
-    else
+    const uint32_t srcCount = length / sizeof(SrcT);
+    const uint8_t channelCount = std::max<uint8_t>(fmt.channelCount, 1);
+    if constexpr (std::is_same<SrcT, complex12packed_t>::value && std::is_same<DestT, complex32f_t>::value)
     {
-        PathSelectionUnzip(dest[0], dest[1], reinterpret_cast<const SrcT*>(buffer), length / sizeof(SrcT));
-        samplesProduced /= 2;
+        if (channelCount == 1)
+        {
+            complex12packed_to_complex32f(dest[0], reinterpret_cast<const SrcT*>(buffer), srcCount);
+            return srcCount;
+        }
+        if (channelCount == 2)
+        {
+            complex12packed_to_complex32f_unzip(dest[0], dest[1], reinterpret_cast<const SrcT*>(buffer), srcCount);
+            return srcCount / 2;
+        }
     }
-    return samplesProduced;
+    PathSelectionUnzipChannels(dest, reinterpret_cast<const SrcT*>(buffer), srcCount, channelCount);
+    return srcCount / channelCount;
 }
 
 template<class DestT>
@@ -55,17 +65,24 @@ int Deinterleave(void* const* dest, const uint8_t* buffer, uint32_t length, cons
 template<class DestT, class SrcT>
 static int InterleaveMIMO(uint8_t* buffer, const SrcT* const* input, uint32_t count, const DataConversion& fmt)
 {
-    DestT* dest = reinterpret_cast<DestT*>(buffer);
-    int bytesProduced = count * sizeof(DestT);
-    const bool mimo = fmt.channelCount > 1;
-    if (!mimo)
-        PathSelection(dest, input[0], count);
-    else
+    const uint8_t channelCount = std::max<uint8_t>(fmt.channelCount, 1);
+    if constexpr (std::is_same<DestT, complex12packed_t>::value && std::is_same<SrcT, complex32f_t>::value)
     {
-        PathSelectionZip(dest, input[0], input[1], count);
-        bytesProduced *= 2;
+        if (channelCount == 1)
+        {
+            complex32f_to_complex12packed(reinterpret_cast<DestT*>(buffer), input[0], count);
+            return count * sizeof(DestT);
+        }
+        if (channelCount == 2)
+        {
+            complex32f_to_complex12packed_zip(reinterpret_cast<DestT*>(buffer), input[0], input[1], count);
+            return count * sizeof(DestT) * 2;
+        }
+        complex32f_to_complex12packed_channels(reinterpret_cast<DestT*>(buffer), input, count, channelCount);
+        return count * sizeof(DestT) * channelCount;
     }
-    return bytesProduced;
+    PathSelectionZipChannels(reinterpret_cast<DestT*>(buffer), input, count, channelCount);
+    return count * sizeof(DestT) * channelCount;
 }
 
 template<class SrcT>
@@ -0,0 +1,171 @@
+#include "RxCorrector.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace lime;
+
+static constexpr RxCorrector::Coefficients identity{ 0, 0, 0, 1 };
+
+static inline void Store(complex32f_t& dest, float i, float q)
+{
+    dest.i = i;
+    dest.q = q;
+}
+
+static inline void Store(complex16_t& dest, float i, float q)
+{
+    i = std::clamp(i, -32768.0f, 32767.0f);
+    q = std::clamp(q, -32768.0f, 32767.0f);
+    dest.i = static_cast<int16_t>(i + (i < 0 ? -0.5f : 0.5f));
+    dest.q = static_cast<int16_t>(q + (q < 0 ? -0.5f : 0.5f));
+}
+
+/// @brief Constructs the corrector, starting with no correction.
+/// @param config The configuration of the corrector.
+/// @param channelCount The amount of received channels.
+RxCorrector::RxCorrector(const Config& config, uint8_t channelCount)
+    : mConfig(config)
+    , mChannels(channelCount)
+{
+    Reset();
+}
+
+/// @brief Corrects the samples in place and updates the estimates.
+/// @param samples The samples of each channel.
+/// @param count The amount of samples in each channel.
+void RxCorrector::Process(complex32f_t* const* samples, uint32_t count)
+{
+    ProcessTemplate(samples, count);
+}
+
+/// @copydoc RxCorrector::Process(complex32f_t* const*, uint32_t)
+void RxCorrector::Process(complex16_t* const* samples, uint32_t count)
+{
+    ProcessTemplate(samples, count);
+}
+
+/// @brief Forgets the estimates, as when the receiver settings change.
+void RxCorrector::Reset()
+{
+    for (Channel& channel : mChannels)
+    {
+        channel.moments = {};
+        channel.coefficients = identity;
+        channel.hasMoments = false;
+    }
+}
+
+/// @brief Gets the correction currently applied to a channel.
+/// @param channel The index of the channel.
+/// @return The correction coefficients.
+RxCorrector::Coefficients RxCorrector::GetCoefficients(uint8_t channel) const
+{
+    return mChannels.at(channel).coefficients;
+}
+
+template<class T> void RxCorrector::ProcessTemplate(T* const* samples, uint32_t count)
+{
+    if (count == 0)
+        return;
+
+    // every lane accumulates its own samples, so the compiler can vectorize the sums without reordering the additions
+    constexpr int lanes = 16;
+    for (std::size_t c = 0; c < mChannels.size(); ++c)
+    {
+        const Coefficients k = mChannels[c].coefficients;
+        float sumI[lanes] = {};
+        float sumQ[lanes] = {};
+        float powerI[lanes] = {};
+        float powerQ[lanes] = {};
+        float cross[lanes] = {};
+        auto correct = [&](T& sample, int lane) {
+            const float i = sample.i;
+            const float q = sample.q;
+            sumI[lane] += i;
+            sumQ[lane] += q;
+            powerI[lane] += i * i;
+            powerQ[lane] += q * q;
+            cross[lane] += i * q;
+            Store(sample, i - k.offsetI, k.qFromI * i + k.qFromQ * q - k.offsetQ);
+        };
+
+        T* data = samples[c];
+        uint32_t n = 0;
+        for (; n + lanes <= count; n += lanes)
+        {
+            T* block = &data[n];
+            for (int l = 0; l < lanes; ++l)
+                correct(block[l], l);
+        }
+        for (int l = 0; n < count; ++n, ++l)
+            correct(data[n], l);
+
+        Moments block{};
+        for (int l = 0; l < lanes; ++l)
+        {
+            block.meanI += sumI[l];
+            block.meanQ += sumQ[l];
+            block.powerI += powerI[l];
+            block.powerQ += powerQ[l];
+            block.cross += cross[l];
+        }
+        block.meanI /= count;
+        block.meanQ /= count;
+        block.powerI /= count;
+        block.powerQ /= count;
+        block.cross /= count;
+        Update(mChannels[c], block, count);
+    }
+}
+
+void RxCorrector::Update(Channel& channel, const Moments& block, uint32_t count)
+{
+    Moments& m = channel.moments;
+    if (!channel.hasMoments)
+    {
+        m = block;
+        channel.hasMoments = true;
+    }
+    else
+    {
+        const double alpha = std::min(1.0, static_cast<double>(count) / mConfig.averagingLength);
+        m.meanI += alpha * (block.meanI - m.meanI);
+        m.meanQ += alpha * (block.meanQ - m.meanQ);
+        m.powerI += alpha * (block.powerI - m.powerI);
+        m.powerQ += alpha * (block.powerQ - m.powerQ);
+        m.cross += alpha * (block.cross - m.cross);
+    }
+
+    const double varianceI = m.powerI - m.meanI * m.meanI;
+    const double varianceQ = m.powerQ - m.meanQ * m.meanQ;
+    const double covariance = m.cross - m.meanI * m.meanQ;
+
+    double qFromI = 0;
+    double qFromQ = 1;
+    if (mConfig.iqImbalance && varianceI > 0)
+    {
+        // remove the part of Q correlated with I, then match the powers
+        const double correlation = covariance / varianceI;
+        const double uncorrelatedQ = varianceQ - covariance * correlation;
+        if (uncorrelatedQ > 0)
+        {
+            qFromQ = std::sqrt(varianceI / uncorrelatedQ);
+            qFromI = -correlation * qFromQ;
+        }
+    }
+
+    Coefficients& k = channel.coefficients;
+    k.qFromI = qFromI;
+    k.qFromQ = qFromQ;
+    if (mConfig.dcOffset)
+    {
+        k.offsetI = m.meanI;
+        k.offsetQ = qFromI * m.meanI + qFromQ * m.meanQ;
+    }
+    else
+    {
+        k.offsetI = 0;
+        k.offsetQ = 0;
+    }
+}
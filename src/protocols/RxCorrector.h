@@ -0,0 +1,69 @@
+#ifndef LIME_RXCORRECTOR_H
+#define LIME_RXCORRECTOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "limesuite/SDRDevice.h"
+#include "limesuite/complex.h"
+
+namespace lime {
+
+/** @brief Host-side DC offset and IQ imbalance correction for the received samples.
+
+  The DC offset is tracked with a running average of the samples. The IQ imbalance is estimated
+  blindly, assuming the received signal is circular: the Q value is decorrelated from the I value
+  and scaled to the same power.
+
+  The statistics are gathered in the same pass that applies the correction, and the updated
+  correction is used from the next packet on.
+ */
+class RxCorrector
+{
+  public:
+    /// @brief The configuration of the corrector.
+    typedef SDRDevice::StreamConfig::Extras::RxCorrection Config;
+
+    /// @brief The correction of a single channel: I' = I - offsetI, Q' = qFromI * I + qFromQ * Q - offsetQ.
+    struct Coefficients {
+        float offsetI; ///< The value subtracted from I.
+        float offsetQ; ///< The value subtracted from the corrected Q.
+        float qFromI; ///< The share of I in the corrected Q.
+        float qFromQ; ///< The share of Q in the corrected Q.
+    };
+
+    RxCorrector(const Config& config, uint8_t channelCount);
+
+    void Process(complex32f_t* const* samples, uint32_t count);
+    void Process(complex16_t* const* samples, uint32_t count);
+    void Reset();
+
+    Coefficients GetCoefficients(uint8_t channel) const;
+
+  private:
+    /// @brief The running averages of the raw sample moments.
+    struct Moments {
+        double meanI;
+        double meanQ;
+        double powerI;
+        double powerQ;
+        double cross;
+    };
+
+    /// @brief The state of a single channel.
+    struct Channel {
+        Moments moments;
+        Coefficients coefficients;
+        bool hasMoments;
+    };
+
+    template<class T> void ProcessTemplate(T* const* samples, uint32_t count);
+    void Update(Channel& channel, const Moments& block, uint32_t count);
+
+    Config mConfig;
+    std::vector<Channel> mChannels;
+};
+
+} // namespace lime
+
+#endif // LIME_RXCORRECTOR_H
@@ -0,0 +1,224 @@
+#include "RxDecimator.h"
+
+#include "lms_gfir.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+using namespace lime;
+
+/// @brief Multiplies the interleaved I and Q values by the taps.
+/// Each lane accumulates separately, so the compiler can vectorize the loop without reordering the additions.
+/// @param samples The interleaved I and Q values.
+/// @param taps The taps, each repeated for the I and Q values.
+/// @param length The amount of values to multiply, must be a multiple of 8.
+/// @param i The sum of the I values.
+/// @param q The sum of the Q values.
+static inline void DotProduct(const float* samples, const float* taps, uint32_t length, float& i, float& q)
+{
+    constexpr int lanes = 8;
+    float sums[lanes] = {};
+    for (uint32_t n = 0; n < length; n += lanes)
+        for (int l = 0; l < lanes; ++l)
+            sums[l] += samples[n + l] * taps[n + l];
+    i = (sums[0] + sums[2]) + (sums[4] + sums[6]);
+    q = (sums[1] + sums[3]) + (sums[5] + sums[7]);
+}
+
+static inline complex32f_t ToFloat(const complex32f_t& sample)
+{
+    return sample;
+}
+
+static inline complex32f_t ToFloat(const complex16_t& sample)
+{
+    return complex32f_t(sample.i, sample.q);
+}
+
+static inline void FromFloat(complex32f_t& dest, float i, float q)
+{
+    dest.i = i;
+    dest.q = q;
+}
+
+static inline void FromFloat(complex16_t& dest, float i, float q)
+{
+    dest.i = std::clamp(std::lround(i), -32768L, 32767L);
+    dest.q = std::clamp(std::lround(q), -32768L, 32767L);
+}
+
+/// @brief Constructs the decimator, the configuration must have passed Validate().
+/// @param config The configuration of the decimator.
+/// @param inputChannelCount The amount of received channels.
+RxDecimator::RxDecimator(const Config& config, uint8_t inputChannelCount)
+    : mRatio(config.ratio)
+    , mHistory(inputChannelCount)
+    , mExpectedTimestamp(0)
+    , mHasHistory(false)
+{
+    const std::vector<float> lowpass = DesignLowpass(config.ratio, config.tapsPerPhase, config.bandwidth);
+    // whole vectorized loop iterations
+    mTapCount = (lowpass.size() + 3) & ~3;
+
+    // the window ends with the newest sample, so the taps are stored reversed
+    auto reversedTaps = [this, &lowpass](double frequency, bool imaginary) {
+        std::vector<float> taps(mTapCount * 2, 0);
+        for (std::size_t n = 0; n < lowpass.size(); ++n)
+        {
+            const double phase = 2 * M_PI * frequency * n;
+            const float tap = lowpass[n] * (imaginary ? std::sin(phase) : std::cos(phase));
+            const std::size_t position = mTapCount - 1 - n;
+            taps[position * 2] = tap;
+            taps[position * 2 + 1] = tap;
+        }
+        return taps;
+    };
+
+    if (!config.channelize)
+    {
+        for (uint8_t c = 0; c < inputChannelCount; ++c)
+            mOutputs.push_back({ c, reversedTaps(0, false), {} });
+        return;
+    }
+
+    for (uint8_t subChannel : config.subChannels)
+    {
+        const double frequency = static_cast<double>(subChannel) / mRatio;
+        Output output{ 0, reversedTaps(frequency, false), {} };
+        if (subChannel != 0)
+            output.tapsQ = reversedTaps(frequency, true);
+        mOutputs.push_back(std::move(output));
+    }
+}
+
+/// @brief Decimates the samples in place.
+/// @param samples The samples of each input channel, the outputs are written over them in the output channel order.
+/// @param count The amount of samples in each input channel.
+/// @param timestamp The timestamp of the first input sample.
+/// @param outputTimestamp The timestamp of the first output sample, in the output sample rate.
+/// @return The amount of samples in each output channel.
+uint32_t RxDecimator::Process(complex32f_t* const* samples, uint32_t count, uint64_t timestamp, uint64_t* outputTimestamp)
+{
+    return ProcessTemplate(samples, count, timestamp, outputTimestamp);
+}
+
+/// @copydoc RxDecimator::Process(complex32f_t* const*, uint32_t, uint64_t, uint64_t*)
+uint32_t RxDecimator::Process(complex16_t* const* samples, uint32_t count, uint64_t timestamp, uint64_t* outputTimestamp)
+{
+    return ProcessTemplate(samples, count, timestamp, outputTimestamp);
+}
+
+/// @brief Clears the filter history, as when the input is discontinuous.
+void RxDecimator::Reset()
+{
+    for (auto& history : mHistory)
+        history.assign(mTapCount - 1, complex32f_t(0, 0));
+    mHasHistory = true;
+}
+
+template<class T>
+uint32_t RxDecimator::ProcessTemplate(T* const* samples, uint32_t count, uint64_t timestamp, uint64_t* outputTimestamp)
+{
+    // lost packets would make the history belong to other samples
+    if (!mHasHistory || timestamp != mExpectedTimestamp)
+        Reset();
+    mExpectedTimestamp = timestamp + count;
+
+    const uint32_t first = (mRatio - timestamp % mRatio) % mRatio;
+    const uint32_t produced = first < count ? (count - 1 - first) / mRatio + 1 : 0;
+    if (outputTimestamp)
+        *outputTimestamp = (timestamp + first) / mRatio;
+
+    const uint32_t historyLength = mTapCount - 1;
+    for (std::size_t c = 0; c < mHistory.size(); ++c)
+    {
+        std::vector<complex32f_t>& history = mHistory[c];
+        history.resize(historyLength + count);
+        for (uint32_t n = 0; n < count; ++n)
+            history[historyLength + n] = ToFloat(samples[c][n]);
+    }
+
+    // the inputs are already copied, so the outputs can overwrite them
+    for (std::size_t o = 0; o < mOutputs.size(); ++o)
+    {
+        const Output& output = mOutputs[o];
+        const float* window = reinterpret_cast<const float*>(mHistory[output.input].data() + first);
+        T* dest = samples[o];
+        for (uint32_t m = 0; m < produced; ++m, window += 2 * mRatio)
+        {
+            float i, q;
+            DotProduct(window, output.tapsI.data(), 2 * mTapCount, i, q);
+            if (!output.tapsQ.empty())
+            {
+                float iq, qq;
+                DotProduct(window, output.tapsQ.data(), 2 * mTapCount, iq, qq);
+                i -= qq;
+                q += iq;
+            }
+            FromFloat(dest[m], i, q);
+        }
+    }
+
+    for (auto& history : mHistory)
+    {
+        std::copy(history.end() - historyLength, history.end(), history.begin());
+        history.resize(historyLength);
+    }
+    return produced;
+}
+
+/// @brief Checks whether the decimator can be constructed with the given configuration.
+/// @param config The configuration to check.
+/// @param inputChannelCount The amount of received channels.
+/// @return The status of the operation.
+OpStatus RxDecimator::Validate(const Config& config, uint8_t inputChannelCount)
+{
+    if (config.ratio == 0)
+        return ReportError(OpStatus::INVALID_VALUE, "Rx decimation ratio must be at least 1");
+    if (config.ratio == 1)
+        return OpStatus::SUCCESS;
+    if (!(config.bandwidth > 0 && config.bandwidth < 1))
+        return ReportError(OpStatus::INVALID_VALUE, "Rx decimation bandwidth (%g) must be in (0;1)", config.bandwidth);
+    if (config.tapsPerPhase == 0 || config.ratio * config.tapsPerPhase > maxTaps)
+        return ReportError(OpStatus::INVALID_VALUE, "Rx decimation filter can have up to %u taps", maxTaps);
+    if (!config.channelize)
+        return OpStatus::SUCCESS;
+
+    if (inputChannelCount != 1)
+        return ReportError(OpStatus::INVALID_VALUE, "Rx channelizer supports only a single Rx channel");
+    if (config.subChannels.empty() || config.subChannels.size() > 2)
+        return ReportError(OpStatus::INVALID_VALUE, "Rx channelizer can deliver 1 or 2 sub-channels");
+    for (uint8_t subChannel : config.subChannels)
+    {
+        if (subChannel >= config.ratio)
+            return ReportError(OpStatus::INVALID_VALUE, "Rx channelizer sub-channel %i is out of range", subChannel);
+    }
+    return OpStatus::SUCCESS;
+}
+
+/// @brief Designs the anti-aliasing low-pass filter using the GFIR design code.
+/// @param ratio The decimation ratio.
+/// @param tapsPerPhase The filter length of each polyphase branch.
+/// @param bandwidth The passband width as a fraction of the output sample rate.
+/// @return The filter taps, normalized to the unity gain at DC.
+std::vector<float> RxDecimator::DesignLowpass(uint8_t ratio, uint8_t tapsPerPhase, float bandwidth)
+{
+    const int tapCount = ratio * tapsPerPhase;
+    // normalized to the input sample rate, nothing must alias into the passband after decimation
+    const double passband = bandwidth * 0.5 / ratio;
+    const double stopband = (1.0 - bandwidth * 0.5) / ratio;
+
+    std::vector<double> coefs(tapCount);
+    GenerateFilter(tapCount, passband, stopband, 1.0, 0, coefs.data());
+
+    double sum = 0;
+    for (double coef : coefs)
+        sum += coef;
+
+    std::vector<float> taps(tapCount);
+    for (int n = 0; n < tapCount; ++n)
+        taps[n] = sum != 0 ? coefs[n] / sum : 0;
+    return taps;
+}
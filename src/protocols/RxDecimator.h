@@ -0,0 +1,69 @@
+#ifndef LIME_RXDECIMATOR_H
+#define LIME_RXDECIMATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "limesuite/SDRDevice.h"
+#include "limesuite/complex.h"
+
+namespace lime {
+
+/** @brief Host-side polyphase FIR decimator and channelizer for the received samples.
+
+  In decimation mode every input channel is low-pass filtered and decimated by the ratio.
+  In channelizer mode the single input channel is split into ratio channels spaced by the output
+  sample rate, and only the requested sub-channels are computed, each with its own modulated filter.
+
+  Only the kept outputs are computed. They are aligned to the input timestamps that are multiples
+  of the ratio, so an output timestamp is the input timestamp divided by the ratio.
+ */
+class RxDecimator
+{
+  public:
+    /// @brief The configuration of the decimator.
+    typedef SDRDevice::StreamConfig::Extras::RxDecimation Config;
+
+    /// The maximum total filter length.
+    static constexpr uint32_t maxTaps = 512;
+
+    RxDecimator(const Config& config, uint8_t inputChannelCount);
+
+    uint32_t Process(complex32f_t* const* samples, uint32_t count, uint64_t timestamp, uint64_t* outputTimestamp);
+    uint32_t Process(complex16_t* const* samples, uint32_t count, uint64_t timestamp, uint64_t* outputTimestamp);
+    void Reset();
+
+    /// @brief Gets the decimation ratio.
+    /// @return The decimation ratio.
+    uint8_t GetRatio() const { return mRatio; }
+
+    /// @brief Gets the amount of channels the decimator outputs.
+    /// @return The amount of output channels.
+    uint8_t GetOutputChannelCount() const { return mOutputs.size(); }
+
+    static OpStatus Validate(const Config& config, uint8_t inputChannelCount);
+    static std::vector<float> DesignLowpass(uint8_t ratio, uint8_t tapsPerPhase, float bandwidth);
+
+  private:
+    /// @brief The filter of a single output channel.
+    struct Output {
+        uint8_t input; ///< The index of the input channel.
+        /// The reversed real parts of the taps, each repeated for the I and Q values.
+        std::vector<float> tapsI;
+        /// The reversed imaginary parts of the taps, each repeated for the I and Q values, empty for real filters.
+        std::vector<float> tapsQ;
+    };
+
+    template<class T> uint32_t ProcessTemplate(T* const* samples, uint32_t count, uint64_t timestamp, uint64_t* outputTimestamp);
+
+    uint8_t mRatio;
+    uint32_t mTapCount;
+    std::vector<Output> mOutputs;
+    std::vector<std::vector<complex32f_t>> mHistory;
+    uint64_t mExpectedTimestamp;
+    bool mHasHistory;
+};
+
+} // namespace lime
+
+#endif // LIME_RXDECIMATOR_H
@@ -188,6 +188,7 @@ template<uint8_t chCount> class SamplesPacket
   public:
     bool useTimestamp; ///< Whether to use the timestamp or not.
     bool flush; ///< Whether to flush the whole packet early or not.
+    bool endOfBurst; ///< Whether the packet holds the last samples of a Tx burst.
 };
 
 } // namespace lime
@@ -0,0 +1,243 @@
+#include "StreamStatsReporter.h"
+
+#include "Logger.h"
+#include "threadHelper.h"
+
+#include <cstdio>
+
+using namespace lime;
+using namespace std::chrono;
+
+static constexpr uint8_t freshValue = 0x4;
+static constexpr uint8_t indexMask = 0x3;
+
+/// @brief Constructs the snapshot with all of the counters cleared.
+StreamStatsReporter::Snapshot::Snapshot()
+    : timestamp(0)
+    , bytesTransferred(0)
+    , packets(0)
+    , overrun(0)
+    , underrun(0)
+    , loss(0)
+    , fifoLevel(0)
+    , hasDMAState(false)
+    , dmaSoftwareIndex(0)
+    , dmaHardwareIndex(0)
+    , hasTxAdvance(false)
+    , txAdvanceInMicroseconds(false)
+    , txAdvanceMin(0)
+    , txAdvanceAverage(0)
+    , txAdvanceMax(0)
+{
+}
+
+/// @brief Constructs the reporter, its thread is started by Start().
+StreamStatsReporter::StreamStatsReporter()
+    : mLogToInfo(false)
+    , mCallback(nullptr)
+    , mStatusCallback(nullptr)
+    , mStatusUserData(nullptr)
+    , mTerminate(false)
+{
+    Reset();
+}
+
+/// @brief Stops the reporting thread.
+StreamStatsReporter::~StreamStatsReporter()
+{
+    Stop();
+}
+
+/// @brief Starts the reporting thread, forgetting the snapshots of the previous stream.
+/// @param callback The callback to pass the statistics to, can be null.
+/// @param pollPeriod How often to check for new snapshots.
+void StreamStatsReporter::Start(SDRDevice::LogCallbackType callback, milliseconds pollPeriod)
+{
+    Stop();
+    Reset();
+    mCallback = callback;
+    mTerminate = false;
+    mThread = std::thread(&StreamStatsReporter::ReporterLoop, this, pollPeriod);
+    SetOSThreadPriority(ThreadPriority::LOWEST, ThreadPolicy::DEFAULT, &mThread);
+#ifdef __linux__
+    pthread_setname_np(mThread.native_handle(), "lime:Stats");
+#endif
+}
+
+/// @brief Stops the reporting thread after reporting the last published snapshots.
+void StreamStatsReporter::Stop()
+{
+    if (!mThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTerminate = true;
+    }
+    mCv.notify_all();
+    mThread.join();
+    ReportPending();
+    for (Direction& direction : mDirections)
+        direction.dataRate.store(0, std::memory_order_relaxed);
+}
+
+/// @brief Publishes the counters of a streaming thread, never blocks.
+/// @note Only a single thread may publish the snapshots of a direction.
+/// @param dir The direction of the stream.
+/// @param snapshot The current counters of the stream.
+void StreamStatsReporter::Publish(TRXDir dir, const Snapshot& snapshot)
+{
+    mDirections[static_cast<int>(dir)].snapshots.Publish(snapshot);
+}
+
+/// @brief Publishes a status change of a streaming thread for the status callback, never blocks.
+/// @note Only a single thread may publish the status of a direction.
+/// Only the latest status is delivered if several are published before the reporting thread takes them,
+/// the counters in it are cumulative.
+/// @param dir The direction of the stream.
+/// @param stats The current statistics of the stream.
+void StreamStatsReporter::PublishStatus(TRXDir dir, const SDRDevice::StreamStats& stats)
+{
+    mDirections[static_cast<int>(dir)].status.Publish(stats);
+    mCv.notify_one();
+}
+
+/// @brief Reports the snapshots and delivers the status changes published since the previous call,
+/// done periodically by the reporting thread.
+void StreamStatsReporter::ReportPending()
+{
+    for (int d = 0; d < 2; ++d)
+    {
+        Direction& direction = mDirections[d];
+        const SDRDevice::StreamStats* status = direction.status.Take();
+        if (status && mStatusCallback)
+            mStatusCallback(static_cast<TRXDir>(d) == TRXDir::Tx, status, mStatusUserData);
+
+        const Snapshot* snapshot = direction.snapshots.Take();
+        if (snapshot)
+            Report(static_cast<TRXDir>(d), *snapshot);
+    }
+}
+
+template<class T> void StreamStatsReporter::LatestValue<T>::Reset()
+{
+    middle.store(0, std::memory_order_relaxed);
+    back = 1;
+    front = 2;
+}
+
+template<class T> void StreamStatsReporter::LatestValue<T>::Publish(const T& value)
+{
+    buffers[back] = value;
+    back = middle.exchange(back | freshValue, std::memory_order_acq_rel) & indexMask;
+}
+
+/// @return The value published since the previous call, or null if there is none.
+template<class T> const T* StreamStatsReporter::LatestValue<T>::Take()
+{
+    if ((middle.load(std::memory_order_relaxed) & freshValue) == 0)
+        return nullptr;
+
+    front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+    return &buffers[front];
+}
+
+void StreamStatsReporter::Reset()
+{
+    for (Direction& direction : mDirections)
+    {
+        direction.snapshots.Reset();
+        direction.status.Reset();
+        direction.hasPrevious = false;
+        direction.dataRate.store(0, std::memory_order_relaxed);
+    }
+}
+
+void StreamStatsReporter::Report(TRXDir dir, const Snapshot& current)
+{
+    Direction& direction = mDirections[static_cast<int>(dir)];
+    const Snapshot previous = direction.previous;
+    const bool hasPrevious = direction.hasPrevious;
+    direction.previous = current;
+    direction.hasPrevious = true;
+
+    // the first snapshot of a stream is only the reference for the following ones
+    const double seconds = duration<double>(current.time - previous.time).count();
+    if (!hasPrevious || seconds <= 0)
+        return;
+
+    const float dataRate = (current.bytesTransferred - previous.bytesTransferred) / seconds;
+    direction.dataRate.store(dataRate, std::memory_order_relaxed);
+
+    if (!mLogToInfo && mCallback == nullptr)
+        return;
+
+    const int32_t overrunDelta = current.overrun - previous.overrun;
+    const int32_t underrunDelta = current.underrun - previous.underrun;
+    const int32_t lossDelta = current.loss - previous.loss;
+
+    char msg[512];
+    const std::size_t size = sizeof(msg);
+    int length = snprintf(msg,
+        size,
+        "%s%s%s: %3.3f MB/s | TS:%lli pkt:%lli",
+        mName.c_str(),
+        mName.empty() ? "" : " ",
+        ToCString(dir),
+        dataRate / 1e6,
+        static_cast<long long>(current.timestamp),
+        static_cast<long long>(current.packets));
+
+    auto append = [&](const char* format, auto... args) {
+        if (length >= 0 && static_cast<std::size_t>(length) < size)
+            length += snprintf(msg + length, size - length, format, args...);
+    };
+
+    if (dir == TRXDir::Rx)
+    {
+        append(" o:%i(%+i) l:%i(%+i)", current.overrun, overrunDelta, current.loss, lossDelta);
+        if (current.hasDMAState)
+            append(" dma:%u/%u(%u)",
+                current.dmaSoftwareIndex,
+                current.dmaHardwareIndex,
+                current.dmaHardwareIndex - current.dmaSoftwareIndex);
+        append(" swFIFO:%zu", current.fifoLevel);
+    }
+    else
+    {
+        append(" o:%i", current.overrun);
+        if (current.hasDMAState)
+            append(" shw:%u/%u(%+i)",
+                current.dmaSoftwareIndex,
+                current.dmaHardwareIndex,
+                static_cast<int32_t>(current.dmaSoftwareIndex - current.dmaHardwareIndex));
+        append(" u:%i(%+i) l:%i(%+i)", current.underrun, underrunDelta, current.loss, lossDelta);
+        if (current.hasTxAdvance)
+            append(" tsAdvance:%+.0f/%+.0f/%+.0f%s",
+                current.txAdvanceMin,
+                current.txAdvanceAverage,
+                current.txAdvanceMax,
+                current.txAdvanceInMicroseconds ? "us" : "");
+        append(", f:%zu", current.fifoLevel);
+    }
+
+    if (mLogToInfo)
+        lime::info("%s", msg);
+    if (mCallback)
+    {
+        const bool showAsWarning = overrunDelta || underrunDelta || lossDelta;
+        mCallback(showAsWarning ? SDRDevice::LogLevel::WARNING : SDRDevice::LogLevel::DEBUG, msg);
+    }
+}
+
+void StreamStatsReporter::ReporterLoop(milliseconds pollPeriod)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    while (!mTerminate)
+    {
+        mCv.wait_for(lock, pollPeriod);
+        lock.unlock();
+        ReportPending();
+        lock.lock();
+    }
+}
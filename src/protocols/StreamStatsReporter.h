@@ -0,0 +1,120 @@
+#ifndef LIME_STREAMSTATSREPORTER_H
+#define LIME_STREAMSTATSREPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "limesuite/commonTypes.h"
+#include "limesuite/SDRDevice.h"
+
+namespace lime {
+
+/** @brief Formats and logs the periodic statistics of the streaming threads.
+
+  The streaming threads only publish their raw counters, which takes a copy and an atomic exchange.
+  The data rates, the formatting and the logging are done by a low priority thread of the reporter,
+  so the streaming threads are not delayed by them.
+  The stream status changes are passed to the user's status callback by the same thread.
+ */
+class StreamStatsReporter
+{
+  public:
+    /// @brief The raw counters of a streaming direction.
+    struct Snapshot {
+        Snapshot();
+        std::chrono::steady_clock::time_point time; ///< The time the counters were taken at.
+        uint64_t timestamp; ///< The current sample timestamp of the stream.
+        int64_t bytesTransferred; ///< The total amount of bytes transferred.
+        int64_t packets; ///< The total amount of packets transferred.
+        uint32_t overrun; ///< The total amount of packets overrun.
+        uint32_t underrun; ///< The total amount of packets underrun.
+        uint32_t loss; ///< The total amount of packets lost.
+        std::size_t fifoLevel; ///< The amount of packets in the software FIFO.
+        bool hasDMAState; ///< Whether the DMA buffer indexes are valid.
+        uint32_t dmaSoftwareIndex; ///< The DMA buffer index of the host.
+        uint32_t dmaHardwareIndex; ///< The DMA buffer index of the device.
+        bool hasTxAdvance; ///< Whether the Tx timestamp advance values are valid.
+        bool txAdvanceInMicroseconds; ///< Whether the Tx timestamp advance values are in microseconds or in samples.
+        float txAdvanceMin; ///< The minimum Tx timestamp advance since the previous snapshot.
+        float txAdvanceAverage; ///< The average Tx timestamp advance since the previous snapshot.
+        float txAdvanceMax; ///< The maximum Tx timestamp advance since the previous snapshot.
+    };
+
+    StreamStatsReporter();
+    ~StreamStatsReporter();
+
+    /// @brief Sets the name printed in front of the statistics.
+    /// @param name The name of the stream, usually the path of its port.
+    void SetName(const std::string& name) { mName = name; }
+
+    /// @brief Sets whether the statistics are also logged with lime::info().
+    /// @param enable Whether to log the statistics at the information level.
+    void SetLogToInfo(bool enable) { mLogToInfo = enable; }
+
+    /// @brief Sets the user's function the stream status changes are delivered to.
+    /// @param callback The status callback of the stream configuration, can be null.
+    /// @param userData The data to pass to the callback.
+    void SetStatusCallback(SDRDevice::StreamConfig::StatusCallbackFunc callback, void* userData)
+    {
+        mStatusCallback = callback;
+        mStatusUserData = userData;
+    }
+
+    void Start(SDRDevice::LogCallbackType callback, std::chrono::milliseconds pollPeriod = std::chrono::milliseconds(100));
+    void Stop();
+
+    void Publish(TRXDir dir, const Snapshot& snapshot);
+    void PublishStatus(TRXDir dir, const SDRDevice::StreamStats& stats);
+    void ReportPending();
+
+    /// @brief Gets the data rate calculated from the last two snapshots.
+    /// @param dir The direction of the stream.
+    /// @return The data rate (in bytes per second).
+    float GetDataRate(TRXDir dir) const { return mDirections[static_cast<int>(dir)].dataRate.load(std::memory_order_relaxed); }
+
+  private:
+    /// @brief Passes the latest value from a single producer to a single consumer without locking.
+    template<class T> struct LatestValue {
+        void Reset();
+        void Publish(const T& value);
+        const T* Take();
+
+        T buffers[3];
+        std::atomic<uint8_t> middle; // buffer index and the fresh flag
+        uint8_t back; // written only by the producer
+        uint8_t front; // read only by the consumer
+    };
+
+    struct Direction {
+        LatestValue<Snapshot> snapshots;
+        LatestValue<SDRDevice::StreamStats> status;
+        Snapshot previous;
+        bool hasPrevious;
+        std::atomic<float> dataRate;
+    };
+
+    void Reset();
+    void Report(TRXDir dir, const Snapshot& current);
+    void ReporterLoop(std::chrono::milliseconds pollPeriod);
+
+    std::string mName;
+    bool mLogToInfo;
+    SDRDevice::LogCallbackType mCallback;
+    SDRDevice::StreamConfig::StatusCallbackFunc mStatusCallback;
+    void* mStatusUserData;
+    Direction mDirections[2];
+
+    std::mutex mLock;
+    std::condition_variable mCv;
+    std::thread mThread;
+    bool mTerminate;
+};
+
+} // namespace lime
+
+#endif // LIME_STREAMSTATSREPORTER_H
@@ -6,6 +6,9 @@
 #include <complex>
 #include "LMSBoards.h"
 #include "threadHelper.h"
+#include "WriteRegistersBatch.h"
+#include "RxCorrector.h"
+#include "RxDecimator.h"
 
 #include "TRXLooper.h"
 
@@ -36,14 +39,21 @@ TRXLooper::TRXLooper(FPGA* f, LMS7002M* chip, int id)
 
     lms = chip, fpga = f;
     chipId = id;
+    mChannelCount = 2;
     mTimestampOffset = 0;
     mRx.lastTimestamp.store(0, std::memory_order_relaxed);
     mRx.terminate.store(false, std::memory_order_relaxed);
     mTx.terminate.store(false, std::memory_order_relaxed);
+    mTxBurstEnd.store(txBurstActive, std::memory_order_relaxed);
+    mRxSeekTimestamp.store(0, std::memory_order_relaxed);
+    mRxCorrector = nullptr;
+    mRxDecimator = nullptr;
 }
 
 TRXLooper::~TRXLooper()
 {
+    delete mRxCorrector;
+    delete mRxDecimator;
 }
 
 /// @brief Gets the current timestamp of the hardware.
@@ -75,11 +85,13 @@ OpStatus TRXLooper::Setup(const SDRDevice::StreamConfig& cfg)
     //bool needMIMO = cfg.rxCount > 1 || cfg.txCount > 1; // TODO: what if using only B channel, does it need MIMO configuration?
     uint8_t channelEnables = 0;
 
+    if (cfg.channels.at(TRXDir::Rx).size() > mChannelCount)
+        return ReportError(OpStatus::INVALID_VALUE, "Too many Rx channels, at most %i supported", mChannelCount);
     for (std::size_t i = 0; i < cfg.channels.at(TRXDir::Rx).size(); ++i)
     {
-        if (cfg.channels.at(TRXDir::Rx).at(i) > 1)
+        if (cfg.channels.at(TRXDir::Rx).at(i) >= mChannelCount)
         {
-            return ReportError(OpStatus::INVALID_VALUE, "Invalid Rx channel, only [0,1] channels supported");
+            return ReportError(OpStatus::INVALID_VALUE, "Invalid Rx channel, only [0,%i] channels supported", mChannelCount - 1);
         }
         else
         {
@@ -87,11 +99,13 @@ OpStatus TRXLooper::Setup(const SDRDevice::StreamConfig& cfg)
         }
     }
 
+    if (cfg.channels.at(TRXDir::Tx).size() > mChannelCount)
+        return ReportError(OpStatus::INVALID_VALUE, "Too many Tx channels, at most %i supported", mChannelCount);
     for (std::size_t i = 0; i < cfg.channels.at(TRXDir::Tx).size(); ++i)
     {
-        if (cfg.channels.at(TRXDir::Tx).at(i) > 1)
+        if (cfg.channels.at(TRXDir::Tx).at(i) >= mChannelCount)
         {
-            return ReportError(OpStatus::INVALID_VALUE, "Invalid Tx channel, only [0,1] channels supported");
+            return ReportError(OpStatus::INVALID_VALUE, "Invalid Tx channel, only [0,%i] channels supported", mChannelCount - 1);
         }
         else
         {
@@ -105,8 +119,26 @@ OpStatus TRXLooper::Setup(const SDRDevice::StreamConfig& cfg)
         return ReportError(OpStatus::INVALID_VALUE, "Unsupported stream link format");
     }
 
+    const auto& correction = cfg.extraConfig.rxCorrection;
+    if ((correction.dcOffset || correction.iqImbalance) && correction.averagingLength == 0)
+        return ReportError(OpStatus::INVALID_VALUE, "Rx correction averaging length must be positive");
+
+    OpStatus status = RxDecimator::Validate(cfg.extraConfig.rxDecimation, cfg.channels.at(TRXDir::Rx).size());
+    if (status != OpStatus::SUCCESS)
+        return status;
+
     mConfig = cfg;
 
+    delete mRxCorrector;
+    mRxCorrector = nullptr;
+    if (needRx && (correction.dcOffset || correction.iqImbalance))
+        mRxCorrector = new RxCorrector(correction, cfg.channels.at(TRXDir::Rx).size());
+
+    delete mRxDecimator;
+    mRxDecimator = nullptr;
+    if (needRx && cfg.extraConfig.rxDecimation.ratio > 1)
+        mRxDecimator = new RxDecimator(cfg.extraConfig.rxDecimation, cfg.channels.at(TRXDir::Rx).size());
+
     //configure FPGA on first start, or disable FPGA when not streaming
     if (!needTx && !needRx)
         return OpStatus::SUCCESS;
@@ -114,7 +146,8 @@ OpStatus TRXLooper::Setup(const SDRDevice::StreamConfig& cfg)
     assert(fpga);
     fpga->WriteRegister(0xFFFF, 1 << chipId);
     fpga->StopStreaming();
-    fpga->WriteRegister(0xD, 0); //stop WFM
+    WriteRegistersBatch batch(fpga);
+    batch.WriteRegister(0xD, 0); //stop WFM
     mRx.lastTimestamp.store(0, std::memory_order_relaxed);
 
     // const uint16_t MIMO_EN = needMIMO << 8;
@@ -133,23 +166,28 @@ OpStatus TRXLooper::Setup(const SDRDevice::StreamConfig& cfg)
         mode = 0x0180;
 
     const uint16_t smpl_width = cfg.linkFormat == SDRDevice::StreamConfig::DataFormat::I12 ? 2 : 0;
-    fpga->WriteRegister(0x0008, mode | smpl_width);
-    fpga->WriteRegister(0x0007, channelEnables);
-    fpga->ResetTimestamp();
+    batch.WriteRegister(0x0008, mode | smpl_width);
+    batch.WriteRegister(0x0007, channelEnables);
 
     // XTRX has RF switches control bits where the GPS_PPS control should be.
-    bool hasGPSPPS = fpga->ReadRegister(0x0000) != LMS_DEV_LIMESDR_XTRX;
+    const uint32_t readAddrs[] = { 0x0000, 0x000A };
+    uint32_t readValues[] = { 0, 0 };
+    fpga->ReadRegisters(readAddrs, readValues, 2);
+    bool hasGPSPPS = readValues[0] != LMS_DEV_LIMESDR_XTRX;
     if (hasGPSPPS)
     {
         constexpr uint16_t waitGPS_PPS = 1 << 2;
-        int interface_ctrl_000A = fpga->ReadRegister(0x000A);
+        uint16_t interface_ctrl_000A = readValues[1];
         interface_ctrl_000A &= ~waitGPS_PPS; // disable by default
         if (cfg.extraConfig.waitPPS)
         {
             interface_ctrl_000A |= waitGPS_PPS;
         }
-        fpga->WriteRegister(0x000A, interface_ctrl_000A);
+        batch.WriteRegister(0x000A, interface_ctrl_000A);
     }
+    // the stream is stopped, so the wait for PPS can be configured before the timestamp reset
+    batch.Flush();
+    fpga->ResetTimestamp();
 
     // Don't just use REALTIME scheduling, or at least be cautious with it.
     // if the thread blocks for too long, Linux can trigger RT throttling
@@ -206,6 +244,14 @@ void TRXLooper::Start()
 {
     mRx.fifo->clear();
     mTx.fifo->clear();
+    mTxBurstEnd.store(txBurstActive, std::memory_order_relaxed);
+    mRxSeekTimestamp.store(0, std::memory_order_relaxed);
+    if (mRxCorrector)
+        mRxCorrector->Reset();
+    if (mRxDecimator)
+        mRxDecimator->Reset();
+    mStatsReporter.SetStatusCallback(mConfig.statusCallback, mConfig.userData);
+    mStatsReporter.Start(mCallback_logMessage);
 
     fpga->StartStreaming();
 
@@ -243,6 +289,7 @@ void TRXLooper::Stop()
     {
         lime::error("Failed to join TRXLooper threads"s);
     }
+    mStatsReporter.Stop();
     fpga->StopStreaming();
 
     RxTeardown();
@@ -254,11 +301,74 @@ void TRXLooper::Stop()
     mStreamEnabled = false;
 }
 
+/// @brief Gets the amount of channels the Rx packets hold after the decimation stage.
+/// @return The amount of channels delivered by StreamRx().
+uint8_t TRXLooper::GetRxOutputChannelCount() const
+{
+    const auto& decimation = mConfig.extraConfig.rxDecimation;
+    if (decimation.ratio > 1 && decimation.channelize)
+        return decimation.subChannels.size();
+    return mConfig.channels.at(TRXDir::Rx).size();
+}
+
+/// @brief Runs the optional DC and IQ correction stage on a received packet, before the decimation.
+/// @param packet The packet holding all of the samples of a single transfer.
+void TRXLooper::CorrectRx(SamplesPacketType* packet)
+{
+    if (mRxCorrector == nullptr || packet == nullptr)
+        return;
+
+    if (mConfig.format == SDRDevice::StreamConfig::DataFormat::F32)
+        mRxCorrector->Process(reinterpret_cast<complex32f_t* const*>(packet->front()), packet->size());
+    else
+        mRxCorrector->Process(reinterpret_cast<complex16_t* const*>(packet->front()), packet->size());
+}
+
+/// @brief Runs the optional decimation stage on a received packet, before it is passed to the FIFO.
+/// @param packet The packet holding all of the samples of a single transfer.
+void TRXLooper::DecimateRx(SamplesPacketType* packet)
+{
+    if (mRxDecimator == nullptr || packet == nullptr)
+        return;
+
+    uint64_t timestamp = 0;
+    uint32_t produced = 0;
+    if (mConfig.format == SDRDevice::StreamConfig::DataFormat::F32)
+    {
+        complex32f_t* const* samples = reinterpret_cast<complex32f_t* const*>(packet->front());
+        produced = mRxDecimator->Process(samples, packet->size(), packet->timestamp, &timestamp);
+    }
+    else
+    {
+        complex16_t* const* samples = reinterpret_cast<complex16_t* const*>(packet->front());
+        produced = mRxDecimator->Process(samples, packet->size(), packet->timestamp, &timestamp);
+    }
+    packet->SetSize(produced);
+    packet->timestamp = timestamp;
+}
+
+/// @brief Gets whether a received packet ends before the timestamp StreamRx() is seeking to.
+/// @param timestamp The timestamp of the first sample of the packet.
+/// @param count The amount of samples in the packet.
+/// @return True if the packet can be dropped without converting it.
+bool TRXLooper::IsBeforeRxSeek(uint64_t timestamp, uint32_t count) const
+{
+    return timestamp + count <= mRxSeekTimestamp.load(std::memory_order_relaxed);
+}
+
 template<class T> uint32_t TRXLooper::StreamRxTemplate(T* const* dest, uint32_t count, SDRDevice::StreamMeta* meta)
 {
     bool timestampSet = false;
     uint32_t samplesProduced = 0;
-    const bool useChannelB = mConfig.channels.at(TRXDir::Rx).size() > 1;
+    const uint8_t channelCount = GetRxOutputChannelCount();
+
+    // the decimated packets count the output samples, the metadata holds the hardware timestamps
+    const uint32_t timestampRatio = mRxDecimator ? mRxDecimator->GetRatio() : 1;
+    bool seeking = meta && meta->waitForTimestamp;
+    const uint64_t seekTimestamp = seeking ? (meta->timestamp + timestampRatio - 1) / timestampRatio : 0;
+    // the decimator needs the samples preceding the target, so they have to reach it
+    if (seeking && mRxDecimator == nullptr)
+        mRxSeekTimestamp.store(seekTimestamp, std::memory_order_relaxed);
 
     bool firstIteration = true;
 
@@ -268,9 +378,23 @@ template<class T> uint32_t TRXLooper::StreamRxTemplate(T* const* dest, uint32_t
         if (!mRx.stagingPacket && !mRx.fifo->pop(&mRx.stagingPacket, firstIteration, 2000))
             return samplesProduced;
 
+        if (seeking)
+        {
+            if (mRx.stagingPacket->timestamp + mRx.stagingPacket->size() <= seekTimestamp)
+            {
+                mRx.memPool->Free(mRx.stagingPacket);
+                mRx.stagingPacket = nullptr;
+                continue;
+            }
+            if (mRx.stagingPacket->timestamp < seekTimestamp)
+                mRx.stagingPacket->pop(seekTimestamp - mRx.stagingPacket->timestamp);
+            mRxSeekTimestamp.store(0, std::memory_order_relaxed);
+            seeking = false;
+        }
+
         if (!timestampSet && meta)
         {
-            meta->timestamp = mRx.stagingPacket->timestamp;
+            meta->timestamp = mRx.stagingPacket->timestamp * timestampRatio;
             timestampSet = true;
         }
 
@@ -278,13 +402,8 @@ template<class T> uint32_t TRXLooper::StreamRxTemplate(T* const* dest, uint32_t
         const uint32_t samplesToCopy = std::min(expectedCount, mRx.stagingPacket->size());
 
         T* const* src = reinterpret_cast<T* const*>(mRx.stagingPacket->front());
-
-        std::memcpy(&dest[0][samplesProduced], src[0], samplesToCopy * sizeof(T));
-
-        if (useChannelB)
-        {
-            std::memcpy(&dest[1][samplesProduced], src[1], samplesToCopy * sizeof(T));
-        }
+        for (uint8_t ch = 0; ch < channelCount; ++ch)
+            std::memcpy(&dest[ch][samplesProduced], src[ch], samplesToCopy * sizeof(T));
 
         mRx.stagingPacket->pop(samplesToCopy);
         samplesProduced += samplesToCopy;
@@ -327,16 +446,17 @@ uint32_t TRXLooper::StreamRx(lime::complex12_t* const* samples, uint32_t count,
 
 template<class T> uint32_t TRXLooper::StreamTxTemplate(const T* const* samples, uint32_t count, const SDRDevice::StreamMeta* meta)
 {
-    const bool useChannelB = mConfig.channels.at(lime::TRXDir::Tx).size() > 1;
+    const uint8_t channelCount = mConfig.channels.at(lime::TRXDir::Tx).size();
     const bool useTimestamp = meta ? meta->waitForTimestamp : false;
-    const bool flush = meta && meta->flushPartialPacket;
+    const bool endOfBurst = meta && meta->endOfBurst;
+    const bool flush = meta && (meta->flushPartialPacket || endOfBurst);
     int64_t ts = meta ? meta->timestamp : 0;
 
     uint32_t samplesRemaining = count;
 
     const int samplesInPkt = mTx.samplesInPkt;
     const int packetsToBatch = mTx.packetsToBatch;
-    const int32_t outputPktSize = SamplesPacketType::headerSize + packetsToBatch * samplesInPkt * sizeof(T);
+    const int32_t outputPktSize = SamplesPacketType::headerSize + packetsToBatch * samplesInPkt * sizeof(T) * channelCount;
 
     if (mTx.stagingPacket && mTx.stagingPacket->timestamp + mTx.stagingPacket->size() != meta->timestamp)
     {
@@ -346,7 +466,9 @@ template<class T> uint32_t TRXLooper::StreamTxTemplate(const T* const* samples,
         mTx.stagingPacket = nullptr;
     }
 
-    const T* src[2] = { samples[0], useChannelB ? samples[1] : nullptr };
+    const T* src[maxChannelCount] = {};
+    for (uint8_t ch = 0; ch < channelCount; ++ch)
+        src[ch] = samples[ch];
     while (samplesRemaining > 0)
     {
         if (!mTx.stagingPacket)
@@ -360,12 +482,13 @@ template<class T> uint32_t TRXLooper::StreamTxTemplate(const T* const* samples,
             mTx.stagingPacket->Reset();
             mTx.stagingPacket->timestamp = ts;
             mTx.stagingPacket->useTimestamp = useTimestamp;
+            mTx.stagingPacket->flush = false;
+            mTx.stagingPacket->endOfBurst = false;
         }
 
         int consumed = mTx.stagingPacket->push(src, samplesRemaining);
-        src[0] += consumed;
-        if (useChannelB)
-            src[1] += consumed;
+        for (uint8_t ch = 0; ch < channelCount; ++ch)
+            src[ch] += consumed;
 
         samplesRemaining -= consumed;
         ts += consumed;
@@ -373,7 +496,10 @@ template<class T> uint32_t TRXLooper::StreamTxTemplate(const T* const* samples,
         if (mTx.stagingPacket->isFull() || flush)
         {
             if (samplesRemaining == 0)
+            {
                 mTx.stagingPacket->flush = flush;
+                mTx.stagingPacket->endOfBurst = endOfBurst;
+            }
 
             if (!mTx.fifo->push(mTx.stagingPacket))
                 break;
@@ -417,11 +543,13 @@ SDRDevice::StreamStats TRXLooper::GetStats(TRXDir dir) const
     if (dir == TRXDir::Tx)
     {
         stats = mTx.stats;
+        stats.dataRate_Bps = mStatsReporter.GetDataRate(TRXDir::Tx);
         stats.FIFO = { mTx.fifo->max_size(), mTx.fifo->size() };
     }
     else
     {
         stats = mRx.stats;
+        stats.dataRate_Bps = mStatsReporter.GetDataRate(TRXDir::Rx);
         stats.FIFO = { mRx.fifo->max_size(), mRx.fifo->size() };
     }
 
@@ -9,10 +9,13 @@
 #include "PacketsFIFO.h"
 #include "MemoryPool.h"
 #include "SamplesPacket.h"
+#include "StreamStatsReporter.h"
 
 namespace lime {
 class FPGA;
 class LMS7002M;
+class RxCorrector;
+class RxDecimator;
 
 /** @brief Class responsible for receiving and transmitting continuous sample data */
 class TRXLooper
@@ -48,14 +51,22 @@ class TRXLooper
 
     SDRDevice::StreamStats GetStats(TRXDir tx) const;
 
+    /// @brief The most channels a single stream can carry.
+    static constexpr uint8_t maxChannelCount = 8;
+
     /// @brief The type of a sample packet.
-    typedef SamplesPacket<2> SamplesPacketType;
+    typedef SamplesPacket<maxChannelCount> SamplesPacketType;
 
   protected:
     virtual int RxSetup() { return 0; };
     virtual void ReceivePacketsLoop() = 0;
     virtual void RxTeardown(){};
 
+    uint8_t GetRxOutputChannelCount() const;
+    void CorrectRx(SamplesPacketType* packet);
+    void DecimateRx(SamplesPacketType* packet);
+    bool IsBeforeRxSeek(uint64_t timestamp, uint32_t count) const;
+
     virtual int TxSetup() { return 0; };
     virtual void TransmitPacketsLoop() = 0;
     virtual void TxTeardown(){};
@@ -66,6 +77,8 @@ class TRXLooper
     FPGA* fpga;
     LMS7002M* lms;
     int chipId;
+    /// The amount of channels the FPGA streams through this looper, FPGA images aggregating several chips provide more.
+    uint8_t mChannelCount;
 
     std::chrono::time_point<std::chrono::steady_clock> streamClockStart;
 
@@ -125,6 +138,23 @@ class TRXLooper
     Stream mRx;
     Stream mTx;
 
+    /// The timestamp following the end of the Tx burst handed to the hardware, or one of the states below.
+    /// The receive thread marks the stream idle once the Rx timestamp passes the end, until the next timestamped burst begins.
+    std::atomic<int64_t> mTxBurstEnd;
+    static constexpr int64_t txBurstActive = -1;
+    static constexpr int64_t txBurstIdle = -2;
+
+    /// The timestamp StreamRx() is seeking to, the receive thread drops the packets before it without converting them (0 for none).
+    std::atomic<uint64_t> mRxSeekTimestamp;
+
+    /// The optional host-side DC and IQ correction stage of the received samples.
+    RxCorrector* mRxCorrector;
+    /// The optional host-side decimation stage of the received samples.
+    RxDecimator* mRxDecimator;
+
+    /// Formats and logs the counters published by the streaming threads.
+    StreamStatsReporter mStatsReporter;
+
   private:
     template<class T> uint32_t StreamRxTemplate(T* const* dest, uint32_t count, SDRDevice::StreamMeta* meta);
     template<class T> uint32_t StreamTxTemplate(const T* const* samples, uint32_t count, const SDRDevice::StreamMeta* meta);
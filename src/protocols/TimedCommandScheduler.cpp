@@ -0,0 +1,134 @@
+#include "TimedCommandScheduler.h"
+
+#include "Logger.h"
+#include "threadHelper.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace lime;
+using namespace std::chrono;
+
+static constexpr microseconds minPollPeriod(20);
+static constexpr microseconds maxPollPeriod(1000);
+static constexpr microseconds defaultPollPeriod(100);
+
+/// @brief Constructs the scheduler and starts its thread.
+/// @param timestampSource The function returning the current sample timestamp.
+/// @param executor The function performing the commands.
+/// @param sampleRate The rate at which the timestamp advances (in Hz), used to sleep between checks.
+/// @param initialLatency The control latency to assume until it is measured (in samples).
+TimedCommandScheduler::TimedCommandScheduler(
+    TimestampSource timestampSource, Executor executor, double sampleRate, uint64_t initialLatency)
+    : mTimestampSource(timestampSource)
+    , mExecutor(executor)
+    , mSampleRate(sampleRate)
+    , mLatency(initialLatency)
+    , mTerminate(false)
+{
+    mThread = std::thread(&TimedCommandScheduler::SchedulerLoop, this);
+    SetOSThreadPriority(ThreadPriority::HIGH, ThreadPolicy::DEFAULT, &mThread);
+#ifdef __linux__
+    pthread_setname_np(mThread.native_handle(), "lime:TimedCmd");
+#endif
+}
+
+/// @brief Stops the scheduler, the pending commands are aborted.
+TimedCommandScheduler::~TimedCommandScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mQueueLock);
+        mTerminate = true;
+    }
+    mQueueCv.notify_all();
+    mThread.join();
+    CancelAll();
+}
+
+/// @brief Queues the command for execution.
+/// @param command The command to execute.
+/// @return The status of the operation.
+OpStatus TimedCommandScheduler::Schedule(const SDRDevice::TimedCommand& command)
+{
+    {
+        std::lock_guard<std::mutex> lock(mQueueLock);
+        if (mTerminate)
+            return ReportError(OpStatus::ABORTED, "Timed command scheduler is stopped");
+        // commands with equal timestamps keep their submission order
+        mQueue.emplace(command.timestamp, command);
+    }
+    mQueueCv.notify_all();
+    return OpStatus::SUCCESS;
+}
+
+/// @brief Removes all of the pending commands, their callbacks receive OpStatus::ABORTED.
+void TimedCommandScheduler::CancelAll()
+{
+    std::multimap<uint64_t, SDRDevice::TimedCommand> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mQueueLock);
+        cancelled.swap(mQueue);
+    }
+    for (const auto& entry : cancelled)
+        Complete(entry.second, 0, OpStatus::ABORTED);
+}
+
+/// @brief Gets the amount of commands waiting for their timestamp.
+/// @return The amount of pending commands.
+std::size_t TimedCommandScheduler::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(mQueueLock);
+    return mQueue.size();
+}
+
+void TimedCommandScheduler::Complete(const SDRDevice::TimedCommand& command, uint64_t executedTimestamp, OpStatus status)
+{
+    if (command.callback == nullptr)
+        return;
+    SDRDevice::TimedCommandResult result{ command.timestamp, executedTimestamp, status };
+    command.callback(result, command.userData);
+}
+
+void TimedCommandScheduler::SchedulerLoop()
+{
+    std::unique_lock<std::mutex> lock(mQueueLock);
+    while (!mTerminate)
+    {
+        if (mQueue.empty())
+        {
+            mQueueCv.wait(lock, [this]() { return mTerminate || !mQueue.empty(); });
+            continue;
+        }
+
+        const uint64_t latency = mLatency.load(std::memory_order_relaxed);
+        const uint64_t target = mQueue.begin()->first;
+        const uint64_t now = mTimestampSource();
+        if (now + latency < target)
+        {
+            microseconds pollPeriod = defaultPollPeriod;
+            if (mSampleRate > 0)
+            {
+                const double remaining = (target - latency - now) / mSampleRate;
+                pollPeriod = std::clamp(duration_cast<microseconds>(duration<double>(remaining)), minPollPeriod, maxPollPeriod);
+            }
+            // new, possibly earlier, commands wake the thread up
+            mQueueCv.wait_for(lock, pollPeriod);
+            continue;
+        }
+
+        SDRDevice::TimedCommand command = std::move(mQueue.begin()->second);
+        mQueue.erase(mQueue.begin());
+        lock.unlock();
+
+        const OpStatus status = mExecutor(command);
+        const uint64_t executed = mTimestampSource();
+        if (status == OpStatus::SUCCESS && executed >= now)
+        {
+            // running average, so a single slow transfer does not skew the following commands
+            mLatency.store((latency * 3 + (executed - now)) / 4, std::memory_order_relaxed);
+        }
+        Complete(command, executed, status);
+
+        lock.lock();
+    }
+}
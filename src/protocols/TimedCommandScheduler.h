@@ -0,0 +1,59 @@
+#ifndef LIME_TIMEDCOMMANDSCHEDULER_H
+#define LIME_TIMEDCOMMANDSCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "limesuite/SDRDevice.h"
+
+namespace lime {
+
+/** @brief Executes commands when a sample timestamp source reaches their target timestamps.
+
+  The commands are fired ahead of their target by the control latency, which is measured
+  from the timestamps before and after each execution and averaged over time.
+ */
+class TimedCommandScheduler
+{
+  public:
+    /// @brief The function returning the current sample timestamp.
+    typedef std::function<uint64_t()> TimestampSource;
+    /// @brief The function performing the command.
+    typedef std::function<OpStatus(const SDRDevice::TimedCommand&)> Executor;
+
+    TimedCommandScheduler(TimestampSource timestampSource, Executor executor, double sampleRate, uint64_t initialLatency = 0);
+    ~TimedCommandScheduler();
+
+    OpStatus Schedule(const SDRDevice::TimedCommand& command);
+    void CancelAll();
+
+    /// @brief Gets the currently estimated control latency.
+    /// @return The control latency in samples.
+    uint64_t GetControlLatency() const { return mLatency.load(std::memory_order_relaxed); }
+
+    std::size_t GetPendingCount();
+
+  private:
+    void SchedulerLoop();
+    static void Complete(const SDRDevice::TimedCommand& command, uint64_t executedTimestamp, OpStatus status);
+
+    TimestampSource mTimestampSource;
+    Executor mExecutor;
+    double mSampleRate;
+    std::atomic<uint64_t> mLatency;
+
+    std::multimap<uint64_t, SDRDevice::TimedCommand> mQueue;
+    std::mutex mQueueLock;
+    std::condition_variable mQueueCv;
+    std::thread mThread;
+    bool mTerminate;
+};
+
+} // namespace lime
+
+#endif // LIME_TIMEDCOMMANDSCHEDULER_H
@@ -0,0 +1,118 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "CDCM6208/CDCM6208_Dev.h"
+#include "tests/include/limesuite/CommsMock.h"
+
+#include <map>
+#include <vector>
+
+using namespace lime;
+using namespace lime::testing;
+using ::testing::_;
+using ::testing::Invoke;
+
+static constexpr uint16_t baseAddress = CDCM2_BASE_ADDR;
+
+/** @brief Emulates the CDCM registers behind the FPGA and records the written addresses. */
+class CDCM6208_DevTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ON_CALL(*spi, SPI(_, _, _)).WillByDefault(Invoke([this](const uint32_t* mosi, uint32_t* miso, uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (mosi[i] >> 31)
+                {
+                    const uint16_t address = (mosi[i] >> 16) & 0x7FFF;
+                    registers[address] = mosi[i] & 0xFFFF;
+                    written.push_back(address);
+                }
+                else if (miso)
+                {
+                    const uint16_t address = mosi[i] & 0xFFFF;
+                    if (address == baseAddress + 24) // registers ready to be read
+                        miso[i] = 2;
+                    else if (address == baseAddress + 22) // locked
+                        miso[i] = 0;
+                    else
+                        miso[i] = registers[address];
+                }
+            }
+            return OpStatus::SUCCESS;
+        }));
+
+        ASSERT_EQ(cdcm.Reset(30.72e6, 25e6), 0);
+        written.clear();
+    }
+
+    /// @brief Gets the configuration registers written since the last call, without the load and read requests.
+    std::vector<uint16_t> TakeWrittenConfiguration()
+    {
+        std::vector<uint16_t> configuration;
+        for (uint16_t address : written)
+            if (address <= baseAddress + 20)
+                configuration.push_back(address);
+        written.clear();
+        return configuration;
+    }
+
+    std::shared_ptr<CommsMock> spi = std::make_shared<::testing::NiceMock<CommsMock>>();
+    std::map<uint16_t, uint16_t> registers;
+    std::vector<uint16_t> written;
+    CDCM_Dev cdcm{ spi, baseAddress };
+};
+
+TEST_F(CDCM6208_DevTest, RequestedFrequenciesAreSet)
+{
+    EXPECT_EQ(cdcm.SetFrequency(CDCM_Y0Y1, 122.88e6, false), 0);
+    cdcm.SetFrequency(CDCM_Y4, 61.44e6, false);
+    cdcm.SetFrequency(CDCM_Y5, 61.44e6, true);
+
+    EXPECT_DOUBLE_EQ(cdcm.GetFrequency(CDCM_Y0Y1), 122.88e6);
+    EXPECT_DOUBLE_EQ(cdcm.GetFrequency(CDCM_Y4), 61.44e6);
+    EXPECT_DOUBLE_EQ(cdcm.GetFrequency(CDCM_Y5), 61.44e6);
+    EXPECT_TRUE(cdcm.IsLocked());
+}
+
+TEST_F(CDCM6208_DevTest, UploadWritesOnlyChangedRegisters)
+{
+    cdcm.SetFrequency(CDCM_Y0Y1, 122.88e6, false);
+    cdcm.SetFrequency(CDCM_Y4, 61.44e6, true);
+    EXPECT_FALSE(TakeWrittenConfiguration().empty());
+
+    // only the Y5 divider registers change
+    cdcm.SetFrequency(CDCM_Y5, 15.36e6, true);
+    EXPECT_FALSE(written.empty()); // the configuration is loaded to the chip
+    const std::vector<uint16_t> configuration = TakeWrittenConfiguration();
+    ASSERT_FALSE(configuration.empty());
+    for (uint16_t address : configuration)
+    {
+        EXPECT_GE(address, baseAddress + 12);
+        EXPECT_LE(address, baseAddress + 14);
+    }
+
+    // nothing changes, so nothing is written
+    written.clear();
+    cdcm.SetFrequency(CDCM_Y5, 15.36e6, true);
+    EXPECT_TRUE(written.empty());
+}
+
+TEST_F(CDCM6208_DevTest, ChangingFractionalOutputKeepsOtherDividers)
+{
+    cdcm.SetFrequency(CDCM_Y0Y1, 122.88e6, false);
+    cdcm.SetFrequency(CDCM_Y4, 61.44e6, false);
+    cdcm.SetFrequency(CDCM_Y5, 10e6, false);
+    const CDCM_Outputs before = cdcm.GetOutputs();
+    const CDCM_VCO vcoBefore = cdcm.GetVCO();
+
+    cdcm.SetFrequency(CDCM_Y6, 20e6, false);
+    const CDCM_Outputs after = cdcm.GetOutputs();
+    EXPECT_EQ(cdcm.GetVCO().output_freq, vcoBefore.output_freq);
+    EXPECT_EQ(after.Y4.integer_part, before.Y4.integer_part);
+    EXPECT_EQ(after.Y4.fractional_part, before.Y4.fractional_part);
+    EXPECT_EQ(after.Y5.integer_part, before.Y5.integer_part);
+    EXPECT_EQ(after.Y5.fractional_part, before.Y5.fractional_part);
+    EXPECT_DOUBLE_EQ(cdcm.GetFrequency(CDCM_Y6), 20e6);
+}
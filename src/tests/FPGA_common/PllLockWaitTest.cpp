@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "FPGA_common.h"
+#include "LMSBoards.h"
+#include "limesuite/IComms.h"
+
+#include <chrono>
+#include <memory>
+
+using namespace lime;
+using namespace std::chrono;
+
+namespace {
+
+/** @brief Emulates an FPGA whose PLL operations complete after a programmable latency. */
+class FPGA_PLLLatencyEmulator : public ISPI
+{
+  public:
+    explicit FPGA_PLLLatencyEmulator(microseconds lockLatency)
+        : lockLatency(lockLatency)
+    {
+    }
+
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (MOSI[i] & (1 << 31))
+            {
+                const uint16_t address = (MOSI[i] >> 16) & 0x7FFF;
+                if (address == 0x0023 && (MOSI[i] & 0x7)) // PLLCFG_START, PHCFG_START or PLLRST_START
+                {
+                    ++operations;
+                    operationStart = steady_clock::now();
+                }
+            }
+            else if (MISO)
+            {
+                switch (MOSI[i] & 0xFFFF)
+                {
+                case 0x0000:
+                    MISO[i] = LMS_DEV_LIMESDR_XTRX;
+                    break;
+                case 0x0021:
+                    MISO[i] = steady_clock::now() - operationStart >= lockLatency ? 0x5 : 0;
+                    ++statusReads;
+                    break;
+                default:
+                    MISO[i] = 0;
+                }
+            }
+        }
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+    const microseconds lockLatency;
+    steady_clock::time_point operationStart;
+    int operations = 0;
+    int statusReads = 0;
+};
+
+/** @brief Discards the LMS7002M register accesses. */
+class LMS7002M_Sink : public ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        if (MISO)
+            for (uint32_t i = 0; i < count; ++i)
+                MISO[i] = 0;
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+};
+
+} // namespace
+
+TEST(FPGA_PllLockWait, InterfaceIsConfiguredWhenPLLsLock)
+{
+    for (const microseconds lockLatency : { microseconds(0), microseconds(300), microseconds(2000) })
+    {
+        auto fpgaSPI = std::make_shared<FPGA_PLLLatencyEmulator>(lockLatency);
+        FPGA fpga(fpgaSPI, std::make_shared<LMS7002M_Sink>());
+
+        ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 90, 90, 0), OpStatus::SUCCESS);
+
+        EXPECT_GT(fpgaSPI->operations, 0);
+        EXPECT_GE(fpgaSPI->statusReads, fpgaSPI->operations);
+    }
+}
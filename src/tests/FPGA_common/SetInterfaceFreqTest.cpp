@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include "FPGA_common.h"
+#include "LMSBoards.h"
+#include "limesuite/IComms.h"
+
+#include <map>
+#include <memory>
+
+using namespace lime;
+
+namespace {
+
+/** @brief Emulates an FPGA that completes every PLL operation at once, counting the PLL configurations. */
+class FPGA_PLLEmulator : public ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (MOSI[i] & (1 << 31))
+            {
+                const uint16_t address = (MOSI[i] >> 16) & 0x7FFF;
+                const uint16_t value = MOSI[i] & 0xFFFF;
+                if (address == 0x0024) // CNT_PHASE
+                    phaseSteps = value;
+                else if (address == 0x0023 && (value & 0x2)) // PHCFG_START
+                {
+                    const bool phaseCheck = (value & (1 << 14)) && phaseSteps == 0; // PHCFG_MODE without steps
+                    if (phaseCheck)
+                        ++phaseChecks;
+                    else
+                        ++phaseConfigurations;
+                    phaseError = phaseCheck && patternErrors;
+                }
+            }
+            else if (MISO)
+            {
+                switch (MOSI[i] & 0xFFFF)
+                {
+                case 0x0000:
+                    MISO[i] = LMS_DEV_LIMESDR_XTRX;
+                    break;
+                case 0x0021: // all PLL operations are done
+                    MISO[i] = phaseError ? 0xD : 0x5;
+                    break;
+                default:
+                    MISO[i] = 0;
+                }
+            }
+        }
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+    int phaseConfigurations = 0;
+    int phaseChecks = 0;
+    bool patternErrors = false; ///< Whether the test pattern is received with errors at the current phase.
+
+  private:
+    uint16_t phaseSteps = 0;
+    bool phaseError = false;
+};
+
+/** @brief Emulates the LMS7002M registers. */
+class LMS7002M_RegisterEmulator : public ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (MOSI[i] & (1 << 31))
+                registers[(MOSI[i] >> 16) & 0x7FFF] = MOSI[i] & 0xFFFF;
+            else if (MISO)
+                MISO[i] = registers[MOSI[i] & 0xFFFF];
+        }
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+    std::map<uint16_t, uint16_t> registers;
+};
+
+} // namespace
+
+TEST(FPGA_SetInterfaceFreq, PhaseSearchIsSkippedForConfiguredInterface)
+{
+    auto fpgaSPI = std::make_shared<FPGA_PLLEmulator>();
+    auto lmsSPI = std::make_shared<LMS7002M_RegisterEmulator>();
+    FPGA fpga(fpgaSPI, lmsSPI);
+
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    const int searchConfigurations = fpgaSPI->phaseConfigurations;
+    EXPECT_GT(searchConfigurations, 0);
+    EXPECT_EQ(fpgaSPI->phaseChecks, 0);
+    const auto lmsRegisters = lmsSPI->registers;
+
+    // the found phases are only checked with the test pattern, once for each direction
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, searchConfigurations);
+    EXPECT_EQ(fpgaSPI->phaseChecks, 2);
+    EXPECT_EQ(lmsSPI->registers, lmsRegisters);
+
+    // another chip has not been searched yet
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 1), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, 2 * searchConfigurations);
+    EXPECT_EQ(fpgaSPI->phaseChecks, 2);
+
+    // the other chip's PLLs were reconfigured, this chip's phases are still valid
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, 2 * searchConfigurations);
+    EXPECT_EQ(fpgaSPI->phaseChecks, 4);
+}
+
+TEST(FPGA_SetInterfaceFreq, FailedPhaseCheckSearchesAgain)
+{
+    auto fpgaSPI = std::make_shared<FPGA_PLLEmulator>();
+    auto lmsSPI = std::make_shared<LMS7002M_RegisterEmulator>();
+    FPGA fpga(fpgaSPI, lmsSPI);
+
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    const int searchConfigurations = fpgaSPI->phaseConfigurations;
+
+    fpgaSPI->patternErrors = true;
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseChecks, 2);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, 2 * searchConfigurations);
+}
+
+TEST(FPGA_SetInterfaceFreq, ChangedInterfaceIsSearchedAgain)
+{
+    auto fpgaSPI = std::make_shared<FPGA_PLLEmulator>();
+    auto lmsSPI = std::make_shared<LMS7002M_RegisterEmulator>();
+    FPGA fpga(fpgaSPI, lmsSPI);
+
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    const int searchConfigurations = fpgaSPI->phaseConfigurations;
+
+    ASSERT_EQ(fpga.SetInterfaceFreq(61.44e6, 61.44e6, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, 2 * searchConfigurations);
+
+    // the PLLs were reconfigured for the other rate, so the phase has to be found again
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, 3 * searchConfigurations);
+
+    // the interface clock configuration changed
+    lmsSPI->registers[0x002A] = 0x000D;
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, 4 * searchConfigurations);
+    EXPECT_EQ(fpgaSPI->phaseChecks, 0);
+}
+
+TEST(FPGA_SetInterfaceFreq, ClockGeneratorChangeForgetsPhase)
+{
+    auto fpgaSPI = std::make_shared<FPGA_PLLEmulator>();
+    auto lmsSPI = std::make_shared<LMS7002M_RegisterEmulator>();
+    FPGA fpga(fpgaSPI, lmsSPI);
+
+    fpga.UpdateCGENConfigurationCount(0, 1);
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    const int searchConfigurations = fpgaSPI->phaseConfigurations;
+
+    // the same count means the clock generator was left alone
+    fpga.UpdateCGENConfigurationCount(0, 1);
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, searchConfigurations);
+
+    // retuned or reset since
+    fpga.UpdateCGENConfigurationCount(0, 2);
+    ASSERT_EQ(fpga.SetInterfaceFreq(30.72e6, 30.72e6, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(fpgaSPI->phaseConfigurations, 2 * searchConfigurations);
+    EXPECT_EQ(fpgaSPI->phaseChecks, 2);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include "FPGA_common.h"
+#include "WriteRegistersBatch.h"
+#include "limesuite/IComms.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+using namespace lime;
+
+namespace lime::testing {
+
+/** @brief Records the register writes sent to the FPGA, one entry per SPI transaction. */
+class FPGA_SPIRecorder : public ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::pair<uint16_t, uint16_t>> transaction;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (MOSI[i] & (1 << 31))
+                transaction.push_back({ (MOSI[i] >> 16) & 0x7FFF, MOSI[i] & 0xFFFF });
+            else if (MISO)
+                MISO[i] = 0;
+        }
+        transactions.push_back(transaction);
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+    std::mutex mutex;
+    std::vector<std::vector<std::pair<uint16_t, uint16_t>>> transactions;
+};
+
+} // namespace lime::testing
+
+using namespace lime::testing;
+using Writes = std::vector<std::pair<uint16_t, uint16_t>>;
+
+TEST(WriteRegistersBatch, DuplicateWritesAreCollapsed)
+{
+    auto spi = std::make_shared<FPGA_SPIRecorder>();
+    FPGA fpga(spi, nullptr);
+
+    WriteRegistersBatch batch(&fpga);
+    batch.WriteRegister(0x0023, 1);
+    batch.WriteRegister(0x0024, 2);
+    batch.WriteRegister(0x0023, 3);
+    EXPECT_EQ(batch.Flush(), OpStatus::SUCCESS);
+
+    ASSERT_EQ(spi->transactions.size(), 1U);
+    EXPECT_EQ(spi->transactions[0], (Writes{ { 0x0024, 2 }, { 0x0023, 3 } }));
+}
+
+TEST(WriteRegistersBatch, FenceKeepsIntermediateValues)
+{
+    auto spi = std::make_shared<FPGA_SPIRecorder>();
+    FPGA fpga(spi, nullptr);
+
+    WriteRegistersBatch batch(&fpga);
+    batch.WriteRegister(0x0009, 0);
+    batch.Fence();
+    batch.WriteRegister(0x0009, 3);
+    batch.Fence();
+    batch.WriteRegister(0x0009, 0);
+    batch.WriteRegister(0x0009, 0);
+    EXPECT_EQ(batch.Flush(), OpStatus::SUCCESS);
+
+    ASSERT_EQ(spi->transactions.size(), 1U);
+    EXPECT_EQ(spi->transactions[0], (Writes{ { 0x0009, 0 }, { 0x0009, 3 }, { 0x0009, 0 } }));
+}
+
+TEST(WriteRegistersBatch, CachedValuesAreSkipped)
+{
+    auto spi = std::make_shared<FPGA_SPIRecorder>();
+    FPGA fpga(spi, nullptr);
+    fpga.EnableValuesCache(true);
+
+    WriteRegistersBatch batch(&fpga);
+    batch.WriteRegister(0x0008, 0x0100);
+    batch.WriteRegister(0x0007, 0x0003);
+    EXPECT_EQ(batch.Flush(), OpStatus::SUCCESS);
+
+    batch.WriteRegister(0x0008, 0x0100);
+    batch.WriteRegister(0x0007, 0x0001);
+    EXPECT_EQ(batch.Flush(), OpStatus::SUCCESS);
+
+    batch.WriteRegister(0x0007, 0x0001);
+    EXPECT_EQ(batch.Flush(), OpStatus::SUCCESS);
+
+    ASSERT_EQ(spi->transactions.size(), 2U);
+    EXPECT_EQ(spi->transactions[1], (Writes{ { 0x0007, 0x0001 } }));
+}
+
+TEST(WriteRegistersBatch, WriteBehindFlushWaitsForAllWrites)
+{
+    auto spi = std::make_shared<FPGA_SPIRecorder>();
+    FPGA fpga(spi, nullptr);
+
+    WriteRegistersBatch batch(&fpga, true);
+    for (uint16_t i = 0; i < 100; ++i)
+        batch.WriteRegister(0x0040 + i % 10, i);
+    EXPECT_EQ(batch.Flush(), OpStatus::SUCCESS);
+
+    std::lock_guard<std::mutex> lock(spi->mutex);
+    std::map<uint16_t, uint16_t> finalValues;
+    std::size_t writeCount = 0;
+    for (const auto& transaction : spi->transactions)
+    {
+        writeCount += transaction.size();
+        for (const auto& write : transaction)
+            finalValues[write.first] = write.second;
+    }
+    EXPECT_LE(writeCount, 100U);
+    ASSERT_EQ(finalValues.size(), 10U);
+    for (uint16_t i = 0; i < 10; ++i)
+        EXPECT_EQ(finalValues[0x0040 + i], 90 + i);
+}
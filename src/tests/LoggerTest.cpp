@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lime;
+using namespace std::chrono;
+
+namespace {
+
+struct LoggedMessage {
+    LogLevel level;
+    std::string text;
+    std::thread::id thread;
+};
+
+std::mutex loggedMutex;
+std::vector<LoggedMessage> logged;
+std::atomic<int> handlerDelayMs(0);
+
+void RecordingHandler(const LogLevel level, const char* message)
+{
+    std::this_thread::sleep_for(milliseconds(handlerDelayMs.load()));
+    std::lock_guard<std::mutex> lock(loggedMutex);
+    logged.push_back({ level, message, std::this_thread::get_id() });
+}
+
+class AsyncLoggerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        logged.clear();
+        handlerDelayMs = 0;
+        registerLogHandler(&RecordingHandler);
+        enableAsyncLogging(true);
+    }
+
+    void TearDown() override
+    {
+        enableAsyncLogging(false);
+        setLogLevelSynchronous(LogLevel::ERROR, false);
+        registerLogHandler(nullptr);
+    }
+};
+
+} // namespace
+
+TEST_F(AsyncLoggerTest, MessagesAreDeliveredInOrderFromBackgroundThread)
+{
+    for (int i = 0; i < 100; ++i)
+        info("message %i", i);
+    flushLog();
+
+    std::lock_guard<std::mutex> lock(loggedMutex);
+    ASSERT_EQ(logged.size(), 100U);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(logged[i].text, "message " + std::to_string(i));
+        EXPECT_EQ(logged[i].level, LogLevel::INFO);
+        EXPECT_NE(logged[i].thread, std::this_thread::get_id());
+    }
+}
+
+TEST_F(AsyncLoggerTest, SlowHandlerDoesNotStallCallerAndDropsAreCounted)
+{
+    handlerDelayMs = 5;
+    const uint64_t droppedBefore = getDroppedLogCount();
+
+    const int messageCount = 2000;
+    auto start = steady_clock::now();
+    for (int i = 0; i < messageCount; ++i)
+        warning("streaming message %i", i);
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+
+    // delivering synchronously would take 10 s
+    EXPECT_LT(seconds, 0.5);
+    const uint64_t dropped = getDroppedLogCount() - droppedBefore;
+    EXPECT_GT(dropped, 0U);
+
+    handlerDelayMs = 0;
+    flushLog();
+    enableAsyncLogging(false);
+
+    std::lock_guard<std::mutex> lock(loggedMutex);
+    uint64_t delivered = 0;
+    uint64_t reportedDrops = 0;
+    for (const LoggedMessage& message : logged)
+    {
+        unsigned long long count = 0;
+        if (sscanf(message.text.c_str(), "%llu log messages dropped", &count) == 1)
+            reportedDrops += count;
+        else
+            ++delivered;
+    }
+    EXPECT_EQ(delivered, messageCount - dropped);
+    EXPECT_EQ(reportedDrops, dropped);
+}
+
+TEST_F(AsyncLoggerTest, SynchronousLevelsAreDeliveredBeforeReturning)
+{
+    setLogLevelSynchronous(LogLevel::ERROR, true);
+    error("synchronous error");
+    critical("synchronous critical");
+    {
+        std::lock_guard<std::mutex> lock(loggedMutex);
+        ASSERT_EQ(logged.size(), 2U);
+        EXPECT_EQ(logged[0].text, "synchronous error");
+        EXPECT_EQ(logged[0].thread, std::this_thread::get_id());
+        EXPECT_EQ(logged[1].level, LogLevel::CRITICAL);
+    }
+
+    setLogLevelSynchronous(LogLevel::ERROR, false);
+    error("queued error");
+    flushLog();
+    std::lock_guard<std::mutex> lock(loggedMutex);
+    ASSERT_EQ(logged.size(), 3U);
+    EXPECT_NE(logged[2].thread, std::this_thread::get_id());
+}
+
+TEST_F(AsyncLoggerTest, DisablingDeliversMessagesOfConcurrentProducers)
+{
+    const uint64_t droppedBefore = getDroppedLogCount();
+    const int threadCount = 4;
+    const int messageCount = 2000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        producers.emplace_back([]() {
+            for (int i = 0; i < messageCount; ++i)
+                info("concurrent message %i", i);
+        });
+    }
+    // the producers keep logging while the queue is being stopped, the later messages are delivered synchronously
+    std::this_thread::sleep_for(milliseconds(1));
+    enableAsyncLogging(false);
+    for (auto& producer : producers)
+        producer.join();
+
+    const uint64_t dropped = getDroppedLogCount() - droppedBefore;
+    std::lock_guard<std::mutex> lock(loggedMutex);
+    uint64_t delivered = 0;
+    for (const LoggedMessage& message : logged)
+    {
+        if (message.text.find("concurrent message") == 0)
+            ++delivered;
+    }
+    EXPECT_EQ(delivered, threadCount * messageCount - dropped);
+}
@@ -0,0 +1,120 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "Si5351C/Si5351C.h"
+#include "tests/include/limesuite/I2CMock.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace lime;
+using namespace lime::testing;
+using namespace std::chrono;
+using ::testing::_;
+using ::testing::Invoke;
+
+static constexpr std::size_t fullUploadBytes = 2 * (1 + 8 + 78 + 22 + 1 + 1);
+
+/** @brief Records the (register, value) pairs written to the clock generator. */
+class Si5351CTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ON_CALL(i2c, I2CWrite(_, _, _)).WillByDefault(Invoke([this](int address, const uint8_t* data, uint32_t length) {
+            writes.emplace_back(data, data + length);
+            return OpStatus::SUCCESS;
+        }));
+    }
+
+    void Configure(Si5351C& clockGenerator, unsigned long clk1Hz)
+    {
+        clockGenerator.SetPLL(0, 25000000, 0);
+        clockGenerator.SetPLL(1, 25000000, 0);
+        clockGenerator.SetClock(0, 27000000, true, false);
+        clockGenerator.SetClock(1, clk1Hz, true, false);
+        for (int i = 2; i < 8; ++i)
+            clockGenerator.SetClock(i, 27000000, false, false);
+        ASSERT_EQ(clockGenerator.ConfigureClocks(), Si5351C::Status::SUCCESS);
+    }
+
+    ::testing::NiceMock<I2CMock> i2c;
+    std::vector<std::vector<uint8_t>> writes;
+};
+
+TEST_F(Si5351CTest, FirstUploadWritesWholeConfiguration)
+{
+    Si5351C clockGenerator(i2c);
+    Configure(clockGenerator, 27000000);
+    ASSERT_EQ(clockGenerator.UploadConfiguration(), Si5351C::Status::SUCCESS);
+
+    ASSERT_EQ(writes.size(), 1U);
+    EXPECT_EQ(writes[0].size(), fullUploadBytes);
+}
+
+TEST_F(Si5351CTest, UploadWritesOnlyChangedRegisters)
+{
+    Si5351C clockGenerator(i2c);
+    Configure(clockGenerator, 27000000);
+    clockGenerator.UploadConfiguration();
+    writes.clear();
+
+    // the VCO is kept, only the CLK1 multisynth is reconfigured
+    Configure(clockGenerator, 13500000);
+    ASSERT_EQ(clockGenerator.UploadConfiguration(), Si5351C::Status::SUCCESS);
+    ASSERT_EQ(writes.size(), 1U);
+    const std::vector<uint8_t>& data = writes[0];
+    ASSERT_GE(data.size(), 6U);
+    EXPECT_LT(data.size(), fullUploadBytes / 4);
+    EXPECT_EQ(data[0], 3); // CLK1 disabled while it is reconfigured
+    EXPECT_EQ(data[1] & 0x3, 0x2);
+    EXPECT_EQ(data[data.size() - 2], 3);
+    EXPECT_EQ(data.back() & 0x3, 0);
+    for (std::size_t i = 2; i < data.size() - 2; i += 2)
+    {
+        EXPECT_NE(data[i], 0xB1); // no PLL reset
+        EXPECT_TRUE(data[i] == 17 || (data[i] >= 50 && data[i] <= 57)) << "register " << static_cast<int>(data[i]);
+    }
+
+    // nothing changes, so nothing is written
+    writes.clear();
+    Configure(clockGenerator, 13500000);
+    EXPECT_EQ(clockGenerator.UploadConfiguration(), Si5351C::Status::SUCCESS);
+    EXPECT_TRUE(writes.empty());
+}
+
+TEST_F(Si5351CTest, FailedUploadIsRepeatedInFull)
+{
+    Si5351C clockGenerator(i2c);
+    Configure(clockGenerator, 27000000);
+    EXPECT_CALL(i2c, I2CWrite(_, _, _)).WillOnce(::testing::Return(OpStatus::IO_FAILURE));
+    EXPECT_EQ(clockGenerator.UploadConfiguration(), Si5351C::Status::FAILED);
+
+    ::testing::Mock::VerifyAndClearExpectations(&i2c);
+    SetUp();
+    ASSERT_EQ(clockGenerator.UploadConfiguration(), Si5351C::Status::SUCCESS);
+    ASSERT_EQ(writes.size(), 1U);
+    EXPECT_EQ(writes[0].size(), fullUploadBytes);
+}
+
+TEST_F(Si5351CTest, CachedPlanMatchesSolvedPlan)
+{
+    Si5351C solved(i2c);
+    Configure(solved, 10000000);
+    solved.UploadConfiguration();
+
+    Si5351C cached(i2c);
+    auto start = steady_clock::now();
+    Configure(cached, 10000000);
+    const double firstSeconds = duration<double>(steady_clock::now() - start).count();
+    Configure(cached, 30720000);
+    start = steady_clock::now();
+    Configure(cached, 10000000);
+    const double cachedSeconds = duration<double>(steady_clock::now() - start).count();
+    cached.UploadConfiguration();
+
+    ASSERT_EQ(writes.size(), 2U);
+    EXPECT_EQ(writes[0], writes[1]);
+    std::cout << "Solved plan: " << firstSeconds * 1e6 << " us, cached plan: " << cachedSeconds * 1e6 << " us" << std::endl;
+}
@@ -0,0 +1,723 @@
+/**
+  @file StreamingBenchmarks.cpp
+  @brief Microbenchmarks of the host side streaming core and of the chip control paths.
+
+  Every case is run for at least the minimum time and its throughput is reported in items (samples or packets)
+  per second. The results can be written as CSV and compared against a CSV written by an earlier run,
+  in which case a throughput drop over the threshold fails the run.
+
+  Usage: StreamingBenchmarks [--filter text] [--min-time seconds] [--csv file] [--baseline file] [--threshold fraction]
+ */
+
+#include "BufferInterleaving.h"
+#include "CDCM6208/CDCM6208_Dev.h"
+#include "comms/PCIe/TxBufferManager.h"
+#include "FPGA_common.h"
+#include "LMSBoards.h"
+#include "limesuite/complex.h"
+#include "limesuite/IComms.h"
+#include "limesuite/LMS7002M.h"
+#include "MemoryPool.h"
+#include "PacketsFIFO.h"
+#include "RxCorrector.h"
+#include "RxDecimator.h"
+#include "TRXLooper.h"
+#include "SamplesPacket.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lime;
+using namespace std::chrono;
+
+extern std::vector<std::reference_wrapper<const LMS7Parameter>> LMS7parameterList;
+
+namespace {
+
+typedef TRXLooper::SamplesPacketType PacketType;
+typedef SDRDevice::StreamConfig::DataFormat DataFormat;
+
+/// @brief The amount of work done by a single run of a benchmark.
+struct Work {
+    uint64_t items;
+    uint64_t bytes;
+};
+
+/// @brief The throughput of a benchmark.
+struct Result {
+    double itemsPerSecond;
+    double bytesPerSecond;
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<Work()> run; ///< Runs a single batch of the benchmark.
+};
+
+const char* FormatName(DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::F32:
+        return "F32";
+    case DataFormat::I12:
+        return "I12";
+    case DataFormat::I16:
+        return "I16";
+    }
+    return "?";
+}
+
+std::size_t FormatSize(DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::F32:
+        return sizeof(complex32f_t);
+    case DataFormat::I12:
+        return sizeof(complex12_t);
+    case DataFormat::I16:
+        return sizeof(complex16_t);
+    }
+    return 0;
+}
+
+/// @brief Holds per channel sample buffers of a format.
+struct ChannelBuffers {
+    ChannelBuffers(DataFormat format, uint8_t channels, uint32_t count)
+    {
+        for (uint8_t ch = 0; ch < channels; ++ch)
+            memory.emplace_back(FormatSize(format) * count, 0x11);
+        for (auto& channel : memory)
+            pointers.push_back(channel.data());
+        pointers.resize(TRXLooper::maxChannelCount, nullptr);
+    }
+    std::vector<std::vector<uint8_t>> memory;
+    std::vector<void*> pointers;
+};
+
+Result Measure(const Benchmark& benchmark, double minSeconds)
+{
+    benchmark.run(); // warm up the caches and the allocations
+    Work total{ 0, 0 };
+    const auto start = steady_clock::now();
+    double elapsed = 0;
+    do
+    {
+        const Work work = benchmark.run();
+        total.items += work.items;
+        total.bytes += work.bytes;
+        elapsed = duration<double>(steady_clock::now() - start).count();
+    } while (elapsed < minSeconds);
+    return { total.items / elapsed, total.bytes / elapsed };
+}
+
+void AddFIFOBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    const uint32_t transfers = 1 << 14;
+    for (uint32_t capacity : { 16, 512 })
+    {
+        auto fifo = std::make_shared<PacketsFIFO<PacketType*>>(capacity);
+        benchmarks.push_back({ "PacketsFIFO/single/capacity:" + std::to_string(capacity), [fifo, transfers]() {
+                                  PacketType* pkt = nullptr;
+                                  for (uint32_t i = 0; i < transfers; ++i)
+                                  {
+                                      fifo->push(pkt);
+                                      fifo->pop(&pkt);
+                                  }
+                                  return Work{ transfers, 0 };
+                              } });
+        benchmarks.push_back({ "PacketsFIFO/paired/capacity:" + std::to_string(capacity), [fifo, transfers]() {
+                                  std::thread producer([&]() {
+                                      for (uint32_t i = 0; i < transfers; ++i)
+                                          fifo->push(nullptr, true);
+                                  });
+                                  PacketType* pkt = nullptr;
+                                  for (uint32_t i = 0; i < transfers; ++i)
+                                      fifo->pop(&pkt, true);
+                                  producer.join();
+                                  return Work{ transfers, 0 };
+                              } });
+    }
+}
+
+void AddMemoryPoolBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    const uint32_t allocations = 1 << 12;
+    for (int blockSize : { 4096, 65536 })
+    {
+        auto pool = std::make_shared<MemoryPool>(1024, blockSize, 4096, "Benchmark");
+        benchmarks.push_back({ "MemoryPool/single/block:" + std::to_string(blockSize), [pool, blockSize, allocations]() {
+                                  for (uint32_t i = 0; i < allocations; ++i)
+                                      pool->Free(pool->Allocate(blockSize));
+                                  return Work{ allocations, 0 };
+                              } });
+        // the streaming threads allocate the packets, the user's thread frees them
+        benchmarks.push_back({ "MemoryPool/paired/block:" + std::to_string(blockSize), [pool, blockSize, allocations]() {
+                                  PacketsFIFO<void*> fifo(256);
+                                  std::thread producer([&]() {
+                                      for (uint32_t i = 0; i < allocations; ++i)
+                                          fifo.push(pool->Allocate(blockSize), true);
+                                  });
+                                  void* ptr = nullptr;
+                                  for (uint32_t i = 0; i < allocations; ++i)
+                                  {
+                                      fifo.pop(&ptr, true);
+                                      pool->Free(ptr);
+                                  }
+                                  producer.join();
+                                  return Work{ allocations, 0 };
+                              } });
+    }
+}
+
+void AddSamplesPacketBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    for (uint8_t channels : { 1, 2, 4 })
+    {
+        for (uint16_t count : { 256, 1020, 4080 })
+        {
+            const uint32_t packetCapacity = 16384;
+            auto memory = std::make_shared<std::vector<uint8_t>>(
+                PacketType::headerSize + channels * packetCapacity * sizeof(complex32f_t));
+            auto source = std::make_shared<ChannelBuffers>(DataFormat::F32, channels, count);
+            const std::string name = "SamplesPacket::push/ch:" + std::to_string(channels) + "/count:" + std::to_string(count);
+            benchmarks.push_back({ name, [memory, source, channels, count, packetCapacity]() {
+                                      PacketType* pkt =
+                                          PacketType::ConstructSamplesPacket(memory->data(), packetCapacity, sizeof(complex32f_t));
+                                      const complex32f_t* const* src =
+                                          reinterpret_cast<const complex32f_t* const*>(source->pointers.data());
+                                      uint64_t pushed = 0;
+                                      while (!pkt->isFull())
+                                          pushed += pkt->push(src, count);
+                                      return Work{ pushed, pushed * channels * sizeof(complex32f_t) };
+                                  } });
+        }
+    }
+}
+
+void AddConversionBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    const DataFormat hostFormats[] = { DataFormat::F32, DataFormat::I16 };
+    const DataFormat linkFormats[] = { DataFormat::I16, DataFormat::I12 };
+    for (DataFormat host : hostFormats)
+    {
+        for (DataFormat link : linkFormats)
+        {
+            for (uint8_t channels : { 1, 2, 4 })
+            {
+                for (uint32_t count : { 256, 1020 })
+                {
+                    DataConversion toLink{ host, link, channels };
+                    DataConversion toHost{ link, host, channels };
+                    auto samples = std::make_shared<ChannelBuffers>(host, channels, count);
+                    auto linkBuffer = std::make_shared<std::vector<uint8_t>>(FormatSize(DataFormat::I16) * channels * count);
+                    const std::string parameters = std::string("/") + FormatName(host) + "<>" + FormatName(link) +
+                                                   "/ch:" + std::to_string(channels) + "/count:" + std::to_string(count);
+                    const uint64_t hostBytes = count * channels * FormatSize(host);
+
+                    benchmarks.push_back({ "Interleave" + parameters, [samples, linkBuffer, toLink, count, hostBytes]() {
+                                              Interleave(linkBuffer->data(), samples->pointers.data(), count, toLink);
+                                              return Work{ count, hostBytes };
+                                          } });
+                    const uint32_t linkBytes = count * channels * (link == DataFormat::I12 ? 3 : 4);
+                    benchmarks.push_back({ "Deinterleave" + parameters, [=]() {
+                                              Deinterleave(samples->pointers.data(), linkBuffer->data(), linkBytes, toHost);
+                                              return Work{ count, hostBytes };
+                                          } });
+                }
+            }
+        }
+    }
+}
+
+void AddTxBufferManagerBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    const uint32_t dmaBufferSize = 65536;
+    const uint32_t samplesCount = 1 << 14;
+    for (DataFormat link : { DataFormat::I16, DataFormat::I12 })
+    {
+        for (uint8_t channels : { 1, 2, 4 })
+        {
+            for (uint32_t samplesInPacket : { 256, 1020 })
+            {
+                auto output = std::make_shared<TxBufferManager<PacketType>>(
+                    channels, link == DataFormat::I12, samplesInPacket, 16, DataFormat::F32);
+                auto dmaMemory = std::make_shared<std::vector<uint8_t>>(dmaBufferSize);
+                auto packetMemory = std::make_shared<std::vector<uint8_t>>(
+                    PacketType::headerSize + channels * samplesCount * sizeof(complex32f_t));
+                auto source = std::make_shared<ChannelBuffers>(DataFormat::F32, channels, samplesCount);
+                const std::string name = std::string("TxBufferManager/F32>") + FormatName(link) + "/ch:" +
+                                         std::to_string(channels) + "/pkt:" + std::to_string(samplesInPacket);
+                benchmarks.push_back({ name, [=]() {
+                                          PacketType* pkt = PacketType::ConstructSamplesPacket(
+                                              packetMemory->data(), samplesCount, sizeof(complex32f_t));
+                                          pkt->timestamp = 0;
+                                          pkt->useTimestamp = true;
+                                          pkt->flush = false;
+                                          pkt->endOfBurst = false;
+                                          pkt->SetSize(samplesCount);
+                                          output->Reset(dmaMemory->data(), dmaMemory->size());
+                                          while (!pkt->empty())
+                                          {
+                                              if (output->consume(pkt))
+                                                  output->Reset(dmaMemory->data(), dmaMemory->size());
+                                          }
+                                          return Work{ samplesCount, samplesCount * channels * sizeof(complex32f_t) };
+                                      } });
+            }
+        }
+    }
+}
+
+void AddRxCorrectorBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    const uint32_t count = 4080;
+    for (DataFormat format : { DataFormat::F32, DataFormat::I16 })
+    {
+        for (uint8_t channels : { 1, 2 })
+        {
+            RxCorrector::Config config;
+            config.dcOffset = true;
+            config.iqImbalance = true;
+            config.averagingLength = 16384;
+            auto corrector = std::make_shared<RxCorrector>(config, channels);
+            // the statistics need varying samples, so the buffers are filled with noise
+            auto samples = std::make_shared<ChannelBuffers>(format, channels, count);
+            uint32_t seed = 1234;
+            for (auto& channel : samples->memory)
+            {
+                for (std::size_t n = 0; n < count; ++n)
+                {
+                    seed = seed * 1664525 + 1013904223;
+                    const int16_t i = static_cast<int16_t>(seed >> 20) - 2048;
+                    const int16_t q = static_cast<int16_t>((seed >> 8) & 0xFFF) - 2048;
+                    if (format == DataFormat::F32)
+                        reinterpret_cast<complex32f_t*>(channel.data())[n] = complex32f_t(i / 2048.0f, q / 2048.0f);
+                    else
+                        reinterpret_cast<complex16_t*>(channel.data())[n] = complex16_t(i, q);
+                }
+            }
+
+            const std::string name = std::string("RxCorrector/") + FormatName(format) + "/ch:" + std::to_string(channels) +
+                                     "/count:" + std::to_string(count);
+            const uint64_t bytes = count * channels * FormatSize(format);
+            benchmarks.push_back({ name, [corrector, samples, format, count, bytes]() {
+                                      void* const* pointers = samples->pointers.data();
+                                      if (format == DataFormat::F32)
+                                          corrector->Process(reinterpret_cast<complex32f_t* const*>(pointers), count);
+                                      else
+                                          corrector->Process(reinterpret_cast<complex16_t* const*>(pointers), count);
+                                      return Work{ count, bytes };
+                                  } });
+        }
+    }
+}
+
+void AddRxDecimatorBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    const uint32_t count = 8192;
+    auto tone = std::make_shared<std::vector<complex32f_t>>(count);
+    for (uint32_t n = 0; n < count; ++n)
+        (*tone)[n] = complex32f_t(std::cos(2 * M_PI * 0.01 * n), std::sin(2 * M_PI * 0.01 * n));
+
+    std::vector<std::pair<std::string, RxDecimator::Config>> configs;
+    for (uint8_t ratio : { 2, 4, 8 })
+    {
+        RxDecimator::Config config;
+        config.ratio = ratio;
+        configs.push_back({ "RxDecimator/decimate:" + std::to_string(ratio), config });
+    }
+    RxDecimator::Config channelizer;
+    channelizer.ratio = 8;
+    channelizer.channelize = true;
+    channelizer.subChannels = { 1, 6 };
+    configs.push_back({ "RxDecimator/channelize:8/sub:2", channelizer });
+
+    for (const auto& config : configs)
+    {
+        auto decimator = std::make_shared<RxDecimator>(config.second, 1);
+        auto input = std::make_shared<std::vector<complex32f_t>>(count);
+        auto second = std::make_shared<std::vector<complex32f_t>>(count);
+        auto timestamp = std::make_shared<uint64_t>(0);
+        benchmarks.push_back({ config.first, [=]() {
+                                  *input = *tone; // the samples are decimated in place
+                                  complex32f_t* samples[2] = { input->data(), second->data() };
+                                  decimator->Process(samples, count, *timestamp, nullptr);
+                                  *timestamp += count;
+                                  return Work{ count, count * sizeof(complex32f_t) };
+                              } });
+    }
+}
+
+/** @brief Emulates the CDCM registers behind the FPGA, always ready and locked. */
+class CDCM_Emulator : public ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (MOSI[i] >> 31)
+                registers[(MOSI[i] >> 16) & 0x7FFF] = MOSI[i] & 0xFFFF;
+            else if (MISO)
+            {
+                const uint16_t address = MOSI[i] & 0xFFFF;
+                if (address == CDCM2_BASE_ADDR + 24) // registers ready to be read
+                    MISO[i] = 2;
+                else if (address == CDCM2_BASE_ADDR + 22) // locked
+                    MISO[i] = 0;
+                else
+                    MISO[i] = registers[address];
+            }
+        }
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+  private:
+    std::map<uint16_t, uint16_t> registers;
+};
+
+void AddCDCMPlanningBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    static const double rates[] = { 30.72e6, 61.44e6, 122.88e6, 10e6 };
+    const uint64_t settings = 3 * sizeof(rates) / sizeof(rates[0]);
+    auto plan = [](CDCM_Dev& cdcm) {
+        for (double rate : rates)
+        {
+            cdcm.SetFrequency(CDCM_Y0Y1, 2 * rate, false);
+            cdcm.SetFrequency(CDCM_Y4, rate, false);
+            cdcm.SetFrequency(CDCM_Y5, rate, false);
+        }
+    };
+
+    // a new device has no solved plans, its reset is included
+    benchmarks.push_back({ "CDCM_Dev::SetFrequency/first", [plan, settings]() {
+                              CDCM_Dev cdcm(std::make_shared<CDCM_Emulator>(), CDCM2_BASE_ADDR);
+                              cdcm.Reset(30.72e6, 25e6);
+                              plan(cdcm);
+                              return Work{ settings, 0 };
+                          } });
+
+    auto cdcm = std::make_shared<CDCM_Dev>(std::make_shared<CDCM_Emulator>(), CDCM2_BASE_ADDR);
+    cdcm->Reset(30.72e6, 25e6);
+    benchmarks.push_back({ "CDCM_Dev::SetFrequency/repeated", [plan, settings, cdcm]() {
+                              plan(*cdcm);
+                              return Work{ settings, 0 };
+                          } });
+}
+
+volatile std::size_t lookupChecksum; ///< Keeps the lookups from being optimized away.
+
+void AddParameterLookupBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    auto names = std::make_shared<std::vector<std::string>>();
+    for (const LMS7Parameter& parameter : LMS7parameterList)
+        names->push_back(parameter.name);
+    const uint64_t lookups = names->size();
+
+    // the lookup that was used before the parameters were indexed
+    benchmarks.push_back({ "LMS7002M::GetParam/linear", [names, lookups]() {
+                              std::size_t found = 0;
+                              for (const std::string& name : *names)
+                              {
+                                  for (const LMS7Parameter& parameter : LMS7parameterList)
+                                  {
+                                      if (name == parameter.name)
+                                      {
+                                          found += parameter.address;
+                                          break;
+                                      }
+                                  }
+                              }
+                              lookupChecksum = found;
+                              return Work{ lookups, 0 };
+                          } });
+    benchmarks.push_back({ "LMS7002M::GetParam/name", [names, lookups]() {
+                              std::size_t found = 0;
+                              for (const std::string& name : *names)
+                                  found += LMS7002M::GetParam(name).address;
+                              lookupChecksum = found;
+                              return Work{ lookups, 0 };
+                          } });
+}
+
+/** @brief Emulates the LMS7002M registers, including the SX VCO comparators. */
+class LMS7002M_ChipEmulator : public ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (MOSI[i] & (1 << 31))
+            {
+                Register((MOSI[i] >> 16) & 0x7FFF) = MOSI[i] & 0xFFFF;
+                continue;
+            }
+            if (!MISO)
+                continue;
+            const uint16_t address = MOSI[i] & 0xFFFF;
+            uint16_t value = Register(address);
+            if (address == 0x0123)
+            {
+                // the VCO locks only for a band of CSW_VCO values
+                const uint16_t csw = (Register(0x0121) >> 3) & 0xFF;
+                const uint16_t cmphl = csw < 100 ? 0 : (csw > 160 ? 3 : 2);
+                value = (value & ~0x3000) | (cmphl << 12);
+            }
+            MISO[i] = value;
+        }
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+  private:
+    uint16_t& Register(uint16_t address)
+    {
+        const uint16_t mac = registers[0][0x0020] & 0x3;
+        return registers[(address >= 0x0100 && mac == 2) ? 1 : 0][address];
+    }
+
+    std::map<uint16_t, uint16_t> registers[2];
+};
+
+void AddHopProfileBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    const std::vector<float_type> frequencies = { 2400e6, 2420e6, 2440e6, 2460e6, 2480e6, 900e6, 915e6, 1575.42e6 };
+    auto chip = std::make_shared<LMS7002M>(std::make_shared<LMS7002M_ChipEmulator>());
+    chip->SetReferenceClk_SX(TRXDir::Rx, 30.72e6);
+    chip->PrepareHopProfiles(TRXDir::Rx, frequencies);
+
+    benchmarks.push_back({ "LMS7002M::SetFrequencySX", [chip, frequencies]() {
+                              for (float_type frequency : frequencies)
+                                  chip->SetFrequencySX(TRXDir::Rx, frequency);
+                              return Work{ frequencies.size(), 0 };
+                          } });
+    benchmarks.push_back({ "LMS7002M::ApplyHopProfile", [chip, frequencies]() {
+                              for (std::size_t i = 0; i < frequencies.size(); ++i)
+                                  chip->ApplyHopProfile(TRXDir::Rx, i);
+                              return Work{ frequencies.size(), 0 };
+                          } });
+}
+
+/** @brief Emulates an FPGA whose PLL operations complete after a fixed latency. */
+class FPGA_PLLLatencyEmulator : public ISPI
+{
+  public:
+    explicit FPGA_PLLLatencyEmulator(microseconds lockLatency)
+        : lockLatency(lockLatency)
+    {
+    }
+
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (MOSI[i] & (1 << 31))
+            {
+                const uint16_t address = (MOSI[i] >> 16) & 0x7FFF;
+                if (address == 0x0023 && (MOSI[i] & 0x7)) // PLLCFG_START, PHCFG_START or PLLRST_START
+                    operationStart = steady_clock::now();
+            }
+            else if (MISO)
+            {
+                switch (MOSI[i] & 0xFFFF)
+                {
+                case 0x0000:
+                    MISO[i] = LMS_DEV_LIMESDR_XTRX;
+                    break;
+                case 0x0021:
+                    MISO[i] = steady_clock::now() - operationStart >= lockLatency ? 0x5 : 0;
+                    break;
+                default:
+                    MISO[i] = 0;
+                }
+            }
+        }
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+  private:
+    const microseconds lockLatency;
+    steady_clock::time_point operationStart;
+};
+
+/** @brief Discards the LMS7002M register accesses. */
+class LMS7002M_Sink : public ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        if (MISO)
+            for (uint32_t i = 0; i < count; ++i)
+                MISO[i] = 0;
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+};
+
+void AddPllLockWaitBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    for (int latency_us : { 0, 300, 2000 })
+    {
+        auto fpga = std::make_shared<FPGA>(
+            std::make_shared<FPGA_PLLLatencyEmulator>(microseconds(latency_us)), std::make_shared<LMS7002M_Sink>());
+        benchmarks.push_back({ "FPGA::SetInterfaceFreq/lock:" + std::to_string(latency_us) + "us", [fpga]() {
+                                  fpga->SetInterfaceFreq(30.72e6, 30.72e6, 90, 90, 0);
+                                  return Work{ 1, 0 };
+                              } });
+    }
+}
+
+/// @brief Reads the CSV written by an earlier run.
+/// @return The items per second of each benchmark.
+std::map<std::string, double> ReadBaseline(const std::string& filename)
+{
+    std::map<std::string, double> baseline;
+    std::ifstream file(filename);
+    std::string line;
+    std::getline(file, line); // the column names
+    while (std::getline(file, line))
+    {
+        std::stringstream fields(line);
+        std::string name;
+        std::string itemsPerSecond;
+        if (std::getline(fields, name, ',') && std::getline(fields, itemsPerSecond, ','))
+            baseline[name] = std::atof(itemsPerSecond.c_str());
+    }
+    return baseline;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string csvFilename;
+    std::string baselineFilename;
+    double minSeconds = 0.2;
+    double threshold = 0.15;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value)
+        {
+            fprintf(stderr, "Missing value of %s\n", option.c_str());
+            return EXIT_FAILURE;
+        }
+        if (option == "--filter")
+            filter = value;
+        else if (option == "--min-time")
+            minSeconds = std::atof(value);
+        else if (option == "--csv")
+            csvFilename = value;
+        else if (option == "--baseline")
+            baselineFilename = value;
+        else if (option == "--threshold")
+            threshold = std::atof(value);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", option.c_str());
+            return EXIT_FAILURE;
+        }
+        ++i;
+    }
+
+    std::map<std::string, double> baseline;
+    if (!baselineFilename.empty())
+    {
+        baseline = ReadBaseline(baselineFilename);
+        if (baseline.empty())
+        {
+            fprintf(stderr, "No results in baseline %s\n", baselineFilename.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<Benchmark> benchmarks;
+    AddFIFOBenchmarks(benchmarks);
+    AddMemoryPoolBenchmarks(benchmarks);
+    AddSamplesPacketBenchmarks(benchmarks);
+    AddConversionBenchmarks(benchmarks);
+    AddTxBufferManagerBenchmarks(benchmarks);
+    AddRxCorrectorBenchmarks(benchmarks);
+    AddRxDecimatorBenchmarks(benchmarks);
+    AddParameterLookupBenchmarks(benchmarks);
+    AddCDCMPlanningBenchmarks(benchmarks);
+    AddHopProfileBenchmarks(benchmarks);
+    AddPllLockWaitBenchmarks(benchmarks);
+
+    std::ofstream csv;
+    if (!csvFilename.empty())
+    {
+        csv.open(csvFilename);
+        if (!csv.good())
+        {
+            fprintf(stderr, "Failed to create %s\n", csvFilename.c_str());
+            return EXIT_FAILURE;
+        }
+        csv << "name,items_per_second,bytes_per_second" << std::endl;
+    }
+
+    int regressions = 0;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (benchmark.name.find(filter) == std::string::npos)
+            continue;
+
+        const Result result = Measure(benchmark, minSeconds);
+        printf("%-48s %12.4g /s %12.3f MB/s", benchmark.name.c_str(), result.itemsPerSecond, result.bytesPerSecond / 1e6);
+        if (csv.is_open())
+            csv << benchmark.name << ',' << result.itemsPerSecond << ',' << result.bytesPerSecond << std::endl;
+
+        auto reference = baseline.find(benchmark.name);
+        if (reference != baseline.end() && reference->second > 0)
+        {
+            const double change = result.itemsPerSecond / reference->second - 1;
+            printf(" %+7.1f%%", change * 100);
+            if (change < -threshold)
+            {
+                printf(" REGRESSION");
+                ++regressions;
+            }
+        }
+        printf("\n");
+    }
+
+    if (regressions > 0)
+    {
+        fprintf(stderr, "%i benchmarks are more than %g%% slower than the baseline\n", regressions, threshold * 100);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
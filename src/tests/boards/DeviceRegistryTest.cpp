@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include "limesuite/DeviceRegistry.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace lime;
+using namespace std::literals::chrono_literals;
+
+namespace lime::testing {
+
+/** @brief Registry entry with one device and slow discovery. */
+class SlowDeviceEntry : public DeviceRegistryEntry
+{
+  public:
+    SlowDeviceEntry(const std::string& name)
+        : DeviceRegistryEntry(name)
+        , name(name)
+    {
+    }
+
+    std::vector<DeviceHandle> enumerate(const DeviceHandle& hint) override
+    {
+        ++enumerateCalls;
+        std::this_thread::sleep_for(probeDuration);
+
+        DeviceHandle handle;
+        handle.media = media;
+        handle.name = name;
+        handle.serial = "0001";
+        if (!handle.IsEqualIgnoringEmpty(hint))
+            return {};
+        return { handle };
+    }
+
+    SDRDevice* make(const DeviceHandle& handle) override
+    {
+        ++makeCalls;
+        return nullptr;
+    }
+
+    static constexpr auto probeDuration = 100ms;
+    static constexpr const char* media = "RegistryTest";
+    const std::string name;
+    std::atomic<int> enumerateCalls{ 0 };
+    std::atomic<int> makeCalls{ 0 };
+};
+
+} // namespace lime::testing
+
+using namespace lime::testing;
+
+class DeviceRegistryFixture : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        DeviceRegistry::invalidateCache();
+        hint.media = SlowDeviceEntry::media;
+    }
+
+    SlowDeviceEntry entryA{ "RegistryTestA" };
+    SlowDeviceEntry entryB{ "RegistryTestB" };
+    DeviceHandle hint;
+};
+
+TEST_F(DeviceRegistryFixture, EntriesAreProbedConcurrently)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto handles = DeviceRegistry::enumerate(hint);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(handles.size(), 2U);
+    EXPECT_EQ(handles[0].name, entryA.name);
+    EXPECT_EQ(handles[1].name, entryB.name);
+    EXPECT_LT(elapsed, SlowDeviceEntry::probeDuration * 2);
+}
+
+TEST_F(DeviceRegistryFixture, RepeatedEnumerationIsCached)
+{
+    EXPECT_EQ(DeviceRegistry::enumerate(hint).size(), 2U);
+    EXPECT_EQ(DeviceRegistry::enumerate(hint).size(), 2U);
+    EXPECT_EQ(entryA.enumerateCalls, 1);
+    EXPECT_EQ(entryB.enumerateCalls, 1);
+
+    DeviceRegistry::invalidateCache();
+    EXPECT_EQ(DeviceRegistry::enumerate(hint).size(), 2U);
+    EXPECT_EQ(entryA.enumerateCalls, 2);
+    EXPECT_EQ(entryB.enumerateCalls, 2);
+}
+
+TEST_F(DeviceRegistryFixture, EnumeratedHandleIsMadeWithoutDiscovery)
+{
+    auto handles = DeviceRegistry::enumerate(hint);
+    ASSERT_EQ(handles.size(), 2U);
+
+    DeviceRegistry::makeDevice(handles[1]);
+    EXPECT_EQ(entryA.enumerateCalls, 1);
+    EXPECT_EQ(entryB.enumerateCalls, 1);
+    EXPECT_EQ(entryA.makeCalls, 0);
+    EXPECT_EQ(entryB.makeCalls, 1);
+}
+
+TEST_F(DeviceRegistryFixture, UnknownHandleIsDiscoveredBeforeMaking)
+{
+    DeviceHandle handle;
+    handle.media = SlowDeviceEntry::media;
+    handle.name = entryB.name;
+
+    DeviceRegistry::makeDevice(handle);
+    EXPECT_EQ(entryB.enumerateCalls, 1);
+    EXPECT_EQ(entryA.makeCalls, 0);
+    EXPECT_EQ(entryB.makeCalls, 1);
+
+    handle.name = "RegistryTestMissing";
+    EXPECT_THROW(DeviceRegistry::makeDevice(handle), std::runtime_error);
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include "CalibrationScheduler.h"
+#include "LimeSDR_X3/SlaveSelectShim.h"
+#include "lms7002m/MCU_BD.h"
+#include "lms7002m/mcu_programs.h"
+#include "limesuite/LMS7002M.h"
+#include "mcu_program/common_src/lms7002m_calibrations.h"
+#include "mcu_program/common_src/spi.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <thread>
+
+using namespace lime;
+using namespace std::literals::chrono_literals;
+
+namespace lime::testing {
+
+/** @brief Shared SPI bus with an MCU behind every slave select, each transaction and procedure taking a realistic time. */
+class MCUBusFake : public IComms
+{
+  public:
+    MCUBusFake(std::chrono::milliseconds procedureDuration)
+        : procedureDuration(procedureDuration)
+    {
+    }
+
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override { return SPI(0, MOSI, MISO, count); }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        if (++transactionsInFlight > 1)
+            overlappingTransactions = true;
+
+        std::this_thread::sleep_for(20us);
+        Slave& slave = slaves[spiBusAddress];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (MOSI[i] & (1 << 31))
+            {
+                if (((MOSI[i] >> 16) & 0x7FFF) == markerAddress)
+                    ++slave.markerWrites;
+                // starting a procedure
+                if (((MOSI[i] >> 16) & 0x7FFF) == 0x0000)
+                    slave.procedureEnd = std::chrono::steady_clock::now() + procedureDuration;
+                continue;
+            }
+
+            if ((MOSI[i] & 0x7FFF) == 0x0001)
+                MISO[i] = std::chrono::steady_clock::now() < slave.procedureEnd ? 0xFF : slave.result;
+            else
+                MISO[i] = 0;
+        }
+
+        --transactionsInFlight;
+        return OpStatus::SUCCESS;
+    }
+
+    void SetResult(uint32_t slaveId, uint8_t result) { slaves[slaveId].result = result; }
+
+    /// @brief Gets the amount of writes the slave received to the marker register.
+    int GetMarkerWrites(uint32_t slaveId) { return slaves[slaveId].markerWrites; }
+
+    static constexpr uint16_t markerAddress = 0x0123;
+
+    std::atomic<bool> overlappingTransactions{ false };
+
+  private:
+    struct Slave {
+        std::chrono::steady_clock::time_point procedureEnd;
+        uint8_t result{ 0 };
+        int markerWrites{ 0 };
+    };
+
+    const std::chrono::milliseconds procedureDuration;
+    std::atomic<int> transactionsInFlight{ 0 };
+    std::map<uint32_t, Slave> slaves;
+};
+
+} // namespace lime::testing
+
+using namespace lime::testing;
+
+namespace {
+
+constexpr uint32_t chipCount = 3;
+constexpr auto procedureDuration = 100ms;
+
+struct Chip {
+    std::shared_ptr<SlaveSelectShim> shim;
+    MCU_BD mcu;
+};
+
+OpStatus RunCalibration(MCU_BD& mcu)
+{
+    mcu.RunProcedure(MCU_FUNCTION_CALIBRATE_RX);
+    return mcu.WaitForMCU(1000) == MCU_BD::MCU_NO_ERROR ? OpStatus::SUCCESS : OpStatus::ERROR;
+}
+
+} // namespace
+
+class CalibrationSchedulerFixture : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        bus = std::make_shared<MCUBusFake>(procedureDuration);
+        auto busLock = std::make_shared<std::mutex>();
+        for (uint32_t i = 0; i < chipCount; ++i)
+        {
+            chips[i].shim = std::make_shared<SlaveSelectShim>(bus, i, busLock);
+            chips[i].mcu.Initialize(chips[i].shim);
+        }
+    }
+
+    std::chrono::steady_clock::duration RunAll(CalibrationScheduler& scheduler, std::vector<OpStatus>& results)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        results = scheduler.Run();
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    std::shared_ptr<MCUBusFake> bus;
+    Chip chips[chipCount];
+};
+
+TEST_F(CalibrationSchedulerFixture, IndependentBusesCalibrateConcurrently)
+{
+    CalibrationScheduler scheduler;
+    for (uint32_t i = 0; i < chipCount; ++i)
+        scheduler.AddTask(i, [this, i]() { return RunCalibration(chips[i].mcu); });
+
+    std::vector<OpStatus> results;
+    const auto elapsed = RunAll(scheduler, results);
+
+    ASSERT_EQ(results.size(), chipCount);
+    for (OpStatus status : results)
+        EXPECT_EQ(status, OpStatus::SUCCESS);
+    // sequential execution would take at least chipCount * procedureDuration
+    EXPECT_LT(elapsed, procedureDuration * 2);
+    EXPECT_FALSE(bus->overlappingTransactions);
+}
+
+TEST_F(CalibrationSchedulerFixture, SharedBusCalibratesSequentially)
+{
+    CalibrationScheduler scheduler;
+    for (uint32_t i = 0; i < chipCount; ++i)
+        scheduler.AddTask(0, [this, i]() { return RunCalibration(chips[i].mcu); });
+
+    std::vector<OpStatus> results;
+    const auto elapsed = RunAll(scheduler, results);
+
+    ASSERT_EQ(results.size(), chipCount);
+    EXPECT_GE(elapsed, procedureDuration * chipCount);
+    EXPECT_FALSE(bus->overlappingTransactions);
+}
+
+TEST_F(CalibrationSchedulerFixture, ResultsAreReportedPerTask)
+{
+    bus->SetResult(1, 5);
+
+    CalibrationScheduler scheduler;
+    for (uint32_t i = 0; i < chipCount; ++i)
+        EXPECT_EQ(scheduler.AddTask(i, [this, i]() { return RunCalibration(chips[i].mcu); }), i);
+
+    std::vector<OpStatus> results;
+    RunAll(scheduler, results);
+
+    ASSERT_EQ(results.size(), chipCount);
+    EXPECT_EQ(results[0], OpStatus::SUCCESS);
+    EXPECT_EQ(results[1], OpStatus::ERROR);
+    EXPECT_EQ(results[2], OpStatus::SUCCESS);
+
+    // the queue is consumed by Run()
+    EXPECT_TRUE(scheduler.Run().empty());
+}
+
+TEST_F(CalibrationSchedulerFixture, HostCalibrationsWriteToTheChipOfTheirThread)
+{
+    LMS7002M lms0(chips[0].shim);
+    LMS7002M lms1(chips[1].shim);
+    LMS7002M* lms[] = { &lms0, &lms1 };
+
+    CalibrationScheduler scheduler;
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        scheduler.AddTask(i, [&lms, i]() {
+            SetupCalibrations(lms[i], 5e6);
+            // the other thread selects its own chip in the meantime
+            std::this_thread::sleep_for(20ms);
+            for (uint32_t n = 0; n < 10 * (i + 1); ++n)
+                SPI_write(MCUBusFake::markerAddress, 0);
+            return OpStatus::SUCCESS;
+        });
+    }
+    scheduler.Run();
+
+    EXPECT_EQ(bus->GetMarkerWrites(0), 10);
+    EXPECT_EQ(bus->GetMarkerWrites(1), 20);
+}
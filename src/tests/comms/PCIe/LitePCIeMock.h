@@ -3,15 +3,142 @@
 
 #include <gmock/gmock.h>
 
+#include "comms/PCIe/DMARecording.h"
 #include "comms/PCIe/LitePCIe.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace lime::testing {
 
 class LitePCIeMock : public LitePCIe
 {
   public:
+    MOCK_METHOD(bool, IsOpen, (), (override));
     MOCK_METHOD(int, WriteControl, (const uint8_t* buffer, int length, int timeout_ms), (override));
     MOCK_METHOD(int, ReadControl, (uint8_t * buffer, int length, int timeout_ms), (override));
+
+    MOCK_METHOD(void, RxDMAEnable, (bool enabled, uint32_t bufferSize, uint8_t irqPeriod), (override));
+    MOCK_METHOD(void, TxDMAEnable, (bool enabled), (override));
+    MOCK_METHOD(DMAInfo, GetDMAInfo, (), (override));
+    MOCK_METHOD(DMAState, GetRxDMAState, (), (override));
+    MOCK_METHOD(DMAState, GetTxDMAState, (), (override));
+    MOCK_METHOD(int, SetRxDMAState, (DMAState s), (override));
+    MOCK_METHOD(int, SetTxDMAState, (DMAState s), (override));
+    MOCK_METHOD(bool, WaitRx, (), (override));
+    MOCK_METHOD(bool, WaitTx, (), (override));
+    MOCK_METHOD(void, CacheFlush, (bool isTx, bool toDevice, uint16_t index), (override));
+
+    /**
+      @brief Makes the Rx DMA of the port replay a recording made by the DMARecorder.
+
+      The recorded buffers are written into the DMA ring when the hardware index of the recording passes them.
+      A consumer that falls behind gets its buffers overwritten, the same as with the real device.
+      @param filename The path of the recording.
+      @param speed The replay speed relative to the recording, 0 to deliver the buffers as fast as they are consumed.
+      @return The status of the operation.
+     */
+    OpStatus ReplayRx(const std::string& filename, double speed = 1)
+    {
+        DMARecordingReader reader;
+        OpStatus status = reader.Open(filename);
+        if (status != OpStatus::SUCCESS)
+            return status;
+        replayHeader = reader.GetHeader();
+        replayRecords.clear();
+        DMARecord record;
+        while (reader.ReadNext(record))
+            replayRecords.push_back(record);
+
+        // a buffer has arrived by the first time the hardware index was seen past it
+        replayArrival_ns.assign(replayRecords.size(), 0);
+        std::size_t next = 0;
+        for (const DMARecord& reading : replayRecords)
+        {
+            while (next < replayRecords.size() && static_cast<int32_t>(reading.hwIndex - replayRecords[next].swIndex) > 0)
+                replayArrival_ns[next++] = reading.time_ns;
+        }
+
+        replaySpeed = speed;
+        replayMemory.assign(replayHeader.dmaBufferSize * replayHeader.dmaBufferCount, 0);
+        replayHwIndex = 0;
+        replaySwIndex.store(0);
+        replayStarted = false;
+
+        DMAInfo info;
+        info.rxMemory = replayMemory.data();
+        info.bufferSize = replayHeader.dmaBufferSize;
+        info.bufferCount = replayHeader.dmaBufferCount;
+        ON_CALL(*this, IsOpen()).WillByDefault(::testing::Return(true));
+        ON_CALL(*this, GetDMAInfo()).WillByDefault(::testing::Return(info));
+        ON_CALL(*this, GetRxDMAState()).WillByDefault(::testing::Invoke([this]() { return ReplayState(); }));
+        ON_CALL(*this, SetRxDMAState(::testing::_)).WillByDefault(::testing::Invoke([this](DMAState state) {
+            replaySwIndex.store(state.swIndex);
+            return 0;
+        }));
+        ON_CALL(*this, WaitRx()).WillByDefault(::testing::Invoke([this]() {
+            if (ReplayState().hwIndex == replaySwIndex.load())
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            const DMAState state = ReplayState();
+            return state.hwIndex != state.swIndex;
+        }));
+        return OpStatus::SUCCESS;
+    }
+
+    /// @brief Gets whether every recorded buffer has been consumed.
+    bool ReplayFinished() const { return replaySwIndex.load() >= replayRecords.size(); }
+
+    /// @brief Gets the layout of the DMA ring of the replayed recording.
+    const DMARecordingHeader& GetReplayHeader() const { return replayHeader; }
+
+  private:
+    /// @brief Advances the hardware index of the replay, writing the arrived buffers into the DMA ring.
+    DMAState ReplayState()
+    {
+        const uint32_t swIndex = replaySwIndex.load();
+        uint32_t available = replayRecords.size();
+        if (replaySpeed > 0)
+        {
+            if (!replayStarted)
+            {
+                replayStart = std::chrono::steady_clock::now();
+                replayStarted = true;
+            }
+            const double elapsed_ns =
+                std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - replayStart).count() * replaySpeed;
+            available = std::upper_bound(replayArrival_ns.begin(), replayArrival_ns.end(), elapsed_ns) - replayArrival_ns.begin();
+        }
+        else // keep the consumer away from the overrun limit
+            available = std::min<uint32_t>(available, swIndex + replayHeader.dmaBufferCount / 2 - 1);
+
+        for (; replayHwIndex < available; ++replayHwIndex)
+        {
+            const std::vector<uint8_t>& data = replayRecords[replayHwIndex].data;
+            const std::size_t offset = (replayHwIndex % replayHeader.dmaBufferCount) * replayHeader.dmaBufferSize;
+            std::memcpy(&replayMemory[offset], data.data(), data.size());
+        }
+
+        DMAState state{};
+        state.enabled = true;
+        state.hwIndex = replayHwIndex;
+        state.swIndex = swIndex;
+        return state;
+    }
+
+    DMARecordingHeader replayHeader{};
+    std::vector<DMARecord> replayRecords;
+    std::vector<uint64_t> replayArrival_ns;
+    std::vector<uint8_t> replayMemory;
+    double replaySpeed = 1;
+    uint32_t replayHwIndex = 0;
+    std::atomic<uint32_t> replaySwIndex{ 0 };
+    bool replayStarted = false;
+    std::chrono::steady_clock::time_point replayStart;
 };
 
 } // namespace lime::testing
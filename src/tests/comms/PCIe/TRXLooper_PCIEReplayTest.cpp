@@ -0,0 +1,355 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "LitePCIeMock.h"
+#include "comms/PCIe/DMARecording.h"
+#include "comms/PCIe/TRXLooper_PCIE.h"
+#include "DataPacket.h"
+#include "FPGA_common.h"
+#include "limesuite/LMS7002M.h"
+#include "tests/include/limesuite/CommsMock.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+using namespace lime;
+using namespace lime::testing;
+using namespace std::chrono;
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::NiceMock;
+
+namespace {
+
+// the Rx packets TRXLooper_PCIE requests by default hold 256 16 bit samples of each channel
+constexpr uint32_t samplesInPacket = 256;
+constexpr uint32_t dmaBufferSize = 8192;
+
+/// @brief The looper of an FPGA image that streams the channels of two chips together.
+class TwoChipLooper : public TRXLooper_PCIE
+{
+  public:
+    TwoChipLooper(std::shared_ptr<LitePCIe> port, FPGA* f, LMS7002M* chip)
+        : TRXLooper_PCIE(port, port, f, chip, 0)
+    {
+        mChannelCount = 4;
+    }
+};
+
+} // namespace
+
+class TRXLooper_PCIEReplayTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        SetChannelCount(1);
+        config.format = SDRDevice::StreamConfig::DataFormat::I16;
+        config.linkFormat = SDRDevice::StreamConfig::DataFormat::I16;
+    }
+
+    void TearDown() override
+    {
+        std::remove(recordingName.c_str());
+        std::remove(rerecordingName.c_str());
+    }
+
+    /// @brief Sets the amount of received channels and the packet layout the looper requests for them.
+    void SetChannelCount(uint8_t count)
+    {
+        channelCount = count;
+        config.channels[TRXDir::Rx].clear();
+        for (uint8_t ch = 0; ch < count; ++ch)
+            config.channels[TRXDir::Rx].push_back(ch);
+        packetSize = 16 + samplesInPacket * sizeof(complex16_t) * count;
+        packetsInBuffer = std::min<uint32_t>(6, dmaBufferSize / packetSize);
+    }
+
+    /// @brief Records a synthetic stream, the I values count up with the timestamp, the Q values hold the channel index.
+    /// @param buffers The amount of DMA buffers to record.
+    /// @param skippedBuffer The buffer lost before the recording, as in an overrun (-1 for none).
+    /// @param period The time between the buffers.
+    void Record(uint32_t buffers, int skippedBuffer = -1, microseconds period = microseconds(0))
+    {
+        DMARecordingHeader header{ dmaBufferSize, 16, packetSize * packetsInBuffer, packetSize };
+        DMARecorder recorder;
+        ASSERT_EQ(recorder.Open(recordingName, header), OpStatus::SUCCESS);
+
+        std::vector<uint8_t> buffer(header.readSize);
+        uint32_t index = 0;
+        for (uint32_t i = 0; i < buffers; ++i, ++index)
+        {
+            if (static_cast<int>(i) == skippedBuffer)
+                ++index;
+            for (uint32_t p = 0; p < packetsInBuffer; ++p)
+            {
+                FPGA_RxDataPacket* pkt = reinterpret_cast<FPGA_RxDataPacket*>(&buffer[p * packetSize]);
+                pkt->counter = (index * packetsInBuffer + p) * samplesInPacket;
+                complex16_t* samples = reinterpret_cast<complex16_t*>(pkt->data);
+                for (uint32_t s = 0; s < samplesInPacket; ++s)
+                {
+                    for (uint8_t ch = 0; ch < channelCount; ++ch)
+                        samples[s * channelCount + ch] = complex16_t((pkt->counter + s) & 0x7FFF, ch);
+                }
+            }
+            std::this_thread::sleep_for(period);
+            recorder.Record(index + 1, index, buffer.data());
+        }
+        recorder.Close();
+    }
+
+    /// @brief Streams the replayed recording through the looper until every buffer is consumed.
+    /// @param buffers The amount of recorded buffers.
+    /// @param speed The replay speed.
+    /// @return The received samples of each channel.
+    std::vector<std::vector<complex16_t>> Replay(uint32_t buffers, double speed = 0)
+    {
+        EXPECT_EQ(port->ReplayRx(recordingName, speed), OpStatus::SUCCESS);
+        EXPECT_CALL(*port, RxDMAEnable(true, port->GetReplayHeader().readSize, _)).Times(1);
+        EXPECT_CALL(*port, RxDMAEnable(false, _, _)).Times(AnyNumber());
+
+        EXPECT_EQ(looper.Setup(config), OpStatus::SUCCESS);
+        looper.Start();
+        const auto deadline = steady_clock::now() + seconds(10);
+        while (!port->ReplayFinished() && steady_clock::now() < deadline)
+            std::this_thread::sleep_for(milliseconds(1));
+        EXPECT_TRUE(port->ReplayFinished());
+
+        std::vector<std::vector<complex16_t>> samples(channelCount);
+        std::vector<complex16_t*> dest(channelCount);
+        for (uint8_t ch = 0; ch < channelCount; ++ch)
+        {
+            samples[ch].resize(buffers * packetsInBuffer * samplesInPacket);
+            dest[ch] = samples[ch].data();
+        }
+        const uint32_t received = looper.StreamRx(dest.data(), samples[0].size(), nullptr);
+        for (auto& channel : samples)
+            channel.resize(received);
+        stats = looper.GetStats(TRXDir::Rx);
+        looper.Stop();
+        return samples;
+    }
+
+    /// @brief Replays the recording and receives the stream from the given timestamp on.
+    /// @param count The amount of samples to receive.
+    /// @param timestamp The timestamp to seek to.
+    /// @param buffered Whether to seek after the looper has queued every buffer, instead of while they arrive.
+    /// @param meta The metadata of the received samples.
+    /// @return The received samples of the first channel.
+    std::vector<complex16_t> Seek(uint32_t count, uint64_t timestamp, bool buffered, SDRDevice::StreamMeta& meta)
+    {
+        EXPECT_EQ(port->ReplayRx(recordingName, buffered ? 0 : 1), OpStatus::SUCCESS);
+        EXPECT_EQ(looper.Setup(config), OpStatus::SUCCESS);
+        looper.Start();
+        const auto deadline = steady_clock::now() + seconds(10);
+        while (buffered && !port->ReplayFinished() && steady_clock::now() < deadline)
+            std::this_thread::sleep_for(milliseconds(1));
+
+        std::vector<complex16_t> samples(count);
+        complex16_t* dest = samples.data();
+        meta.timestamp = timestamp;
+        meta.waitForTimestamp = true;
+        samples.resize(looper.StreamRx(&dest, samples.size(), &meta));
+        looper.Stop();
+        return samples;
+    }
+
+    const std::string recordingName = "TRXLooper_PCIEReplayTest.dma";
+    const std::string rerecordingName = "TRXLooper_PCIEReplayTest_rerecorded.dma";
+
+    std::shared_ptr<NiceMock<LitePCIeMock>> port = std::make_shared<NiceMock<LitePCIeMock>>();
+    std::shared_ptr<NiceMock<CommsMock>> spi = std::make_shared<NiceMock<CommsMock>>();
+    FPGA fpga{ spi, nullptr };
+    LMS7002M chip{ nullptr };
+    TwoChipLooper looper{ port, &fpga, &chip };
+    SDRDevice::StreamConfig config;
+    SDRDevice::StreamStats stats;
+    uint8_t channelCount;
+    uint32_t packetSize;
+    uint32_t packetsInBuffer;
+};
+
+TEST_F(TRXLooper_PCIEReplayTest, RecordingIsReadBack)
+{
+    Record(3);
+
+    DMARecordingReader reader;
+    ASSERT_EQ(reader.Open(recordingName), OpStatus::SUCCESS);
+    EXPECT_EQ(reader.GetHeader().dmaBufferCount, 16U);
+    EXPECT_EQ(reader.GetHeader().readSize, packetSize * packetsInBuffer);
+
+    DMARecord record;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(reader.ReadNext(record));
+        EXPECT_EQ(record.swIndex, i);
+        EXPECT_EQ(record.hwIndex, i + 1);
+        EXPECT_EQ(reinterpret_cast<const FPGA_RxDataPacket*>(record.data.data())->counter, i * packetsInBuffer * samplesInPacket);
+    }
+    EXPECT_FALSE(reader.ReadNext(record));
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, InvalidRecordingIsReported)
+{
+    DMARecordingReader reader;
+    EXPECT_EQ(reader.Open("missing.dma"), OpStatus::FILE_NOT_FOUND);
+    EXPECT_EQ(port->ReplayRx("missing.dma"), OpStatus::FILE_NOT_FOUND);
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, ReplayedStreamIsReceivedWithoutLoss)
+{
+    const uint32_t buffers = 100;
+    Record(buffers);
+
+    const std::vector<complex16_t> samples = Replay(buffers)[0];
+    ASSERT_EQ(samples.size(), buffers * packetsInBuffer * samplesInPacket);
+    for (uint32_t i = 0; i < samples.size(); ++i)
+        ASSERT_EQ(samples[i].real(), static_cast<int16_t>(i & 0x7FFF)) << i;
+    EXPECT_EQ(stats.loss, 0U);
+    EXPECT_EQ(stats.packets, buffers * packetsInBuffer);
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, RecordedOverrunIsDetectedAsLoss)
+{
+    Record(50, 20);
+
+    Replay(50);
+    EXPECT_EQ(stats.loss, 1U);
+    EXPECT_EQ(stats.packets, 50 * packetsInBuffer);
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, LiveRecordingReproducesBuffers)
+{
+    Record(40);
+    config.extraConfig.rxDMARecordingFile = rerecordingName;
+    Replay(40);
+
+    DMARecordingReader original;
+    DMARecordingReader rerecorded;
+    ASSERT_EQ(original.Open(recordingName), OpStatus::SUCCESS);
+    ASSERT_EQ(rerecorded.Open(rerecordingName), OpStatus::SUCCESS);
+    EXPECT_EQ(rerecorded.GetHeader().readSize, original.GetHeader().readSize);
+    EXPECT_EQ(rerecorded.GetHeader().packetSize, original.GetHeader().packetSize);
+
+    DMARecord expected;
+    DMARecord record;
+    uint32_t count = 0;
+    while (original.ReadNext(expected))
+    {
+        ASSERT_TRUE(rerecorded.ReadNext(record));
+        EXPECT_EQ(record.swIndex, count++);
+        EXPECT_GT(record.hwIndex, record.swIndex);
+        EXPECT_EQ(record.data, expected.data);
+    }
+    EXPECT_FALSE(rerecorded.ReadNext(record));
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, TimedReplayKeepsRecordedPace)
+{
+    const milliseconds period(2);
+    const uint32_t buffers = 20;
+    Record(buffers, -1, period);
+
+    for (double speed : { 1.0, 4.0 })
+    {
+        const auto start = steady_clock::now();
+        EXPECT_EQ(Replay(buffers, speed)[0].size(), buffers * packetsInBuffer * samplesInPacket);
+        const double elapsed = duration<double>(steady_clock::now() - start).count();
+        // the buffers can't arrive sooner than they did in the recording
+        EXPECT_GE(elapsed, (buffers - 1) * duration<double>(period).count() / speed);
+        std::cout << "Replay at " << speed << "x speed: " << elapsed * 1e3 << " ms" << std::endl;
+    }
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, FourChannelsShareOneStream)
+{
+    SetChannelCount(4);
+    const uint32_t buffers = 60;
+    Record(buffers);
+
+    const std::vector<std::vector<complex16_t>> samples = Replay(buffers);
+    ASSERT_EQ(samples.size(), 4U);
+    for (uint8_t ch = 0; ch < 4; ++ch)
+    {
+        ASSERT_EQ(samples[ch].size(), buffers * packetsInBuffer * samplesInPacket);
+        for (uint32_t i = 0; i < samples[ch].size(); ++i)
+        {
+            ASSERT_EQ(samples[ch][i].real(), static_cast<int16_t>(i & 0x7FFF)) << int(ch) << ":" << i;
+            ASSERT_EQ(samples[ch][i].imag(), ch) << int(ch) << ":" << i;
+        }
+    }
+    EXPECT_EQ(stats.loss, 0U);
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, ChannelsBeyondTheStreamAreRejected)
+{
+    Record(1);
+    ASSERT_EQ(port->ReplayRx(recordingName), OpStatus::SUCCESS);
+
+    config.channels[TRXDir::Rx] = { 0, 4 };
+    EXPECT_EQ(looper.Setup(config), OpStatus::INVALID_VALUE);
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, SeekStartsAtRequestedTimestamp)
+{
+    const uint32_t buffers = 40;
+    Record(buffers, -1, milliseconds(1));
+
+    // mid packet, so the first packet is trimmed
+    const uint64_t timestamp = 27 * packetsInBuffer * samplesInPacket + 3 * samplesInPacket + 77;
+    for (bool buffered : { true, false })
+    {
+        SDRDevice::StreamMeta meta{};
+        const uint32_t count = buffers * packetsInBuffer * samplesInPacket - timestamp;
+        const std::vector<complex16_t> samples = Seek(count, timestamp, buffered, meta);
+        EXPECT_EQ(meta.timestamp, timestamp) << buffered;
+        ASSERT_EQ(samples.size(), count) << buffered;
+        for (uint32_t i = 0; i < samples.size(); ++i)
+            ASSERT_EQ(samples[i].real(), static_cast<int16_t>((timestamp + i) & 0x7FFF)) << buffered << ":" << i;
+    }
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, SeekIntoLostSamplesStartsAfterThem)
+{
+    const uint32_t buffers = 30;
+    const uint32_t lostBuffer = 20;
+    Record(buffers, lostBuffer, milliseconds(1));
+
+    SDRDevice::StreamMeta meta{};
+    const uint64_t bufferSamples = packetsInBuffer * samplesInPacket;
+    // the buffers after the lost one are recorded one index later
+    const uint32_t count = (buffers - lostBuffer) * bufferSamples;
+    const std::vector<complex16_t> samples = Seek(count, lostBuffer * bufferSamples + 100, false, meta);
+    EXPECT_EQ(meta.timestamp, (lostBuffer + 1) * bufferSamples);
+    ASSERT_EQ(samples.size(), count);
+    EXPECT_EQ(samples[0].real(), static_cast<int16_t>(meta.timestamp & 0x7FFF));
+}
+
+TEST_F(TRXLooper_PCIEReplayTest, DecimatedTimestampsAreHardwareTimestamps)
+{
+    const uint32_t buffers = 20;
+    const uint8_t ratio = 4;
+    Record(buffers);
+    config.extraConfig.rxDecimation.ratio = ratio;
+
+    EXPECT_EQ(port->ReplayRx(recordingName, 0), OpStatus::SUCCESS);
+    EXPECT_EQ(looper.Setup(config), OpStatus::SUCCESS);
+    looper.Start();
+
+    std::vector<complex16_t> samples(1000);
+    complex16_t* dest = samples.data();
+    // the seek target is in the hardware domain, the output starts at the next multiple of the ratio
+    const uint64_t timestamp = 5 * packetsInBuffer * samplesInPacket + 77;
+    SDRDevice::StreamMeta meta{};
+    meta.timestamp = timestamp;
+    meta.waitForTimestamp = true;
+    EXPECT_EQ(looper.StreamRx(&dest, samples.size(), &meta), samples.size());
+    EXPECT_EQ(meta.timestamp, (timestamp + ratio - 1) / ratio * ratio);
+
+    SDRDevice::StreamMeta next{};
+    EXPECT_EQ(looper.StreamRx(&dest, samples.size(), &next), samples.size());
+    EXPECT_EQ(next.timestamp, meta.timestamp + samples.size() * ratio);
+    looper.Stop();
+}
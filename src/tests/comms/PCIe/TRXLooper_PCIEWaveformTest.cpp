@@ -0,0 +1,137 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "LitePCIeMock.h"
+#include "comms/PCIe/TRXLooper_PCIE.h"
+#include "DataPacket.h"
+#include "FPGA_common.h"
+#include "tests/include/limesuite/CommsMock.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace lime;
+using namespace lime::testing;
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class TRXLooper_PCIEWaveformTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        dmaMemory.resize(bufferCount * bufferSize);
+        LitePCIe::DMAInfo info;
+        info.txMemory = dmaMemory.data();
+        info.bufferSize = bufferSize;
+        info.bufferCount = bufferCount;
+
+        ON_CALL(*port, GetDMAInfo()).WillByDefault(Return(info));
+        ON_CALL(*port, GetTxDMAState()).WillByDefault(Return(LitePCIe::DMAState{}));
+        ON_CALL(*port, WaitTx()).WillByDefault(Return(true));
+        // collects the payloads in the order the DMA buffers are submitted
+        ON_CALL(*port, SetTxDMAState(_)).WillByDefault(Invoke([this](LitePCIe::DMAState state) {
+            const uint8_t* buffer = dmaMemory.data() + state.swIndex * bufferSize;
+            const FPGA_TxDataPacket* pkt = reinterpret_cast<const FPGA_TxDataPacket*>(buffer);
+            uploaded.insert(uploaded.end(), pkt->data, pkt->data + state.bufferSize - 16);
+            ++packetCount;
+            return 0;
+        }));
+
+        config.channels[TRXDir::Tx] = { 0 };
+        config.format = SDRDevice::StreamConfig::DataFormat::I16;
+        config.linkFormat = SDRDevice::StreamConfig::DataFormat::I16;
+    }
+
+    static constexpr int bufferCount = 8;
+    static constexpr int bufferSize = sizeof(FPGA_TxDataPacket);
+
+    std::vector<uint8_t> dmaMemory;
+    std::vector<uint8_t> uploaded;
+    int packetCount = 0;
+
+    std::shared_ptr<NiceMock<LitePCIeMock>> port = std::make_shared<NiceMock<LitePCIeMock>>();
+    std::shared_ptr<NiceMock<CommsMock>> spi = std::make_shared<NiceMock<CommsMock>>();
+    FPGA fpga{ spi, nullptr };
+    SDRDevice::StreamConfig config;
+};
+
+TEST_F(TRXLooper_PCIEWaveformTest, ChunkedSourceIsUploadedInOrderWithProgress)
+{
+    const uint32_t count = 100000;
+    std::vector<complex16_t> waveform(count);
+    for (uint32_t i = 0; i < count; ++i)
+        waveform[i] = complex16_t(i & 0x7FFF, -static_cast<int16_t>(i & 0x7FFF));
+
+    uint32_t position = 0;
+    auto source = [&](void* const* dest, uint32_t maxCount) {
+        const uint32_t toCopy = std::min(maxCount, count - position);
+        std::memcpy(dest[0], &waveform[position], toCopy * sizeof(complex16_t));
+        position += toCopy;
+        return toCopy;
+    };
+    std::vector<uint64_t> reports;
+    auto progress = [&](uint64_t sent, uint64_t total) {
+        EXPECT_EQ(total, count);
+        reports.push_back(sent);
+        return true;
+    };
+
+    EXPECT_CALL(*port, TxDMAEnable(true)).Times(1);
+    EXPECT_CALL(*port, TxDMAEnable(false)).Times(1);
+    ASSERT_EQ(TRXLooper_PCIE::UploadTxWaveform(&fpga, port, config, 0, source, count, progress), OpStatus::SUCCESS);
+
+    ASSERT_EQ(uploaded.size(), count * sizeof(complex16_t));
+    EXPECT_EQ(std::memcmp(uploaded.data(), waveform.data(), uploaded.size()), 0);
+    EXPECT_EQ(packetCount, (count + 255) / 256);
+    ASSERT_GT(reports.size(), 1U);
+    EXPECT_TRUE(std::is_sorted(reports.begin(), reports.end()));
+    EXPECT_EQ(reports.back(), count);
+}
+
+TEST_F(TRXLooper_PCIEWaveformTest, ProgressCallbackCancelsUpload)
+{
+    const uint64_t count = 1000000;
+    auto source = [](void* const* dest, uint32_t maxCount) {
+        std::memset(dest[0], 0, maxCount * sizeof(complex16_t));
+        return maxCount;
+    };
+    int reports = 0;
+    auto progress = [&](uint64_t sent, uint64_t total) { return ++reports < 2; };
+
+    EXPECT_CALL(*port, TxDMAEnable(true)).Times(1);
+    EXPECT_CALL(*port, TxDMAEnable(false)).Times(AtLeast(1));
+    EXPECT_EQ(TRXLooper_PCIE::UploadTxWaveform(&fpga, port, config, 0, source, count, progress), OpStatus::ABORTED);
+    EXPECT_EQ(reports, 2);
+    EXPECT_LT(uploaded.size(), count * sizeof(complex16_t));
+}
+
+TEST_F(TRXLooper_PCIEWaveformTest, MIMOFileIsUploadedWithoutLoadingIt)
+{
+    const std::string filename = "TRXLooper_PCIEWaveformTest.bin";
+    const uint32_t frames = 5000;
+    std::vector<complex16_t> fileSamples(frames * 2);
+    for (uint32_t i = 0; i < fileSamples.size(); ++i)
+        fileSamples[i] = complex16_t(i & 0x7FFF, (i * 3) & 0x7FFF);
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(fileSamples.data()), fileSamples.size() * sizeof(complex16_t));
+    }
+
+    config.channels[TRXDir::Tx] = { 0, 1 };
+    EXPECT_EQ(TRXLooper_PCIE::UploadTxWaveformFile(&fpga, port, config, 0, filename), OpStatus::SUCCESS);
+    std::remove(filename.c_str());
+
+    // the link interleaves the channels sample by sample, same as the file
+    ASSERT_EQ(uploaded.size(), fileSamples.size() * sizeof(complex16_t));
+    EXPECT_EQ(std::memcmp(uploaded.data(), fileSamples.data(), uploaded.size()), 0);
+}
+
+TEST_F(TRXLooper_PCIEWaveformTest, MissingFileIsReported)
+{
+    EXPECT_CALL(*port, TxDMAEnable(_)).Times(0);
+    EXPECT_EQ(TRXLooper_PCIE::UploadTxWaveformFile(&fpga, port, config, 0, "missing.bin"), OpStatus::FILE_NOT_FOUND);
+}
@@ -0,0 +1,270 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "LitePCIeMock.h"
+#include "comms/PCIe/TRXLooper_PCIE.h"
+#include "comms/PCIe/TxBufferManager.h"
+#include "FPGA_common.h"
+#include "limesuite/LMS7002M.h"
+#include "SamplesPacket.h"
+#include "tests/include/limesuite/CommsMock.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace lime;
+using namespace lime::testing;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class TxBufferManagerTest : public ::testing::Test
+{
+  protected:
+    typedef SamplesPacket<2> PacketType;
+
+    void SetUp() override
+    {
+        packetMemory.resize(PacketType::headerSize + 2 * samplesCount * sizeof(complex16_t));
+        packet = PacketType::ConstructSamplesPacket(packetMemory.data(), samplesCount, sizeof(complex16_t));
+        packet->Reset();
+        packet->timestamp = 1000;
+        packet->useTimestamp = true;
+        packet->flush = false;
+        packet->endOfBurst = false;
+
+        samples.assign(samplesCount, complex16_t(1, -1));
+        const complex16_t* src[2] = { samples.data(), nullptr };
+        packet->push(src, 100);
+
+        dmaMemory.resize(65536);
+        output.Reset(dmaMemory.data(), dmaMemory.size());
+    }
+
+    /// @brief Refills the source packet with the given amount of samples.
+    void Refill(uint32_t count, uint64_t timestamp)
+    {
+        packet->Reset();
+        packet->timestamp = timestamp;
+        const complex16_t* src[2] = { samples.data(), nullptr };
+        packet->push(src, count);
+    }
+
+    /// @brief Gets the offsets of the packet headers in the transfer.
+    std::vector<uint32_t> PacketOffsets() const
+    {
+        std::vector<uint32_t> offsets;
+        for (uint32_t offset = 0; offset < output.size();)
+        {
+            offsets.push_back(offset);
+            offset += sizeof(StreamHeader) + reinterpret_cast<const StreamHeader*>(output.data() + offset)->GetPayloadSize();
+        }
+        return offsets;
+    }
+
+    static constexpr uint32_t samplesCount = 1024;
+
+    std::vector<complex16_t> samples;
+    std::vector<uint8_t> packetMemory;
+    std::vector<uint8_t> dmaMemory;
+    PacketType* packet;
+    TxBufferManager<PacketType> output{ 1, false, 256, 4, SDRDevice::StreamConfig::DataFormat::I16 };
+};
+
+TEST_F(TxBufferManagerTest, PartialPacketWaitsForMoreSamples)
+{
+    EXPECT_FALSE(output.consume(packet));
+    EXPECT_FALSE(output.endsBurst());
+}
+
+TEST_F(TxBufferManagerTest, EndOfBurstPadsAndSendsLastPacket)
+{
+    // an odd amount of 16 bit samples does not fill the 16 byte bus width
+    const complex16_t* src[2] = { samples.data(), nullptr };
+    packet->push(src, 1);
+    packet->flush = true;
+    packet->endOfBurst = true;
+
+    EXPECT_TRUE(output.consume(packet));
+    EXPECT_TRUE(output.endsBurst());
+    EXPECT_EQ(output.packetCount(), 1);
+    EXPECT_EQ(output.size() % 16, 0U);
+    EXPECT_GE(output.size(), sizeof(StreamHeader) + 101 * sizeof(complex16_t));
+
+    const StreamHeader* header = reinterpret_cast<const StreamHeader*>(output.data());
+    EXPECT_EQ(header->counter, 1000);
+    EXPECT_EQ(header->GetPayloadSize(), output.size() - sizeof(StreamHeader));
+    // the 3 padding samples are transmitted too
+    EXPECT_EQ(output.endTimestamp(), 1104);
+
+    output.Reset(dmaMemory.data(), dmaMemory.size());
+    EXPECT_FALSE(output.endsBurst());
+}
+
+TEST_F(TxBufferManagerTest, FlushWithoutEndOfBurstKeepsBurstOpen)
+{
+    packet->flush = true;
+
+    EXPECT_TRUE(output.consume(packet));
+    EXPECT_FALSE(output.endsBurst());
+}
+
+TEST_F(TxBufferManagerTest, FullPacketsKeepNextHeaderAligned)
+{
+    // 250 16 bit samples would end the packet in the middle of the bus width
+    TxBufferManager<PacketType> unaligned{ 1, false, 250, 4, SDRDevice::StreamConfig::DataFormat::I16 };
+    unaligned.Reset(dmaMemory.data(), dmaMemory.size());
+    Refill(samplesCount, 1000);
+
+    EXPECT_TRUE(unaligned.consume(packet));
+    EXPECT_EQ(unaligned.packetCount(), 4);
+    EXPECT_EQ(unaligned.size() % 16, 0U);
+    uint32_t offset = 0;
+    int64_t timestamp = 1000;
+    for (int i = 0; i < unaligned.packetCount(); ++i)
+    {
+        EXPECT_EQ(offset % 16, 0U);
+        const StreamHeader* header = reinterpret_cast<const StreamHeader*>(unaligned.data() + offset);
+        EXPECT_EQ(header->counter, timestamp);
+        EXPECT_LE(header->GetPayloadSize(), 250 * sizeof(complex16_t));
+        timestamp += header->GetPayloadSize() / sizeof(complex16_t);
+        offset += sizeof(StreamHeader) + header->GetPayloadSize();
+    }
+    EXPECT_EQ(offset, unaligned.size());
+}
+
+TEST_F(TxBufferManagerTest, ContiguousPacketsContinueSamePacket)
+{
+    EXPECT_FALSE(output.consume(packet));
+    Refill(100, 1100);
+    EXPECT_FALSE(output.consume(packet));
+
+    EXPECT_EQ(output.packetCount(), 1);
+    EXPECT_EQ(output.size(), sizeof(StreamHeader) + 200 * sizeof(complex16_t));
+}
+
+TEST_F(TxBufferManagerTest, TimestampGapsStartNewPacketsInSameBuffer)
+{
+    const int64_t timestamps[] = { 1000, 5000, 9000, 13000 };
+    for (int64_t timestamp : timestamps)
+    {
+        Refill(100, timestamp);
+        EXPECT_FALSE(output.consume(packet));
+    }
+    // the last packet could still be continued, the batch is sent once a fifth packet is needed
+    Refill(100, 17000);
+    EXPECT_TRUE(output.consume(packet));
+    EXPECT_EQ(packet->size(), 100U);
+
+    const std::vector<uint32_t> offsets = PacketOffsets();
+    ASSERT_EQ(offsets.size(), 4U);
+    for (int i = 0; i < 4; ++i)
+    {
+        const StreamHeader* header = reinterpret_cast<const StreamHeader*>(output.data() + offsets[i]);
+        EXPECT_EQ(offsets[i] % 16, 0U);
+        EXPECT_EQ(header->counter, timestamps[i]);
+        EXPECT_EQ(header->GetPayloadSize(), 100 * sizeof(complex16_t));
+    }
+}
+
+TEST_F(TxBufferManagerTest, MisalignedPacketEndSendsBufferBeforeGap)
+{
+    Refill(101, 1000);
+    EXPECT_FALSE(output.consume(packet));
+
+    // the next header can't follow an unaligned packet, so the buffer is padded and sent
+    Refill(100, 5000);
+    EXPECT_TRUE(output.consume(packet));
+    EXPECT_EQ(packet->size(), 100U);
+    EXPECT_EQ(output.packetCount(), 1);
+    EXPECT_EQ(output.size() % 16, 0U);
+}
+
+/// @brief Streams through the Tx loop of the looper, the port counts the calls the loop makes to the driver.
+class TxBufferManagerLooperTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        dmaMemory.resize(bufferCount * bufferSize);
+        LitePCIe::DMAInfo info;
+        info.txMemory = dmaMemory.data();
+        info.bufferSize = bufferSize;
+        info.bufferCount = bufferCount;
+
+        ON_CALL(*port, IsOpen()).WillByDefault(Return(true));
+        ON_CALL(*port, GetDMAInfo()).WillByDefault(Return(info));
+        ON_CALL(*port, WaitTx()).WillByDefault(Return(true));
+        // the hardware consumes every submitted buffer at once
+        ON_CALL(*port, GetTxDMAState()).WillByDefault(Invoke([this]() {
+            ++stateReads;
+            LitePCIe::DMAState state{};
+            state.enabled = true;
+            state.hwIndex = submissions.load() & 0xFFFF;
+            state.swIndex = state.hwIndex;
+            return state;
+        }));
+        ON_CALL(*port, SetTxDMAState(_)).WillByDefault(Invoke([this](LitePCIe::DMAState state) {
+            ++submissions;
+            return 0;
+        }));
+        ON_CALL(*port, CacheFlush(true, _, _)).WillByDefault(Invoke([this](bool, bool, uint16_t) { ++cacheFlushes; }));
+
+        config.channels[TRXDir::Tx] = { 0 };
+        config.format = SDRDevice::StreamConfig::DataFormat::I16;
+        config.linkFormat = SDRDevice::StreamConfig::DataFormat::I16;
+        config.hintSampleRate = 1e6;
+        config.extraConfig.tx.packetsInBatch = 4;
+    }
+
+    static constexpr int bufferCount = 16;
+    static constexpr int bufferSize = 8192;
+
+    std::vector<uint8_t> dmaMemory;
+    std::atomic<int> submissions{ 0 };
+    std::atomic<int> cacheFlushes{ 0 };
+    std::atomic<int> stateReads{ 0 };
+
+    std::shared_ptr<NiceMock<LitePCIeMock>> port = std::make_shared<NiceMock<LitePCIeMock>>();
+    std::shared_ptr<NiceMock<CommsMock>> spi = std::make_shared<NiceMock<CommsMock>>();
+    FPGA fpga{ spi, nullptr };
+    LMS7002M chip{ nullptr };
+    TRXLooper_PCIE looper{ port, port, &fpga, &chip, 0 };
+    SDRDevice::StreamConfig config;
+};
+
+TEST_F(TxBufferManagerLooperTest, BenchmarkBuffersPerMegasample)
+{
+    // 1 Msps of timestamped 100 sample packets with gaps in between, e.g. TDD slots
+    const int packets = 10000;
+    std::vector<complex16_t> samples(100, complex16_t(1, -1));
+    const complex16_t* src[1] = { samples.data() };
+
+    ASSERT_EQ(looper.Setup(config), OpStatus::SUCCESS);
+    looper.Start();
+    SDRDevice::StreamMeta meta{};
+    meta.waitForTimestamp = true;
+    for (int i = 0; i < packets; ++i)
+    {
+        meta.timestamp = 1000 + i * 200;
+        meta.endOfBurst = i == packets - 1;
+        while (looper.StreamTx(src, samples.size(), &meta) == 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (submissions.load() < packets / 4 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    looper.Stop();
+
+    const int buffers = submissions.load();
+    EXPECT_EQ(buffers, packets / 4);
+    // every buffer is flushed to the device before the submission, and back to the CPU for its reuse
+    EXPECT_EQ(cacheFlushes.load(), 2 * buffers + 1);
+    const int ioctls = cacheFlushes.load() + buffers + stateReads.load();
+    std::cout << "DMA buffers per MSps: " << buffers << ", ioctls per MSps: " << ioctls << " (cache flushes: " << cacheFlushes
+              << ", submissions: " << buffers << ", state reads: " << stateReads << ")" << std::endl;
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include "TRXLooper_USB.h"
+#include "USBGeneric.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+using namespace lime;
+using namespace std::literals::chrono_literals;
+
+#ifdef __unix__
+
+namespace lime::testing {
+
+/** @brief A USB device whose event thread completes the submitted transfers after a set delay. */
+class USBGenericEventsMock : public USBGeneric
+{
+  public:
+    USBGenericEventsMock(std::chrono::milliseconds completionDelay)
+        : USBGeneric(nullptr)
+        , completionDelay(completionDelay)
+    {
+        contexts = new USBTransferContext[USB_MAX_CONTEXTS];
+        isConnected = true;
+        StartEventsThread();
+    }
+
+    ~USBGenericEventsMock() override { StopEventsThread(); }
+
+    int Submit(long length)
+    {
+        int i = GetUSBContextIndex();
+        if (i < 0)
+        {
+            return i;
+        }
+
+        contexts[i].done = false;
+        contexts[i].bytesXfered = 0;
+        {
+            std::lock_guard<std::mutex> lck(pendingLock);
+            pending.push_back({ i, length });
+        }
+        pendingCv.notify_one();
+        return i;
+    }
+
+    bool IsDone(int contextHandle) { return contexts[contextHandle].done.load(); }
+
+  protected:
+    void HandleLibusbEvents() override
+    {
+        while (!mEventsTerminate.load())
+        {
+            std::unique_lock<std::mutex> lck(pendingLock);
+            if (!pendingCv.wait_for(lck, 10ms, [&]() { return !pending.empty(); }))
+            {
+                continue;
+            }
+
+            auto transfer = pending.front();
+            pending.pop_front();
+            lck.unlock();
+
+            std::this_thread::sleep_for(completionDelay);
+            contexts[transfer.first].SignalDone(transfer.second);
+        }
+    }
+
+  private:
+    std::chrono::milliseconds completionDelay;
+    std::mutex pendingLock;
+    std::condition_variable pendingCv;
+    std::deque<std::pair<int, long>> pending;
+};
+
+/** @brief A USB device with a libusb session of its own, running the real event thread. */
+class USBGenericSession : public USBGeneric
+{
+  public:
+    USBGenericSession()
+        : USBGeneric(this)
+    {
+    }
+
+    std::thread& GetEventsThread() { return mEventsThread; }
+};
+
+} // namespace lime::testing
+
+using namespace lime::testing;
+
+TEST(USBGeneric, TransferCompletesThroughOwnEventsThread)
+{
+    USBGenericEventsMock device(0ms);
+
+    int handle = device.Submit(4096);
+    ASSERT_GE(handle, 0);
+    EXPECT_TRUE(device.WaitForXfer(handle, 1000));
+    EXPECT_EQ(device.FinishDataXfer(nullptr, 0, handle), 4096);
+}
+
+TEST(USBGeneric, WaitForXferTimesOutWhenNotCompleted)
+{
+    USBGenericEventsMock device(500ms);
+
+    int handle = device.Submit(4096);
+    ASSERT_GE(handle, 0);
+    EXPECT_FALSE(device.WaitForXfer(handle, 10));
+    EXPECT_TRUE(device.WaitForXfer(handle, 1000));
+    EXPECT_EQ(device.FinishDataXfer(nullptr, 0, handle), 4096);
+}
+
+TEST(USBGeneric, SlowDeviceDoesNotBlockOtherDevices)
+{
+    USBGenericEventsMock slowDevice(500ms);
+    USBGenericEventsMock fastDevice(0ms);
+
+    int slowHandle = slowDevice.Submit(1024);
+    ASSERT_GE(slowHandle, 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    constexpr int transferCount = 32;
+    for (int i = 0; i < transferCount; ++i)
+    {
+        int handle = fastDevice.Submit(512);
+        ASSERT_GE(handle, 0);
+        ASSERT_TRUE(fastDevice.WaitForXfer(handle, 1000));
+        EXPECT_EQ(fastDevice.FinishDataXfer(nullptr, 0, handle), 512);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // All of the fast device's transfers finished while the slow device's one is still in flight.
+    EXPECT_LT(elapsed, 300ms);
+    EXPECT_FALSE(slowDevice.IsDone(slowHandle));
+
+    EXPECT_TRUE(slowDevice.WaitForXfer(slowHandle, 1000));
+    EXPECT_EQ(slowDevice.FinishDataXfer(nullptr, 0, slowHandle), 1024);
+}
+
+#ifdef __linux__
+TEST(USBGeneric, StreamSetupPinsEventsThread)
+{
+    auto device = std::make_shared<USBGenericSession>();
+    ASSERT_TRUE(device->GetEventsThread().joinable());
+
+    // the last CPU this process may run on
+    cpu_set_t allowed;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &allowed), 0);
+    int cpu = CPU_SETSIZE - 1;
+    while (!CPU_ISSET(cpu, &allowed))
+    {
+        --cpu;
+    }
+
+    TRXLooper_USB looper(device, nullptr, nullptr, 0x81, 0x01);
+    SDRDevice::StreamConfig config;
+    config.extraConfig.usbEventsCpu = cpu;
+    EXPECT_EQ(looper.Setup(config), OpStatus::SUCCESS);
+
+    cpu_set_t pinned;
+    ASSERT_EQ(pthread_getaffinity_np(device->GetEventsThread().native_handle(), sizeof(cpu_set_t), &pinned), 0);
+    EXPECT_EQ(CPU_COUNT(&pinned), 1);
+    EXPECT_TRUE(CPU_ISSET(cpu, &pinned));
+}
+#endif // __linux__
+
+#endif // __unix__
@@ -0,0 +1,19 @@
+#ifndef LIME_I2CMOCK_H
+#define LIME_I2CMOCK_H
+
+#include <gmock/gmock.h>
+
+#include "limesuite/IComms.h"
+
+namespace lime::testing {
+
+class I2CMock : public II2C
+{
+  public:
+    MOCK_METHOD(OpStatus, I2CWrite, (int address, const uint8_t* data, uint32_t length), (override));
+    MOCK_METHOD(OpStatus, I2CRead, (int address, uint8_t* dest, uint32_t length), (override));
+};
+
+} // namespace lime::testing
+
+#endif // LIME_I2CMOCK_H
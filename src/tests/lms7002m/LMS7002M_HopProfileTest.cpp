@@ -0,0 +1,164 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "limesuite/IComms.h"
+#include "limesuite/LMS7002M.h"
+#include "tests/protocols/SerialPortMock.h"
+#include "LMS64CProtocol.h"
+
+#include <cstring>
+#include <map>
+
+using namespace lime;
+using namespace lime::testing;
+using ::testing::_;
+using ::testing::Invoke;
+
+namespace lime::testing {
+
+/** @brief Emulates the LMS7002M registers behind an LMS64C serial port, including the SX VCO comparators. */
+class LMS7002M_SerialChipFake
+{
+  public:
+    LMS7002M_SerialChipFake()
+        : packetsSent(0)
+    {
+        ON_CALL(port, Write(_, _, _)).WillByDefault(Invoke([this](const uint8_t* data, size_t length, int timeout_ms) {
+            std::memcpy(&packet, data, sizeof(packet));
+            ++packetsSent;
+            return static_cast<int>(length);
+        }));
+        ON_CALL(port, Read(_, _, _)).WillByDefault(Invoke([this](uint8_t* data, size_t length, int timeout_ms) {
+            Process();
+            std::memcpy(data, &packet, sizeof(packet));
+            return static_cast<int>(length);
+        }));
+    }
+
+    ::testing::NiceMock<SerialPortMock> port;
+    std::size_t packetsSent;
+
+  private:
+    uint16_t& Register(uint16_t address)
+    {
+        const uint16_t mac = registers[0][0x0020] & 0x3;
+        return registers[(address >= 0x0100 && mac == 2) ? 1 : 0][address];
+    }
+
+    void Process()
+    {
+        for (int i = 0; i < packet.blockCount; ++i)
+        {
+            if (packet.cmd == LMS64CProtocol::CMD_LMS7002_WR)
+            {
+                const uint16_t address = ((packet.payload[i * 4] << 8) | packet.payload[i * 4 + 1]) & 0x7FFF;
+                Register(address) = (packet.payload[i * 4 + 2] << 8) | packet.payload[i * 4 + 3];
+                continue;
+            }
+            const uint16_t address = (packet.payload[i * 2] << 8) | packet.payload[i * 2 + 1];
+            readAddresses[i] = address;
+        }
+        if (packet.cmd == LMS64CProtocol::CMD_LMS7002_RD)
+        {
+            for (int i = packet.blockCount - 1; i >= 0; --i)
+            {
+                uint16_t value = Register(readAddresses[i]);
+                if (readAddresses[i] == 0x0123)
+                {
+                    // the VCO locks only for a band of CSW_VCO values
+                    const uint16_t csw = (Register(0x0121) >> 3) & 0xFF;
+                    const uint16_t cmphl = csw < 100 ? 0 : (csw > 160 ? 3 : 2);
+                    value = (value & ~0x3000) | (cmphl << 12);
+                }
+                packet.payload[i * 4 + 2] = value >> 8;
+                packet.payload[i * 4 + 3] = value;
+            }
+        }
+        packet.status = LMS64CProtocol::STATUS_COMPLETED_CMD;
+    }
+
+    LMS64CPacket packet;
+    std::map<uint16_t, uint16_t> registers[2];
+    uint16_t readAddresses[LMS64CPacket::payloadSize / 2];
+};
+
+/** @brief Routes the chip's SPI transactions through the LMS64C protocol. */
+class LMS64C_SerialSPI : public ISPI
+{
+  public:
+    LMS64C_SerialSPI(ISerialPort& port)
+        : port(port)
+    {
+    }
+
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return LMS64CProtocol::LMS7002M_SPI(port, 0, MOSI, MISO, count);
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+  private:
+    ISerialPort& port;
+};
+
+} // namespace lime::testing
+
+class LMS7002M_HopProfileTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        chip.SetReferenceClk_SX(TRXDir::Rx, 30.72e6);
+        frequencies = { 2400e6, 2420e6, 2440e6, 2460e6, 2480e6, 900e6, 915e6, 1575.42e6 };
+    }
+
+    LMS7002M_SerialChipFake fake;
+    LMS7002M chip{ std::make_shared<LMS64C_SerialSPI>(fake.port) };
+    std::vector<float_type> frequencies;
+};
+
+TEST_F(LMS7002M_HopProfileTest, ProfilesMatchDirectTuning)
+{
+    ASSERT_EQ(chip.PrepareHopProfiles(TRXDir::Rx, frequencies), OpStatus::SUCCESS);
+    ASSERT_EQ(chip.GetHopProfileCount(TRXDir::Rx), frequencies.size());
+    EXPECT_EQ(chip.GetHopProfileCount(TRXDir::Tx), 0U);
+
+    for (std::size_t i = 0; i < frequencies.size(); ++i)
+    {
+        ASSERT_EQ(chip.ApplyHopProfile(TRXDir::Rx, i), OpStatus::SUCCESS);
+        EXPECT_NEAR(chip.GetFrequencySX(TRXDir::Rx), frequencies[i], 50.0); // fractional divider resolution
+    }
+
+    EXPECT_NE(chip.ApplyHopProfile(TRXDir::Rx, frequencies.size()), OpStatus::SUCCESS);
+}
+
+TEST_F(LMS7002M_HopProfileTest, ReferenceClockChangeDiscardsProfiles)
+{
+    ASSERT_EQ(chip.PrepareHopProfiles(TRXDir::Rx, frequencies), OpStatus::SUCCESS);
+    chip.SetReferenceClk_SX(TRXDir::Rx, 40e6);
+    EXPECT_EQ(chip.GetHopProfileCount(TRXDir::Rx), 0U);
+}
+
+TEST_F(LMS7002M_HopProfileTest, ProfileHopsUseFewerTransactions)
+{
+    const int hopCount = 16;
+
+    fake.packetsSent = 0;
+    for (int i = 0; i < hopCount; ++i)
+        ASSERT_EQ(chip.SetFrequencySX(TRXDir::Rx, frequencies[i % frequencies.size()]), OpStatus::SUCCESS);
+    const double directPackets = static_cast<double>(fake.packetsSent) / hopCount;
+
+    ASSERT_EQ(chip.PrepareHopProfiles(TRXDir::Rx, frequencies), OpStatus::SUCCESS);
+    fake.packetsSent = 0;
+    for (int i = 0; i < hopCount; ++i)
+        ASSERT_EQ(chip.ApplyHopProfile(TRXDir::Rx, i % frequencies.size()), OpStatus::SUCCESS);
+    const double profilePackets = static_cast<double>(fake.packetsSent) / hopCount;
+
+    // every hop is a single write batch, that fits into one packet
+    EXPECT_LE(profilePackets, 1.0);
+    EXPECT_LT(profilePackets, directPackets);
+}
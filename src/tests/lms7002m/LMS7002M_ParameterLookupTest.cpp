@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "limesuite/LMS7002M.h"
+
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+extern std::vector<std::reference_wrapper<const LMS7Parameter>> LMS7parameterList;
+
+using namespace lime;
+
+namespace {
+
+const LMS7Parameter& LinearSearch(const std::string& name)
+{
+    for (const LMS7Parameter& parameter : LMS7parameterList)
+    {
+        if (name == parameter.name)
+            return parameter;
+    }
+    throw std::logic_error("Parameter " + name + " not found");
+}
+
+} // namespace
+
+TEST(LMS7002M_ParameterLookup, EveryNameResolvesToFirstListedParameter)
+{
+    ASSERT_FALSE(LMS7parameterList.empty());
+    for (const LMS7Parameter& parameter : LMS7parameterList)
+        EXPECT_EQ(&LMS7002M::GetParam(parameter.name), &LinearSearch(parameter.name)) << parameter.name;
+}
+
+TEST(LMS7002M_ParameterLookup, ParameterIsFoundByAddressAndBits)
+{
+    const LMS7Parameter& gain = LMS7param(G_PGA_RBB);
+    EXPECT_STREQ(LMS7002M::GetParam(gain.address, gain.msb, gain.lsb).name, gain.name);
+
+    for (const LMS7Parameter& parameter : LMS7parameterList)
+    {
+        const LMS7Parameter& found = LMS7002M::GetParam(parameter.address, parameter.msb, parameter.lsb);
+        EXPECT_EQ(found.address, parameter.address);
+        EXPECT_EQ(found.msb, parameter.msb);
+        EXPECT_EQ(found.lsb, parameter.lsb);
+    }
+}
+
+TEST(LMS7002M_ParameterLookup, UnknownParametersThrow)
+{
+    EXPECT_THROW(LMS7002M::GetParam("NOT_A_PARAMETER"), std::logic_error);
+    EXPECT_THROW(LMS7002M::GetParam(""), std::logic_error);
+    EXPECT_THROW(LMS7002M::GetParam(0xFFFF, 15, 0), std::logic_error);
+}
@@ -0,0 +1,123 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "limesuite/LMS7002M.h"
+#include "tests/include/limesuite/CommsMock.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+using namespace lime;
+using namespace lime::testing;
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Invoke;
+using ::testing::IsNull;
+using ::testing::NotNull;
+
+static constexpr uint16_t chipRevision = 0x3841;
+
+class LMS7002M_SnapshotTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        filename = std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) + ".lms7snap";
+
+        LMS7002M source(nullptr);
+        source.EnableValuesCache(true);
+        source.SetActiveChannel(LMS7002M::Channel::ChA);
+        source.Modify_SPI_Reg_bits(LMS7param(G_PGA_RBB), 5);
+        source.Modify_SPI_Reg_bits(LMS7param(CMIX_GAIN_TXTSP), 1);
+        source.SetActiveChannel(LMS7002M::Channel::ChB);
+        source.Modify_SPI_Reg_bits(LMS7param(G_PGA_RBB), 17);
+        source.SetReferenceClk_SX(TRXDir::Rx, 40e6);
+        ASSERT_EQ(source.SaveSnapshot(filename), OpStatus::SUCCESS);
+
+        ON_CALL(*spi, SPI(NotNull(), NotNull(), _)).WillByDefault(Invoke([](const uint32_t* mosi, uint32_t* miso, uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i)
+                miso[i] = (mosi[i] & 0xFFFF) == 0x002F ? chipRevision : 0;
+            return OpStatus::SUCCESS;
+        }));
+    }
+
+    void TearDown() override { std::remove(filename.c_str()); }
+
+    std::string filename;
+    std::shared_ptr<CommsMock> spi = std::make_shared<CommsMock>();
+};
+
+TEST_F(LMS7002M_SnapshotTest, LoadWritesAllRegistersInOneBatchAndFillsCache)
+{
+    LMS7002M chip(spi);
+    chip.EnableValuesCache(true);
+
+    EXPECT_CALL(*spi, SPI(NotNull(), NotNull(), 1)).Times(1); // chip revision check
+    EXPECT_CALL(*spi, SPI(NotNull(), IsNull(), _)).Times(1);
+
+    ASSERT_EQ(chip.LoadSnapshot(filename), OpStatus::SUCCESS);
+    ::testing::Mock::VerifyAndClearExpectations(spi.get());
+
+    // Channel switching below goes to the chip, register values must come from the cache.
+    EXPECT_CALL(*spi, SPI(NotNull(), IsNull(), _)).Times(AnyNumber());
+    EXPECT_CALL(*spi, SPI(NotNull(), NotNull(), _)).Times(0);
+    chip.SetActiveChannel(LMS7002M::Channel::ChA);
+    EXPECT_EQ(chip.Get_SPI_Reg_bits(LMS7param(G_PGA_RBB)), 5);
+    EXPECT_EQ(chip.Get_SPI_Reg_bits(LMS7param(CMIX_GAIN_TXTSP)), 1);
+    chip.SetActiveChannel(LMS7002M::Channel::ChB);
+    EXPECT_EQ(chip.Get_SPI_Reg_bits(LMS7param(G_PGA_RBB)), 17);
+    EXPECT_EQ(chip.GetReferenceClk_SX(TRXDir::Rx), 40e6);
+}
+
+TEST_F(LMS7002M_SnapshotTest, CorruptedSnapshotIsRejected)
+{
+    std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(32);
+    file.put(0x5A);
+    file.close();
+
+    LMS7002M chip(spi);
+    EXPECT_CALL(*spi, SPI(_, _, _)).Times(0);
+
+    EXPECT_EQ(chip.LoadSnapshot(filename), OpStatus::INVALID_VALUE);
+}
+
+TEST_F(LMS7002M_SnapshotTest, ChipRevisionMismatchIsRejected)
+{
+    LMS7002M chip(spi);
+
+    EXPECT_CALL(*spi, SPI(NotNull(), NotNull(), 1)).WillOnce(Invoke([](const uint32_t*, uint32_t* miso, uint32_t) {
+        miso[0] = chipRevision + 1;
+        return OpStatus::SUCCESS;
+    }));
+    EXPECT_CALL(*spi, SPI(NotNull(), IsNull(), _)).Times(0);
+
+    EXPECT_EQ(chip.LoadSnapshot(filename), OpStatus::INVALID_VALUE);
+}
+
+TEST_F(LMS7002M_SnapshotTest, MissingFileIsReported)
+{
+    LMS7002M chip(nullptr);
+    EXPECT_EQ(chip.LoadSnapshot("does_not_exist.lms7snap"), OpStatus::FILE_NOT_FOUND);
+}
+
+TEST_F(LMS7002M_SnapshotTest, LoadsCountAsClockGeneratorConfigurations)
+{
+    const std::string configFilename = filename + ".ini";
+    LMS7002M source(nullptr);
+    source.EnableValuesCache(true);
+    ASSERT_EQ(source.SaveConfig(configFilename), OpStatus::SUCCESS);
+
+    LMS7002M chip(spi);
+    EXPECT_CALL(*spi, SPI(_, _, _)).Times(AnyNumber());
+    uint32_t count = chip.GetCGENConfigurationCount();
+
+    EXPECT_EQ(chip.LoadConfig(configFilename, false), OpStatus::SUCCESS);
+    EXPECT_GT(chip.GetCGENConfigurationCount(), count);
+    count = chip.GetCGENConfigurationCount();
+
+    EXPECT_EQ(chip.LoadSnapshot(filename), OpStatus::SUCCESS);
+    EXPECT_GT(chip.GetCGENConfigurationCount(), count);
+    std::remove(configFilename.c_str());
+}
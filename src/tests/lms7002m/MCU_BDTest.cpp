@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include "MCU_BD.h"
+#include "limesuite/IComms.h"
+
+using namespace lime;
+
+namespace lime::testing {
+
+/** @brief Minimal model of the LMS7002M MCU SPI registers used for programming and running procedures. */
+class MCU_SPIFake : public ISPI
+{
+  public:
+    MCU_SPIFake(uint32_t imageSize, uint8_t programID, bool dropBatchesOverFifoLength = false)
+        : imageSize(imageSize)
+        , programID(programID)
+        , dropBatchesOverFifoLength(dropBatchesOverFifoLength)
+    {
+    }
+
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        ++transactions;
+        uint32_t bytesWritten = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!(MOSI[i] & (1 << 31)))
+            {
+                ++reads;
+                MISO[i] = Read(MOSI[i] & 0x7FFF);
+                continue;
+            }
+
+            const uint16_t addr = (MOSI[i] >> 16) & 0x7FFF;
+            const uint16_t value = MOSI[i] & 0xFFFF;
+
+            ++writes;
+            if (addr == 0x0002)
+            {
+                if (value == 0)
+                {
+                    bytesReceived = 0;
+                    programmed = false;
+                    overflow = false;
+                }
+                control = value;
+            }
+            else if (addr == 0x0000)
+                procedure = value;
+            else if (addr == 0x0004)
+            {
+                ++bytesWritten;
+                if (dropBatchesOverFifoLength && bytesWritten > fifoLength)
+                    overflow = true;
+                if (++bytesReceived == imageSize && !overflow)
+                    programmed = true;
+            }
+        }
+        return OpStatus::SUCCESS;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+    void ResetCounters() { transactions = reads = writes = 0; }
+
+    static constexpr uint32_t fifoLength = 64;
+    const uint32_t imageSize;
+    const uint8_t programID;
+    const bool dropBatchesOverFifoLength;
+
+    uint32_t bytesReceived{ 0 };
+    bool programmed{ false };
+    bool overflow{ false };
+    uint16_t control{ 0 };
+    uint16_t procedure{ 0 };
+
+    int transactions{ 0 };
+    int reads{ 0 };
+    int writes{ 0 };
+
+  private:
+    uint32_t Read(uint16_t addr) const
+    {
+        switch (addr)
+        {
+        case 0x0001:
+            if (procedure == 255)
+                return programmed ? programID : 0;
+            return 0;
+        case 0x0002:
+            return control;
+        case 0x0003:
+            return 0x0001 | (programmed ? 0x0040 : 0);
+        default:
+            return 0;
+        }
+    }
+};
+
+} // namespace lime::testing
+
+using namespace lime::testing;
+
+static constexpr uint32_t imageSize = 16384;
+static constexpr uint8_t programID = MCU_ID_CALIBRATIONS_SINGLE_IMAGE;
+static uint8_t image[imageSize]{};
+
+TEST(MCU_BD, ProgramUploadIsBatched)
+{
+    auto spi = std::make_shared<MCU_SPIFake>(imageSize, programID);
+    MCU_BD mcu;
+    mcu.Initialize(spi, imageSize);
+
+    EXPECT_EQ(mcu.Program_MCU(image, MCU_BD::MCU_PROG_MODE::SRAM), 0);
+    EXPECT_TRUE(spi->programmed);
+    // reset + image batches + PROGRAMMED flag poll
+    EXPECT_LE(spi->transactions, 1 + static_cast<int>(imageSize / 1024) + 1);
+    EXPECT_EQ(spi->reads, 1);
+}
+
+TEST(MCU_BD, ProgramUploadFallsBackToFifoPolling)
+{
+    auto spi = std::make_shared<MCU_SPIFake>(imageSize, programID, true);
+    MCU_BD mcu;
+    mcu.Initialize(spi, imageSize);
+
+    EXPECT_EQ(mcu.Program_MCU(image, MCU_BD::MCU_PROG_MODE::SRAM), 0);
+    EXPECT_TRUE(spi->programmed);
+
+    // the fallback is remembered, next upload goes straight to FIFO polling
+    spi->ResetCounters();
+    EXPECT_EQ(mcu.Program_MCU(image, MCU_BD::MCU_PROG_MODE::SRAM), 0);
+    EXPECT_TRUE(spi->programmed);
+    EXPECT_GE(spi->reads, static_cast<int>(imageSize / MCU_SPIFake::fifoLength));
+}
+
+TEST(MCU_BD, EnsureProgramLoadedSkipsVerifiedProgram)
+{
+    auto spi = std::make_shared<MCU_SPIFake>(imageSize, programID);
+    MCU_BD mcu;
+    mcu.Initialize(spi, imageSize);
+
+    EXPECT_EQ(mcu.EnsureProgramLoaded(image, programID), 0);
+    EXPECT_TRUE(spi->programmed);
+
+    spi->ResetCounters();
+    EXPECT_EQ(mcu.EnsureProgramLoaded(image, programID), 0);
+    EXPECT_EQ(spi->transactions, 0);
+
+    // after invalidation the program ID is checked again, but the running image is not reuploaded
+    mcu.InvalidateLoadedProgram();
+    spi->ResetCounters();
+    EXPECT_EQ(mcu.EnsureProgramLoaded(image, programID), 0);
+    EXPECT_GT(spi->reads, 0);
+    EXPECT_LT(spi->writes, static_cast<int>(imageSize));
+}
+
+TEST(MCU_BD, InvalidatedProgramIsReuploaded)
+{
+    auto spi = std::make_shared<MCU_SPIFake>(imageSize, programID);
+    MCU_BD mcu;
+    mcu.Initialize(spi, imageSize);
+
+    EXPECT_EQ(mcu.EnsureProgramLoaded(image, programID), 0);
+    // a chip or board reset wipes the MCU and reports it
+    spi->programmed = false;
+    mcu.InvalidateLoadedProgram();
+
+    spi->ResetCounters();
+    EXPECT_EQ(mcu.EnsureProgramLoaded(image, programID), 0);
+    EXPECT_GE(spi->writes, static_cast<int>(imageSize));
+    EXPECT_TRUE(spi->programmed);
+}
+
+TEST(MCU_BD, ResetForgetsLoadedProgram)
+{
+    auto spi = std::make_shared<MCU_SPIFake>(imageSize, programID);
+    MCU_BD mcu;
+    mcu.Initialize(spi, imageSize);
+
+    EXPECT_EQ(mcu.EnsureProgramLoaded(image, programID), 0);
+    mcu.Reset_MCU();
+    spi->programmed = false;
+
+    spi->ResetCounters();
+    EXPECT_EQ(mcu.EnsureProgramLoaded(image, programID), 0);
+    EXPECT_GE(spi->writes, static_cast<int>(imageSize));
+    EXPECT_TRUE(spi->programmed);
+}
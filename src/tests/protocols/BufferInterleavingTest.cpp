@@ -216,3 +216,154 @@ TEST(BufferDeinterleaving, MIMO_I16_to_I16)
     EXPECT_EQ(outputA, expectedOutputA);
     EXPECT_EQ(outputB, expectedOutputB);
 }
+
+TEST(BufferInterleaving, FourChannels_I16_to_I16)
+{
+    std::array<uint16_t, 4> inputSamplesA = { { 0x010A, 0x020A, 0x030A, 0x040A } };
+    std::array<uint16_t, 4> inputSamplesB = { { 0x100B, 0x200B, 0x300B, 0x400B } };
+    std::array<uint16_t, 4> inputSamplesC = { { 0x010C, 0x020C, 0x030C, 0x040C } };
+    std::array<uint16_t, 4> inputSamplesD = { { 0x100D, 0x200D, 0x300D, 0x400D } };
+    const int complexSamplesCount = inputSamplesA.size() / 2;
+    std::array<uint8_t, 32> output;
+
+    DataConversion cfg;
+    cfg.destFormat = SDRDevice::StreamConfig::DataFormat::I16;
+    cfg.srcFormat = SDRDevice::StreamConfig::DataFormat::I16;
+    cfg.channelCount = 4;
+
+    void* src[4] = { inputSamplesA.data(), inputSamplesB.data(), inputSamplesC.data(), inputSamplesD.data() };
+    int bytesProduced = Interleave(output.data(), reinterpret_cast<void**>(&src), complexSamplesCount, cfg);
+
+    const std::array<uint8_t, 32> expectedOutput = { { 0x0A, 0x01, 0x0A, 0x02, 0x0B, 0x10, 0x0B, 0x20, 0x0C, 0x01, 0x0C,
+        0x02, 0x0D, 0x10, 0x0D, 0x20, 0x0A, 0x03, 0x0A, 0x04, 0x0B, 0x30, 0x0B, 0x40, 0x0C, 0x03, 0x0C, 0x04, 0x0D, 0x30,
+        0x0D, 0x40 } };
+    EXPECT_EQ(bytesProduced, expectedOutput.size());
+    EXPECT_EQ(output, expectedOutput);
+}
+
+TEST(BufferDeinterleaving, FourChannels_I16_to_I16)
+{
+    const std::array<uint8_t, 32> src = { { 0x0A, 0x01, 0x0A, 0x02, 0x0B, 0x10, 0x0B, 0x20, 0x0C, 0x01, 0x0C, 0x02, 0x0D,
+        0x10, 0x0D, 0x20, 0x0A, 0x03, 0x0A, 0x04, 0x0B, 0x30, 0x0B, 0x40, 0x0C, 0x03, 0x0C, 0x04, 0x0D, 0x30, 0x0D, 0x40 } };
+    const std::array<uint16_t, 4> expectedOutputA = { { 0x010A, 0x020A, 0x030A, 0x040A } };
+    const std::array<uint16_t, 4> expectedOutputB = { { 0x100B, 0x200B, 0x300B, 0x400B } };
+    const std::array<uint16_t, 4> expectedOutputC = { { 0x010C, 0x020C, 0x030C, 0x040C } };
+    const std::array<uint16_t, 4> expectedOutputD = { { 0x100D, 0x200D, 0x300D, 0x400D } };
+    std::array<uint16_t, 4> outputA;
+    std::array<uint16_t, 4> outputB;
+    std::array<uint16_t, 4> outputC;
+    std::array<uint16_t, 4> outputD;
+
+    DataConversion cfg;
+    cfg.destFormat = SDRDevice::StreamConfig::DataFormat::I16;
+    cfg.srcFormat = SDRDevice::StreamConfig::DataFormat::I16;
+    cfg.channelCount = 4;
+
+    void* dest[4] = { outputA.data(), outputB.data(), outputC.data(), outputD.data() };
+    int samplesProduced = Deinterleave(reinterpret_cast<void**>(&dest), src.data(), src.size(), cfg);
+
+    EXPECT_EQ(samplesProduced, expectedOutputA.size() / 2);
+    EXPECT_EQ(outputA, expectedOutputA);
+    EXPECT_EQ(outputB, expectedOutputB);
+    EXPECT_EQ(outputC, expectedOutputC);
+    EXPECT_EQ(outputD, expectedOutputD);
+}
+
+TEST(BufferInterleaving, AnyChannelCountRoundTrip_F32_I12)
+{
+    const uint32_t count = 300;
+    for (uint8_t channels = 1; channels <= TRXLooper::maxChannelCount; ++channels)
+    {
+        std::vector<std::vector<complex32f_t>> input(channels, std::vector<complex32f_t>(count));
+        std::vector<std::vector<complex32f_t>> output(channels, std::vector<complex32f_t>(count));
+        std::vector<void*> src(channels);
+        std::vector<void*> dest(channels);
+        for (uint8_t ch = 0; ch < channels; ++ch)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                input[ch][i] = complex32f_t((i % 64) / 64.0f, -static_cast<float>(ch) / channels);
+            src[ch] = input[ch].data();
+            dest[ch] = output[ch].data();
+        }
+
+        DataConversion toLink{ SDRDevice::StreamConfig::DataFormat::F32, SDRDevice::StreamConfig::DataFormat::I12, channels };
+        DataConversion toHost{ SDRDevice::StreamConfig::DataFormat::I12, SDRDevice::StreamConfig::DataFormat::F32, channels };
+        std::vector<uint8_t> buffer(count * channels * 3);
+        const int bytesProduced = Interleave(buffer.data(), src.data(), count, toLink);
+        ASSERT_EQ(bytesProduced, static_cast<int>(buffer.size()));
+        const int samplesProduced = Deinterleave(dest.data(), buffer.data(), bytesProduced, toHost);
+        ASSERT_EQ(samplesProduced, static_cast<int>(count));
+
+        for (uint8_t ch = 0; ch < channels; ++ch)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                ASSERT_NEAR(output[ch][i].real(), input[ch][i].real(), 2.0 / 2048) << int(channels) << ":" << int(ch);
+                ASSERT_NEAR(output[ch][i].imag(), input[ch][i].imag(), 2.0 / 2048) << int(channels) << ":" << int(ch);
+            }
+        }
+    }
+}
+
+TEST(BufferDeinterleaving, MIMO_I12_to_F32_MatchesPackedAccessors)
+{
+    // odd count, so the conversion goes through whole blocks and the remainder
+    const uint32_t count = 301;
+    std::vector<complex12packed_t> input(count * 2);
+    for (uint32_t i = 0; i < input.size(); ++i)
+    {
+        input[i].real(static_cast<int16_t>(i * 37 % 4096) - 2048);
+        input[i].imag(2047 - static_cast<int16_t>(i * 53 % 4096));
+    }
+
+    std::vector<complex32f_t> outputA(count);
+    std::vector<complex32f_t> outputB(count);
+    void* dest[2] = { outputA.data(), outputB.data() };
+    DataConversion conversion{ SDRDevice::StreamConfig::DataFormat::I12, SDRDevice::StreamConfig::DataFormat::F32, 2 };
+    const int samplesProduced = Deinterleave(dest, reinterpret_cast<uint8_t*>(input.data()), input.size() * 3, conversion);
+    ASSERT_EQ(samplesProduced, static_cast<int>(count));
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_FLOAT_EQ(outputA[i].real(), input[2 * i].real() / 2048.0f) << i;
+        ASSERT_FLOAT_EQ(outputA[i].imag(), input[2 * i].imag() / 2048.0f) << i;
+        ASSERT_FLOAT_EQ(outputB[i].real(), input[2 * i + 1].real() / 2048.0f) << i;
+        ASSERT_FLOAT_EQ(outputB[i].imag(), input[2 * i + 1].imag() / 2048.0f) << i;
+    }
+}
+
+TEST(BufferInterleaving, F32_to_I12_RoundsAndSaturates)
+{
+    const std::vector<complex32f_t> values{
+        { 0.4f / 2047, -0.4f / 2047 },
+        { 0.6f / 2047, -0.6f / 2047 },
+        { 1000.7f / 2047, -1000.7f / 2047 },
+        { 1.5f, -1.5f },
+        { 1.0f, -1.0f },
+    };
+    const std::vector<std::pair<int16_t, int16_t>> expected{
+        { 0, 0 }, { 1, -1 }, { 1001, -1001 }, { 2047, -2048 }, { 2047, -2047 }
+    };
+
+    for (uint8_t channels = 1; channels <= 3; ++channels)
+    {
+        // repeat the values past a whole block, for every channel
+        const uint32_t count = 70 * values.size();
+        std::vector<complex32f_t> input(count);
+        for (uint32_t i = 0; i < count; ++i)
+            input[i] = values[i % values.size()];
+        std::vector<void*> src(channels, input.data());
+
+        std::vector<complex12packed_t> output(count * channels);
+        DataConversion conversion{ SDRDevice::StreamConfig::DataFormat::F32, SDRDevice::StreamConfig::DataFormat::I12, channels };
+        const int bytesProduced = Interleave(reinterpret_cast<uint8_t*>(output.data()), src.data(), count, conversion);
+        ASSERT_EQ(bytesProduced, static_cast<int>(output.size() * 3));
+
+        for (uint32_t i = 0; i < output.size(); ++i)
+        {
+            const auto& sample = expected[i / channels % values.size()];
+            ASSERT_EQ(output[i].real(), sample.first) << int(channels) << ":" << i;
+            ASSERT_EQ(output[i].imag(), sample.second) << int(channels) << ":" << i;
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include "RxCorrector.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+/// @brief Generates circular noise as received through an imbalanced IQ mixer.
+class ImbalancedSource
+{
+  public:
+    ImbalancedSource(float gainQ, float phaseDegrees, float offsetI, float offsetQ)
+        : generator(1234)
+        , noise(0, 0.25)
+        , gainQ(gainQ)
+        , phase(phaseDegrees * M_PI / 180)
+        , offsetI(offsetI)
+        , offsetQ(offsetQ)
+    {
+    }
+
+    void Generate(complex32f_t* samples, uint32_t count, float scale = 1)
+    {
+        for (uint32_t n = 0; n < count; ++n)
+        {
+            const float i = noise(generator);
+            const float q = noise(generator);
+            samples[n].i = scale * (i + offsetI);
+            samples[n].q = scale * (gainQ * (q * std::cos(phase) + i * std::sin(phase)) + offsetQ);
+        }
+    }
+
+  private:
+    std::mt19937 generator;
+    std::normal_distribution<float> noise;
+    float gainQ;
+    float phase;
+    float offsetI;
+    float offsetQ;
+};
+
+struct Statistics {
+    double meanI = 0;
+    double meanQ = 0;
+    double varianceI = 0;
+    double varianceQ = 0;
+    double covariance = 0;
+};
+
+template<class T> Statistics Measure(const std::vector<T>& samples)
+{
+    Statistics s;
+    for (const T& sample : samples)
+    {
+        s.meanI += sample.i;
+        s.meanQ += sample.q;
+    }
+    s.meanI /= samples.size();
+    s.meanQ /= samples.size();
+    for (const T& sample : samples)
+    {
+        const double i = sample.i - s.meanI;
+        const double q = sample.q - s.meanQ;
+        s.varianceI += i * i;
+        s.varianceQ += q * q;
+        s.covariance += i * q;
+    }
+    s.varianceI /= samples.size();
+    s.varianceQ /= samples.size();
+    s.covariance /= samples.size();
+    return s;
+}
+
+RxCorrector::Config CorrectionConfig(bool dcOffset, bool iqImbalance)
+{
+    RxCorrector::Config config;
+    config.dcOffset = dcOffset;
+    config.iqImbalance = iqImbalance;
+    config.averagingLength = 16384;
+    return config;
+}
+
+} // namespace
+
+TEST(RxCorrector, RemovesDCOffsetAndIQImbalance)
+{
+    RxCorrector corrector(CorrectionConfig(true, true), 1);
+    ImbalancedSource source(1.2, 10, 0.05, -0.03);
+
+    const uint32_t blockSize = 1020;
+    std::vector<complex32f_t> block(blockSize);
+    std::vector<complex32f_t> corrected;
+    for (int b = 0; b < 400; ++b)
+    {
+        source.Generate(block.data(), blockSize);
+        complex32f_t* samples = block.data();
+        corrector.Process(&samples, blockSize);
+        // skip the convergence
+        if (b >= 200)
+            corrected.insert(corrected.end(), block.begin(), block.end());
+    }
+
+    const Statistics s = Measure(corrected);
+    EXPECT_NEAR(s.meanI, 0, 0.005);
+    EXPECT_NEAR(s.meanQ, 0, 0.005);
+    EXPECT_NEAR(s.varianceQ / s.varianceI, 1.0, 0.02);
+    EXPECT_NEAR(s.covariance / s.varianceI, 0, 0.02);
+}
+
+TEST(RxCorrector, DisabledCorrectionsAreNotApplied)
+{
+    RxCorrector corrector(CorrectionConfig(false, true), 1);
+    ImbalancedSource source(1.2, 10, 0.05, 0);
+
+    std::vector<complex32f_t> block(4096);
+    for (int b = 0; b < 50; ++b)
+    {
+        source.Generate(block.data(), block.size());
+        complex32f_t* samples = block.data();
+        corrector.Process(&samples, block.size());
+    }
+
+    const RxCorrector::Coefficients k = corrector.GetCoefficients(0);
+    EXPECT_EQ(k.offsetI, 0);
+    EXPECT_EQ(k.offsetQ, 0);
+    EXPECT_NEAR(k.qFromQ, 1 / (1.2 * std::cos(10 * M_PI / 180)), 0.02);
+
+    corrector.Reset();
+    EXPECT_EQ(corrector.GetCoefficients(0).qFromQ, 1);
+    EXPECT_EQ(corrector.GetCoefficients(0).qFromI, 0);
+}
+
+TEST(RxCorrector, IntegerSamplesAreCorrected)
+{
+    RxCorrector corrector(CorrectionConfig(true, true), 2);
+    ImbalancedSource sourceA(0.9, -5, 0.02, 0.04);
+    ImbalancedSource sourceB(1.1, 5, -0.04, 0.02);
+
+    const uint32_t blockSize = 1020;
+    std::vector<complex32f_t> floatBlock(blockSize);
+    std::vector<complex16_t> blocks[2] = { std::vector<complex16_t>(blockSize), std::vector<complex16_t>(blockSize) };
+    std::vector<complex16_t> corrected[2];
+    for (int b = 0; b < 400; ++b)
+    {
+        ImbalancedSource* sources[2] = { &sourceA, &sourceB };
+        for (int c = 0; c < 2; ++c)
+        {
+            sources[c]->Generate(floatBlock.data(), blockSize, 8000);
+            for (uint32_t n = 0; n < blockSize; ++n)
+                blocks[c][n] = complex16_t(std::lround(floatBlock[n].i), std::lround(floatBlock[n].q));
+        }
+        complex16_t* samples[2] = { blocks[0].data(), blocks[1].data() };
+        corrector.Process(samples, blockSize);
+        if (b >= 200)
+        {
+            for (int c = 0; c < 2; ++c)
+                corrected[c].insert(corrected[c].end(), blocks[c].begin(), blocks[c].end());
+        }
+    }
+
+    for (int c = 0; c < 2; ++c)
+    {
+        const Statistics s = Measure(corrected[c]);
+        EXPECT_NEAR(s.meanI, 0, 40);
+        EXPECT_NEAR(s.meanQ, 0, 40);
+        EXPECT_NEAR(s.varianceQ / s.varianceI, 1.0, 0.02);
+        EXPECT_NEAR(s.covariance / s.varianceI, 0, 0.02);
+    }
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include "RxDecimator.h"
+
+#include <cmath>
+#include <complex>
+#include <string>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+/// @brief Generates a complex tone with the frequency given as a fraction of the sample rate.
+std::vector<complex32f_t> GenerateTone(double frequency, uint32_t count, uint64_t startTimestamp = 0)
+{
+    std::vector<complex32f_t> samples(count);
+    for (uint32_t n = 0; n < count; ++n)
+    {
+        const double phase = 2 * M_PI * frequency * (startTimestamp + n);
+        samples[n] = complex32f_t(std::cos(phase), std::sin(phase));
+    }
+    return samples;
+}
+
+/// @brief Gets the mean magnitude of the samples after the filter has settled.
+float SettledMagnitude(const complex32f_t* samples, uint32_t count, uint32_t skip)
+{
+    double sum = 0;
+    for (uint32_t n = skip; n < count; ++n)
+        sum += std::hypot(samples[n].i, samples[n].q);
+    return sum / (count - skip);
+}
+
+RxDecimator::Config DecimationConfig(uint8_t ratio)
+{
+    RxDecimator::Config config;
+    config.ratio = ratio;
+    return config;
+}
+
+} // namespace
+
+TEST(RxDecimator, DesignedFilterHasUnityGain)
+{
+    const std::vector<float> taps = RxDecimator::DesignLowpass(4, 16, 0.8);
+    ASSERT_EQ(taps.size(), 64U);
+
+    double sum = 0;
+    for (float tap : taps)
+        sum += tap;
+    EXPECT_NEAR(sum, 1.0, 1e-5);
+}
+
+TEST(RxDecimator, KeepsPassbandAndRejectsAliases)
+{
+    const uint8_t ratio = 4;
+    const uint32_t count = 4096;
+    const uint32_t settle = 64;
+
+    RxDecimator passband(DecimationConfig(ratio), 1);
+    std::vector<complex32f_t> tone = GenerateTone(0.05, count);
+    complex32f_t* samples = tone.data();
+    uint32_t produced = passband.Process(&samples, count, 0, nullptr);
+    ASSERT_EQ(produced, count / ratio);
+    EXPECT_NEAR(SettledMagnitude(samples, produced, settle), 1.0, 0.05);
+
+    // would alias to -0.05 of the input rate
+    RxDecimator stopband(DecimationConfig(ratio), 1);
+    tone = GenerateTone(0.2, count);
+    samples = tone.data();
+    produced = stopband.Process(&samples, count, 0, nullptr);
+    EXPECT_LT(SettledMagnitude(samples, produced, settle), 0.03);
+}
+
+TEST(RxDecimator, BlocksAreContinuousAndAlignedToTimestamps)
+{
+    const uint8_t ratio = 4;
+    const uint32_t count = 1000;
+    const uint64_t startTimestamp = 1001;
+
+    RxDecimator whole(DecimationConfig(ratio), 1);
+    std::vector<complex32f_t> reference = GenerateTone(0.03, count, startTimestamp);
+    complex32f_t* samples = reference.data();
+    uint64_t timestamp = 0;
+    const uint32_t referenceCount = whole.Process(&samples, count, startTimestamp, &timestamp);
+    EXPECT_EQ(timestamp, (startTimestamp + ratio - 1) / ratio);
+
+    RxDecimator blocks(DecimationConfig(ratio), 1);
+    std::vector<complex32f_t> input = GenerateTone(0.03, count, startTimestamp);
+    std::vector<complex32f_t> output;
+    uint32_t offset = 0;
+    for (uint32_t blockSize : { 3, 250, 1, 121, 625 })
+    {
+        samples = input.data() + offset;
+        const uint32_t produced = blocks.Process(&samples, blockSize, startTimestamp + offset, &timestamp);
+        if (produced > 0)
+        {
+            EXPECT_EQ(timestamp, (startTimestamp + offset + ratio - 1) / ratio);
+        }
+        output.insert(output.end(), samples, samples + produced);
+        offset += blockSize;
+    }
+
+    ASSERT_EQ(output.size(), referenceCount);
+    for (uint32_t n = 0; n < referenceCount; ++n)
+    {
+        EXPECT_NEAR(output[n].i, reference[n].i, 1e-5);
+        EXPECT_NEAR(output[n].q, reference[n].q, 1e-5);
+    }
+}
+
+TEST(RxDecimator, ChannelizerDeliversSelectedSubChannels)
+{
+    RxDecimator::Config config = DecimationConfig(8);
+    config.channelize = true;
+    config.subChannels = { 3, 5 };
+
+    const uint32_t count = 8192;
+    RxDecimator channelizer(config, 1);
+    ASSERT_EQ(channelizer.GetOutputChannelCount(), 2);
+
+    // the tone is just above the center of sub-channel 3, sub-channel 5 is its negative frequency mirror
+    std::vector<complex32f_t> tone = GenerateTone(3.0 / 8 + 0.01, count);
+    std::vector<complex32f_t> second(count);
+    complex32f_t* samples[2] = { tone.data(), second.data() };
+    const uint32_t produced = channelizer.Process(samples, count, 0, nullptr);
+    ASSERT_EQ(produced, count / 8);
+
+    EXPECT_NEAR(SettledMagnitude(samples[0], produced, 32), 1.0, 0.05);
+    EXPECT_LT(SettledMagnitude(samples[1], produced, 32), 0.03);
+
+    // the sub-channel is moved to the baseband: 0.01 of the input rate is 0.08 of the output rate
+    const float phaseStep = std::arg(std::complex<float>(samples[0][101].i, samples[0][101].q) *
+                                     std::conj(std::complex<float>(samples[0][100].i, samples[0][100].q)));
+    EXPECT_NEAR(phaseStep, 2 * M_PI * 0.08, 1e-3);
+}
+
+TEST(RxDecimator, IntegerSamplesAreConverted)
+{
+    const uint8_t ratio = 2;
+    const uint32_t count = 512;
+
+    RxDecimator decimator(DecimationConfig(ratio), 1);
+    std::vector<complex16_t> input(count, complex16_t(1000, -1000));
+    complex16_t* samples = input.data();
+    const uint32_t produced = decimator.Process(&samples, count, 0, nullptr);
+    ASSERT_EQ(produced, count / ratio);
+    EXPECT_NEAR(samples[produced - 1].i, 1000, 1);
+    EXPECT_NEAR(samples[produced - 1].q, -1000, 1);
+}
+
+TEST(RxDecimator, InvalidConfigurationsAreRejected)
+{
+    RxDecimator::Config config = DecimationConfig(8);
+    EXPECT_EQ(RxDecimator::Validate(config, 2), OpStatus::SUCCESS);
+
+    config.channelize = true;
+    EXPECT_EQ(RxDecimator::Validate(config, 2), OpStatus::INVALID_VALUE);
+    config.subChannels = { 8 };
+    EXPECT_EQ(RxDecimator::Validate(config, 1), OpStatus::INVALID_VALUE);
+    config.subChannels = { 0, 1, 2 };
+    EXPECT_EQ(RxDecimator::Validate(config, 1), OpStatus::INVALID_VALUE);
+
+    config = DecimationConfig(64);
+    EXPECT_EQ(RxDecimator::Validate(config, 1), OpStatus::INVALID_VALUE);
+    config.bandwidth = 1;
+    config.tapsPerPhase = 8;
+    EXPECT_EQ(RxDecimator::Validate(config, 1), OpStatus::INVALID_VALUE);
+}
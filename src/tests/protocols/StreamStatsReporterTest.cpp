@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include "StreamStatsReporter.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lime;
+using namespace std::chrono;
+
+namespace {
+
+struct ReportedMessage {
+    SDRDevice::LogLevel level;
+    std::string text;
+    std::thread::id thread;
+};
+
+std::mutex reportedMutex;
+std::vector<ReportedMessage> reported;
+
+struct DeliveredStatus {
+    bool isTx;
+    uint32_t burstsCompleted;
+    std::thread::id thread;
+};
+
+std::vector<DeliveredStatus> delivered;
+
+bool RecordingStatusCallback(bool isTx, const SDRDevice::StreamStats* stats, void* userData)
+{
+    std::lock_guard<std::mutex> lock(reportedMutex);
+    delivered.push_back({ isTx, stats->burstsCompleted, std::this_thread::get_id() });
+    ++*static_cast<int*>(userData);
+    return true;
+}
+
+void RecordingCallback(SDRDevice::LogLevel level, const char* message)
+{
+    std::lock_guard<std::mutex> lock(reportedMutex);
+    reported.push_back({ level, message, std::this_thread::get_id() });
+}
+
+StreamStatsReporter::Snapshot MakeSnapshot(steady_clock::time_point time, int64_t bytes, uint32_t loss)
+{
+    StreamStatsReporter::Snapshot snapshot;
+    snapshot.time = time;
+    snapshot.bytesTransferred = bytes;
+    snapshot.packets = bytes / 4096;
+    snapshot.loss = loss;
+    return snapshot;
+}
+
+class StreamStatsReporterTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::lock_guard<std::mutex> lock(reportedMutex);
+        reported.clear();
+        delivered.clear();
+    }
+};
+
+} // namespace
+
+TEST_F(StreamStatsReporterTest, DataRateIsCalculatedFromSnapshots)
+{
+    StreamStatsReporter reporter;
+    reporter.SetName("/dev/test");
+    const steady_clock::time_point start = steady_clock::now();
+
+    reporter.Publish(TRXDir::Rx, MakeSnapshot(start, 1000000, 0));
+    reporter.ReportPending();
+    // the first snapshot is only the reference
+    EXPECT_EQ(reporter.GetDataRate(TRXDir::Rx), 0);
+
+    reporter.Publish(TRXDir::Rx, MakeSnapshot(start + milliseconds(500), 6000000, 0));
+    reporter.Publish(TRXDir::Tx, MakeSnapshot(start, 0, 0));
+    reporter.ReportPending();
+    EXPECT_FLOAT_EQ(reporter.GetDataRate(TRXDir::Rx), 10e6);
+    EXPECT_EQ(reporter.GetDataRate(TRXDir::Tx), 0);
+}
+
+TEST_F(StreamStatsReporterTest, OnlyLatestSnapshotIsReported)
+{
+    StreamStatsReporter reporter;
+    const steady_clock::time_point start = steady_clock::now();
+
+    reporter.Publish(TRXDir::Tx, MakeSnapshot(start, 0, 0));
+    reporter.ReportPending();
+    for (int i = 1; i <= 10; ++i)
+        reporter.Publish(TRXDir::Tx, MakeSnapshot(start + seconds(i), i * 2000000, 0));
+    reporter.ReportPending();
+    EXPECT_FLOAT_EQ(reporter.GetDataRate(TRXDir::Tx), 2e6);
+
+    // nothing new was published
+    reporter.ReportPending();
+    EXPECT_FLOAT_EQ(reporter.GetDataRate(TRXDir::Tx), 2e6);
+}
+
+TEST_F(StreamStatsReporterTest, MessagesAreFormattedOnReporterThread)
+{
+    StreamStatsReporter reporter;
+    reporter.SetName("/dev/test");
+    reporter.Start(&RecordingCallback, milliseconds(5));
+
+    const steady_clock::time_point start = steady_clock::now();
+    reporter.Publish(TRXDir::Rx, MakeSnapshot(start, 0, 0));
+    std::this_thread::sleep_for(milliseconds(50));
+    reporter.Publish(TRXDir::Rx, MakeSnapshot(start + seconds(1), 4000000, 0));
+    std::this_thread::sleep_for(milliseconds(50));
+    reporter.Publish(TRXDir::Rx, MakeSnapshot(start + seconds(2), 8000000, 3));
+    reporter.Stop();
+
+    std::lock_guard<std::mutex> lock(reportedMutex);
+    ASSERT_EQ(reported.size(), 2U);
+    EXPECT_EQ(reported[0].text.rfind("/dev/test Rx: 4.000 MB/s | TS:0 pkt:976 o:0(+0) l:0(+0)", 0), 0U);
+    EXPECT_EQ(reported[0].level, SDRDevice::LogLevel::DEBUG);
+    EXPECT_NE(reported[0].thread, std::this_thread::get_id());
+    EXPECT_NE(reported[1].text.find("l:3(+3)"), std::string::npos);
+    EXPECT_EQ(reported[1].level, SDRDevice::LogLevel::WARNING);
+    EXPECT_EQ(reporter.GetDataRate(TRXDir::Rx), 0);
+}
+
+TEST_F(StreamStatsReporterTest, StatusIsDeliveredOnReporterThread)
+{
+    int calls = 0;
+    StreamStatsReporter reporter;
+    reporter.SetStatusCallback(&RecordingStatusCallback, &calls);
+    reporter.Start(nullptr, milliseconds(5));
+
+    SDRDevice::StreamStats stats;
+    stats.burstsCompleted = 1;
+    reporter.PublishStatus(TRXDir::Tx, stats);
+    const auto deadline = steady_clock::now() + seconds(5);
+    while (steady_clock::now() < deadline)
+    {
+        {
+            std::lock_guard<std::mutex> lock(reportedMutex);
+            if (!delivered.empty())
+                break;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    stats.burstsCompleted = 2;
+    reporter.PublishStatus(TRXDir::Rx, stats);
+    reporter.Stop();
+
+    std::lock_guard<std::mutex> lock(reportedMutex);
+    ASSERT_EQ(delivered.size(), 2U);
+    EXPECT_TRUE(delivered[0].isTx);
+    EXPECT_EQ(delivered[0].burstsCompleted, 1U);
+    EXPECT_NE(delivered[0].thread, std::this_thread::get_id());
+    EXPECT_FALSE(delivered[1].isTx);
+    EXPECT_EQ(delivered[1].burstsCompleted, 2U);
+    EXPECT_EQ(calls, 2);
+}
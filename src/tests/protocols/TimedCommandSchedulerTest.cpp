@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include "TimedCommandScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace lime;
+using namespace std::chrono;
+
+namespace lime::testing {
+
+/** @brief A sample counter running at 1 MHz from the steady clock, standing in for the Rx timestamp. */
+class MockTimestampSource
+{
+  public:
+    static constexpr double sampleRate = 1e6;
+
+    MockTimestampSource()
+        : start(steady_clock::now())
+    {
+    }
+
+    uint64_t operator()() const { return duration_cast<microseconds>(steady_clock::now() - start).count(); }
+
+  private:
+    steady_clock::time_point start;
+};
+
+/** @brief A sample counter advancing by a fixed step on every read, independent of the OS scheduling delays. */
+class SteppedTimestampSource
+{
+  public:
+    static constexpr uint64_t step = 50;
+    // fast enough for the scheduler to poll at its minimum period
+    static constexpr double sampleRate = 1e9;
+
+    uint64_t operator()() { return mNow.fetch_add(step); }
+    void Advance(uint64_t samples) { mNow.fetch_add(samples); }
+
+  private:
+    std::atomic<uint64_t> mNow{ 0 };
+};
+
+/** @brief Collects the results of the completed commands. */
+struct ResultCollector {
+    static void Callback(const SDRDevice::TimedCommandResult& result, void* userData)
+    {
+        ResultCollector* collector = static_cast<ResultCollector*>(userData);
+        std::lock_guard<std::mutex> lock(collector->mutex);
+        collector->results.push_back(result);
+    }
+
+    bool WaitFor(std::size_t count, milliseconds timeout)
+    {
+        auto deadline = steady_clock::now() + timeout;
+        while (steady_clock::now() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (results.size() >= count)
+                    return true;
+            }
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        return false;
+    }
+
+    std::mutex mutex;
+    std::vector<SDRDevice::TimedCommandResult> results;
+};
+
+} // namespace lime::testing
+
+using namespace lime::testing;
+
+static SDRDevice::TimedCommand MakeCommand(uint64_t timestamp, ResultCollector& collector)
+{
+    SDRDevice::TimedCommand command;
+    command.timestamp = timestamp;
+    command.callback = ResultCollector::Callback;
+    command.userData = &collector;
+    return command;
+}
+
+TEST(TimedCommandScheduler, CommandsAreFiredAheadByMeasuredLatency)
+{
+    SteppedTimestampSource clock;
+    ResultCollector collector;
+    // every execution takes 500 samples, so it has to be started early to finish on time
+    const uint64_t executionTime = 500;
+    TimedCommandScheduler scheduler(
+        [&clock]() { return clock(); },
+        [&clock, executionTime](const SDRDevice::TimedCommand&) {
+            clock.Advance(executionTime);
+            return OpStatus::SUCCESS;
+        },
+        SteppedTimestampSource::sampleRate);
+
+    const int commandCount = 40;
+    const uint64_t first = clock() + 20000;
+    for (int i = 0; i < commandCount; ++i)
+        ASSERT_EQ(scheduler.Schedule(MakeCommand(first + i * 5000, collector)), OpStatus::SUCCESS);
+
+    ASSERT_TRUE(collector.WaitFor(commandCount, seconds(10)));
+    EXPECT_GE(scheduler.GetControlLatency(), executionTime);
+
+    // skip the commands executed while the latency was still being measured
+    for (int i = 20; i < commandCount; ++i)
+    {
+        const auto& result = collector.results[i];
+        EXPECT_EQ(result.status, OpStatus::SUCCESS);
+        const int64_t error = static_cast<int64_t>(result.executedTimestamp) - static_cast<int64_t>(result.targetTimestamp);
+        // a command is fired at most one clock step late, the averaged latency may undershoot by a few samples
+        EXPECT_LE(std::llabs(error), static_cast<int64_t>(2 * SteppedTimestampSource::step)) << "command " << i;
+    }
+}
+
+TEST(TimedCommandScheduler, HandlesHundredsOfCommandsInOrder)
+{
+    MockTimestampSource clock;
+    ResultCollector collector;
+    TimedCommandScheduler scheduler(
+        clock, [](const SDRDevice::TimedCommand&) { return OpStatus::SUCCESS; }, MockTimestampSource::sampleRate);
+
+    const int commandCount = 500;
+    const uint64_t first = clock() + 10000;
+    // submitted in reverse, the queue has to order them by timestamp
+    for (int i = commandCount - 1; i >= 0; --i)
+        ASSERT_EQ(scheduler.Schedule(MakeCommand(first + i * 1000, collector)), OpStatus::SUCCESS);
+
+    ASSERT_TRUE(collector.WaitFor(commandCount, seconds(10)));
+    EXPECT_EQ(scheduler.GetPendingCount(), 0U);
+    for (int i = 0; i < commandCount; ++i)
+    {
+        EXPECT_EQ(collector.results[i].targetTimestamp, first + i * 1000);
+        EXPECT_EQ(collector.results[i].status, OpStatus::SUCCESS);
+    }
+}
+
+TEST(TimedCommandScheduler, CancelledCommandsAreAborted)
+{
+    MockTimestampSource clock;
+    ResultCollector collector;
+    int executedCount = 0;
+    TimedCommandScheduler scheduler(
+        clock,
+        [&executedCount](const SDRDevice::TimedCommand&) {
+            ++executedCount;
+            return OpStatus::SUCCESS;
+        },
+        MockTimestampSource::sampleRate);
+
+    const uint64_t farFuture = clock() + 60000000;
+    for (int i = 0; i < 10; ++i)
+        ASSERT_EQ(scheduler.Schedule(MakeCommand(farFuture + i, collector)), OpStatus::SUCCESS);
+    EXPECT_EQ(scheduler.GetPendingCount(), 10U);
+
+    scheduler.CancelAll();
+
+    EXPECT_EQ(scheduler.GetPendingCount(), 0U);
+    EXPECT_EQ(executedCount, 0);
+    ASSERT_EQ(collector.results.size(), 10U);
+    for (const auto& result : collector.results)
+        EXPECT_EQ(result.status, OpStatus::ABORTED);
+}
@@ -215,7 +215,7 @@ bool FullStreamTxRx(SDRDevice& dev, bool MIMO)
     {
 
         //Receive samples
-        SDRDevice::StreamMeta rxMeta;
+        SDRDevice::StreamMeta rxMeta{};
         rxMeta.timestamp = 0;
         auto tt1 = std::chrono::high_resolution_clock::now();
         uint32_t samplesRead = dev.StreamRx(testStreamIndex, dest, samplesInPkt * txPacketCount, &rxMeta);
@@ -253,6 +253,7 @@ bool FullStreamTxRx(SDRDevice& dev, bool MIMO)
             txMeta.timestamp = rxNow + txDeltaTS;
             txMeta.waitForTimestamp = true;
             txMeta.flushPartialPacket = false; // not really matters because of continuous trasmitting
+            txMeta.endOfBurst = false;
 
             auto tt1 = std::chrono::high_resolution_clock::now();
             uint32_t samplesSent = dev.StreamTx(testStreamIndex, src, samplesInPkt * txPacketCount, &txMeta);
@@ -391,7 +392,7 @@ bool TxTiming(SDRDevice& dev, bool MIMO, float tsDelay_ms)
     //while(!done)
     {
         //Receive samples
-        SDRDevice::StreamMeta rxMeta;
+        SDRDevice::StreamMeta rxMeta{};
         uint32_t samplesRead = dev.StreamRx(chipIndex, dest, samplesInPkt * txPacketCount, &rxMeta);
         if (samplesRead < 0)
         {
@@ -411,6 +412,7 @@ bool TxTiming(SDRDevice& dev, bool MIMO, float tsDelay_ms)
             txMeta.timestamp = rxNow + txDeltaTS;
             txMeta.waitForTimestamp = true;
             txMeta.flushPartialPacket = true;
+            txMeta.endOfBurst = false;
             uint32_t samplesSent = dev.StreamTx(chipIndex, src, samplesInPkt, &txMeta);
             if (samplesSent <= 0)
             {
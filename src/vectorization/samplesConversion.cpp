@@ -36,4 +36,189 @@ void complex32f_to_complex16_zip(complex16_t* dest, const complex32f_t* srcA, co
     PathSelectionZip(dest, srcA, srcB, srcCount);
 }
 
+// The 12 bit kernels work on the raw bytes, so the compiler sees plain integer and float arithmetic it can vectorize,
+// instead of the per sample bit field accessors of complex12packed_t.
+// Each sample is 3 bytes: I[7:0], Q[3:0] I[11:8], Q[11:4]
+
+static inline void UnpackI12(const uint8_t* bytes, float* dest)
+{
+    constexpr float scale = GetScalingRatio<complex32f_t, complex12packed_t>();
+    const uint32_t b0 = bytes[0];
+    const uint32_t b1 = bytes[1];
+    const uint32_t b2 = bytes[2];
+    // place the 12 bit values at the top of the word, so the shift back extends the sign
+    dest[0] = (static_cast<int32_t>((b0 << 20) | (b1 << 28)) >> 20) * scale;
+    dest[1] = (static_cast<int32_t>((b1 << 16) | (b2 << 24)) >> 20) * scale;
+}
+
+static inline void PackI12(const float* src, uint8_t* bytes)
+{
+    const int32_t i = FloatToI12(src[0]);
+    const int32_t q = FloatToI12(src[1]);
+    bytes[0] = i;
+    bytes[1] = (q << 4) | ((i >> 8) & 0x0F);
+    bytes[2] = q >> 4;
+}
+
+// the samples are converted in blocks of fixed size, as only the fixed iteration count loops get vectorized
+static constexpr uint32_t blockSize = 64;
+
+template<uint32_t count> static void UnpackI12Block(const uint8_t* bytes, float* dest)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        UnpackI12(&bytes[3 * i], &dest[2 * i]);
+}
+
+// the frames are unpacked into a local block first, the unpacking into two channels doesn't vectorize when done in the same loop
+template<uint32_t count> static void UnpackI12BlockUnzip(const uint8_t* bytes, float* destA, float* destB)
+{
+    float values[4 * count];
+    UnpackI12Block<2 * count>(bytes, values);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        destA[2 * i] = values[4 * i];
+        destA[2 * i + 1] = values[4 * i + 1];
+        destB[2 * i] = values[4 * i + 2];
+        destB[2 * i + 1] = values[4 * i + 3];
+    }
+}
+
+template<uint32_t count> static void PackI12Values(const int32_t* values, uint8_t* bytes)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const int32_t real = values[2 * i];
+        const int32_t imag = values[2 * i + 1];
+        bytes[3 * i] = real;
+        bytes[3 * i + 1] = (imag << 4) | ((real >> 8) & 0x0F);
+        bytes[3 * i + 2] = imag >> 4;
+    }
+}
+
+template<uint32_t count> static void PackI12Block(const float* src, uint8_t* bytes)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        PackI12(&src[2 * i], &bytes[3 * i]);
+}
+
+// likewise the values are quantized first, before packing them
+template<uint32_t count> static void PackI12BlockZip(const float* srcA, const float* srcB, uint8_t* bytes)
+{
+    int32_t values[4 * count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        values[4 * i] = FloatToI12(srcA[2 * i]);
+        values[4 * i + 1] = FloatToI12(srcA[2 * i + 1]);
+        values[4 * i + 2] = FloatToI12(srcB[2 * i]);
+        values[4 * i + 3] = FloatToI12(srcB[2 * i + 1]);
+    }
+    PackI12Values<2 * count>(values, bytes);
+}
+
+template<uint8_t channelCount, uint32_t count>
+static void PackI12BlockChannels(const float* const* src, uint32_t offset, uint8_t* bytes)
+{
+    int32_t values[2 * channelCount * count];
+    for (uint8_t ch = 0; ch < channelCount; ++ch)
+    {
+        const float* input = &src[ch][2 * offset];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            values[2 * (i * channelCount + ch)] = FloatToI12(input[2 * i]);
+            values[2 * (i * channelCount + ch) + 1] = FloatToI12(input[2 * i + 1]);
+        }
+    }
+    PackI12Values<channelCount * count>(values, bytes);
+}
+
+void complex12packed_to_complex32f(complex32f_t* dest, const complex12packed_t* src, uint32_t srcCount)
+{
+    static_assert(sizeof(complex12packed_t) == 3 && sizeof(complex32f_t) == 2 * sizeof(float));
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+    float* output = reinterpret_cast<float*>(dest);
+    uint32_t i = 0;
+    for (; i + blockSize <= srcCount; i += blockSize)
+        UnpackI12Block<blockSize>(&bytes[3 * i], &output[2 * i]);
+    for (; i < srcCount; ++i)
+        UnpackI12Block<1>(&bytes[3 * i], &output[2 * i]);
+}
+
+void complex12packed_to_complex32f_unzip(complex32f_t* destA, complex32f_t* destB, const complex12packed_t* src, uint32_t srcCount)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+    float* outputA = reinterpret_cast<float*>(destA);
+    float* outputB = reinterpret_cast<float*>(destB);
+    const uint32_t frameCount = srcCount / 2;
+    uint32_t i = 0;
+    for (; i + blockSize <= frameCount; i += blockSize)
+        UnpackI12BlockUnzip<blockSize>(&bytes[6 * i], &outputA[2 * i], &outputB[2 * i]);
+    for (; i < frameCount; ++i)
+        UnpackI12BlockUnzip<1>(&bytes[6 * i], &outputA[2 * i], &outputB[2 * i]);
+}
+
+void complex32f_to_complex12packed(complex12packed_t* dest, const complex32f_t* src, uint32_t srcCount)
+{
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(dest);
+    const float* input = reinterpret_cast<const float*>(src);
+    uint32_t i = 0;
+    for (; i + blockSize <= srcCount; i += blockSize)
+        PackI12Block<blockSize>(&input[2 * i], &bytes[3 * i]);
+    for (; i < srcCount; ++i)
+        PackI12Block<1>(&input[2 * i], &bytes[3 * i]);
+}
+
+void complex32f_to_complex12packed_zip(
+    complex12packed_t* dest, const complex32f_t* srcA, const complex32f_t* srcB, uint32_t srcCount)
+{
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(dest);
+    const float* inputA = reinterpret_cast<const float*>(srcA);
+    const float* inputB = reinterpret_cast<const float*>(srcB);
+    uint32_t i = 0;
+    for (; i + blockSize <= srcCount; i += blockSize)
+        PackI12BlockZip<blockSize>(&inputA[2 * i], &inputB[2 * i], &bytes[6 * i]);
+    for (; i < srcCount; ++i)
+        PackI12BlockZip<1>(&inputA[2 * i], &inputB[2 * i], &bytes[6 * i]);
+}
+
+template<uint8_t channelCount>
+static void PackI12Channels(uint8_t* bytes, const float* const* src, uint32_t frameCount)
+{
+    // smaller blocks, to keep at most as many samples on the stack as with two channels
+    constexpr uint32_t count = blockSize / 4;
+    uint32_t i = 0;
+    for (; i + count <= frameCount; i += count)
+        PackI12BlockChannels<channelCount, count>(src, i, &bytes[3 * channelCount * i]);
+    for (; i < frameCount; ++i)
+        PackI12BlockChannels<channelCount, 1>(src, i, &bytes[3 * channelCount * i]);
+}
+
+void complex32f_to_complex12packed_channels(
+    complex12packed_t* dest, const complex32f_t* const* src, uint32_t srcCount, uint8_t channelCount)
+{
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(dest);
+    const float* const* input = reinterpret_cast<const float* const*>(src);
+    switch (channelCount)
+    {
+    case 3:
+        PackI12Channels<3>(bytes, input, srcCount);
+        break;
+    case 4:
+        PackI12Channels<4>(bytes, input, srcCount);
+        break;
+    case 5:
+        PackI12Channels<5>(bytes, input, srcCount);
+        break;
+    case 6:
+        PackI12Channels<6>(bytes, input, srcCount);
+        break;
+    case 7:
+        PackI12Channels<7>(bytes, input, srcCount);
+        break;
+    default:
+        assert(channelCount == 8);
+        PackI12Channels<8>(bytes, input, srcCount);
+        break;
+    }
+}
+
 } // namespace lime
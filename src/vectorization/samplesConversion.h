@@ -1,7 +1,9 @@
 #ifndef LIME_SAMPLES_CONVERSION_H
 #define LIME_SAMPLES_CONVERSION_H
 
+#include <assert.h>
 #include <stdint.h>
+#include <algorithm>
 #include "limesuite/complex.h"
 
 namespace lime {
@@ -79,6 +81,21 @@ template<> constexpr void Rescale(complex16_t& dest, const complex12packed_t& sr
     dest.imag(src.imag() << 4);
 }
 
+/// @brief Scales a float sample to the 12 bit range, rounding to the nearest value and saturating at the range limits.
+constexpr int32_t FloatToI12(float value)
+{
+    float scaled = value * GetScalingRatio<complex12packed_t, complex32f_t>();
+    scaled = scaled < -2048.0f ? -2048.0f : scaled;
+    scaled = scaled > 2047.0f ? 2047.0f : scaled;
+    return static_cast<int32_t>(scaled + (scaled < 0 ? -0.5f : 0.5f));
+}
+
+template<> constexpr void Rescale(complex12packed_t& dest, const complex32f_t& src)
+{
+    dest.real(FloatToI12(src.real()));
+    dest.imag(FloatToI12(src.imag()));
+}
+
 // compile time known iteration/element count
 template<uint32_t srcCount, class DestT, class SrcT> static void fastPath_convert(DestT* dest, const SrcT* src)
 {
@@ -201,6 +218,109 @@ template<class DestT, class SrcT> static void PathSelectionZip(DestT* dest, SrcT
     }
 }
 
+// compile time known channel count, each channel is gathered with a fixed stride
+template<uint8_t channelCount, class DestT, class SrcT>
+static void convert_unzip_channels(DestT* const* dest, const SrcT* src, uint32_t srcCount)
+{
+    const uint32_t frameCount = srcCount / channelCount;
+    for (uint8_t ch = 0; ch < channelCount; ++ch)
+    {
+        DestT* destCh = dest[ch];
+        for (uint32_t i = 0; i < frameCount; ++i)
+            Rescale(destCh[i], src[i * channelCount + ch]);
+    }
+}
+
+template<class DestT, class SrcT>
+static void PathSelectionUnzipChannels(DestT* const* dest, const SrcT* src, uint32_t srcCount, uint8_t channelCount)
+{
+    switch (channelCount)
+    {
+    case 0:
+    case 1:
+        PathSelection(dest[0], src, srcCount);
+        break;
+    case 2:
+        PathSelectionUnzip(dest[0], dest[1], src, srcCount);
+        break;
+    case 3:
+        convert_unzip_channels<3>(dest, src, srcCount);
+        break;
+    case 4:
+        convert_unzip_channels<4>(dest, src, srcCount);
+        break;
+    case 5:
+        convert_unzip_channels<5>(dest, src, srcCount);
+        break;
+    case 6:
+        convert_unzip_channels<6>(dest, src, srcCount);
+        break;
+    case 7:
+        convert_unzip_channels<7>(dest, src, srcCount);
+        break;
+    default:
+        assert(channelCount == 8);
+        convert_unzip_channels<8>(dest, src, srcCount);
+        break;
+    }
+}
+
+template<uint8_t channelCount, class DestT, class SrcT>
+static void convert_zip_channels(DestT* dest, const SrcT* const* src, uint32_t srcCount)
+{
+    for (uint8_t ch = 0; ch < channelCount; ++ch)
+    {
+        const SrcT* srcCh = src[ch];
+        for (uint32_t i = 0; i < srcCount; ++i)
+            Rescale(dest[i * channelCount + ch], srcCh[i]);
+    }
+}
+
+template<class DestT, class SrcT>
+static void PathSelectionZipChannels(DestT* dest, const SrcT* const* src, uint32_t srcCount, uint8_t channelCount)
+{
+    switch (channelCount)
+    {
+    case 0:
+    case 1:
+        PathSelection(dest, src[0], srcCount);
+        break;
+    case 2:
+        PathSelectionZip(dest, src[0], src[1], srcCount);
+        break;
+    case 3:
+        convert_zip_channels<3>(dest, src, srcCount);
+        break;
+    case 4:
+        convert_zip_channels<4>(dest, src, srcCount);
+        break;
+    case 5:
+        convert_zip_channels<5>(dest, src, srcCount);
+        break;
+    case 6:
+        convert_zip_channels<6>(dest, src, srcCount);
+        break;
+    case 7:
+        convert_zip_channels<7>(dest, src, srcCount);
+        break;
+    default:
+        assert(channelCount == 8);
+        convert_zip_channels<8>(dest, src, srcCount);
+        break;
+    }
+}
+
+// Fused 12 bit packed <-> float conversions, the samples are unpacked and scaled without an integer intermediate buffer
+void complex12packed_to_complex32f(complex32f_t* dest, const complex12packed_t* src, uint32_t srcCount);
+void complex12packed_to_complex32f_unzip(
+    complex32f_t* destA, complex32f_t* destB, const complex12packed_t* src, uint32_t srcCount);
+void complex32f_to_complex12packed(complex12packed_t* dest, const complex32f_t* src, uint32_t srcCount);
+void complex32f_to_complex12packed_zip(
+    complex12packed_t* dest, const complex32f_t* srcA, const complex32f_t* srcB, uint32_t srcCount);
+// the 3 to 8 channel variant, the generic path would round the samples through the bit field accessors one at a time
+void complex32f_to_complex12packed_channels(
+    complex12packed_t* dest, const complex32f_t* const* src, uint32_t srcCount, uint8_t channelCount);
+
 } // namespace lime
 
 #endif